@@ -9,6 +9,7 @@ COMPONENT_SRCDIRS := $(CRYPTOAUTHLIB_DIR)/atcacert \
                      $(CRYPTOAUTHLIB_DIR)/crypto/hashes \
                      $(CRYPTOAUTHLIB_DIR)/host \
                      $(CRYPTOAUTHLIB_DIR)/mbedtls \
+                     $(CRYPTOAUTHLIB_DIR)/pkcs11 \
                      $(CRYPTOAUTHLIB_DIR)/../app/tng \
                      $(CRYPTOAUTHLIB_DIR) \
                      port
@@ -17,7 +18,7 @@ COMPONENT_OBJS := $(foreach compsrcdir,$(COMPONENT_SRCDIRS),$(patsubst %.c,%.o,$
                   $(CRYPTOAUTHLIB_DIR)/hal/atca_hal.o \
                   $(CRYPTOAUTHLIB_DIR)/hal/hal_freertos.o \
                   $(CRYPTOAUTHLIB_DIR)/../third_party/hal/esp32/hal_esp32_timer.o \
-                  $(CRYPTOAUTHLIB_DIR)/../third_party/hal/esp32/hal_esp32_i2c.o
+                  $(CRYPTOAUTHLIB_DIR)/../app/pkcs11/trust_pkcs11_config.o
 
 # Make relative by removing COMPONENT_PATH from all found object paths
 COMPONENT_OBJS := $(patsubst $(COMPONENT_PATH)/%,%,$(COMPONENT_OBJS))
@@ -27,7 +28,8 @@ COMPONENT_OBJEXCLUDE := $(CRYPTOAUTHLIB_DIR)/atca_cfgs.o
 
 # Add the hal directory back in for source search paths
 COMPONENT_SRCDIRS += $(CRYPTOAUTHLIB_DIR)/hal \
-                     $(CRYPTOAUTHLIB_DIR)/../third_party/hal/esp32
+                     $(CRYPTOAUTHLIB_DIR)/../third_party/hal/esp32 \
+                     $(CRYPTOAUTHLIB_DIR)/../app/pkcs11
 
 COMPONENT_ADD_INCLUDEDIRS := $(CRYPTOAUTHLIB_DIR) $(CRYPTOAUTHLIB_DIR)/hal $(CRYPTOAUTHLIB_DIR)/../app/tng port
 
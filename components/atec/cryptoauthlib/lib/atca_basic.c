@@ -28,6 +28,9 @@
 
 #include "atca_basic.h"
 #include "atca_version.h"
+#if ATCACERT_CACHE_EN
+#include "atcacert/atcacert_client.h"
+#endif
 
 #if defined(ATCA_USE_CONSTANT_HOST_NONCE)
 #if defined(_MSC_VER)
@@ -44,6 +47,8 @@ SHARED_LIB_EXPORT struct atca_iface g_atcab_iface;
 SHARED_LIB_EXPORT struct atca_device g_atcab_device;
 #endif
 
+static atca_verify_policy_t g_atcab_verify_policy = ATCA_VERIFY_POLICY_DEFAULT;
+
 /** \brief basic API methods are all prefixed with atcab_  (CryptoAuthLib Basic)
  *  the fundamental premise of the basic API is it is based on a single interface
  *  instance and that instance is global, so all basic API commands assume that
@@ -171,6 +176,10 @@ ATCA_STATUS atcab_init_device(ATCADevice ca_device)
  */
 ATCA_STATUS atcab_release_ext(ATCADevice* device)
 {
+#if ATCACERT_CACHE_EN
+    /* A later device may reuse the address: check cached certificates again */
+    atcacert_cache_new_session();
+#endif
 #ifdef ATCA_NO_HEAP
     ATCA_STATUS status = releaseATCADevice(*device);
     if (status != ATCA_SUCCESS)
@@ -277,6 +286,31 @@ bool atcab_is_ta_device(ATCADeviceType dev_type)
     return ((dev_type & 0xF0U) == 0x10U) ? true : false;
 }
 
+/** \brief Select where signatures made with a supplied public key are
+ *          verified (atcab_verify_extern and the mbedTLS verify bridge).
+ *          Without host verify support the device is always used.
+ *
+ * \param[in] policy  One of ATCA_VERIFY_POLICY_DEVICE, ATCA_VERIFY_POLICY_HOST
+ *                    or ATCA_VERIFY_POLICY_AUTO
+ */
+void atcab_set_verify_policy(atca_verify_policy_t policy)
+{
+#if ATCAB_VERIFY_EXTERN_HOST_EN
+    g_atcab_verify_policy = policy;
+#else
+    (void)policy;
+#endif
+}
+
+/** \brief Get the verify policy currently in effect
+ *
+ * \return Current verify policy
+ */
+atca_verify_policy_t atcab_get_verify_policy(void)
+{
+    return g_atcab_verify_policy;
+}
+
 #ifdef ATCA_USE_ATCAB_FUNCTIONS
 
 /** \brief wakeup the CryptoAuth device
@@ -3957,6 +3991,9 @@ ATCA_STATUS atcab_verify(uint8_t mode, uint16_t key_id, const uint8_t* signature
  * \param[out] is_verified  Boolean whether or not the message, signature,
  *                          public key verified.
  *
+ * Depending on atcab_set_verify_policy the verification may be done on the
+ * host without a device transaction.
+ *
  * \return ATCA_SUCCESS on verification success or failure, because the
  *         command still completed successfully.
  */
@@ -3965,6 +4002,25 @@ ATCA_STATUS atcab_verify_extern_ext(ATCADevice device, const uint8_t* message, c
     ATCA_STATUS status = ATCA_UNIMPLEMENTED;
     ATCADeviceType dev_type = atcab_get_device_type_ext(device);
 
+#if ATCAB_VERIFY_EXTERN_HOST_EN
+    if (ATCA_VERIFY_POLICY_DEVICE != g_atcab_verify_policy)
+    {
+        /* Public key verification needs no secret - keep it off the bus */
+        status = atcac_sw_ecdsa_verify_p256(message, signature, public_key, is_verified);
+
+        if ((ATCA_SUCCESS != status) && (ATCA_BAD_PARAM != status) && (ATCA_VERIFY_POLICY_AUTO == g_atcab_verify_policy))
+        {
+            /* Host couldn't do it (e.g. out of memory) so let the device try */
+            status = ATCA_UNIMPLEMENTED;
+        }
+    }
+
+    if (ATCA_UNIMPLEMENTED != status)
+    {
+        /* Already handled by the host */
+    }
+    else
+#endif
     if (atcab_is_ca_device(dev_type))
     {
 #if ATCA_ECC_SUPPORT
@@ -63,6 +63,17 @@ bool atcab_is_ca_device(ATCADeviceType dev_type);
 bool atcab_is_ca2_device(ATCADeviceType dev_type);
 bool atcab_is_ta_device(ATCADeviceType dev_type);
 
+/** \brief Where signatures made with a supplied public key are verified */
+typedef enum
+{
+    ATCA_VERIFY_POLICY_DEVICE = 0,  /**< Always use the device Verify command */
+    ATCA_VERIFY_POLICY_HOST,        /**< Always verify on the host, never touch the device */
+    ATCA_VERIFY_POLICY_AUTO         /**< Verify on the host, fall back to the device if the host can't */
+} atca_verify_policy_t;
+
+void atcab_set_verify_policy(atca_verify_policy_t policy);
+atca_verify_policy_t atcab_get_verify_policy(void);
+
 #define atcab_get_addr(...)                     calib_get_addr(__VA_ARGS__)
 #define atca_execute_command(...)               calib_execute_command(__VA_ARGS__)
 
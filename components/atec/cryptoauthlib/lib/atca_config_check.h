@@ -790,4 +790,36 @@
 #define ATCAC_SIGN_EN                       ATCA_HOSTLIB_EN
 #endif
 
+/** \def ATCAB_VERIFY_EXTERN_HOST_EN
+ *
+ * Requires: ATCAB_VERIFY_EXTERN, ATCAC_VERIFY_EN, ATCA_MBEDTLS
+ *
+ * Allow atcab_verify_extern_ext (and the mbedTLS ECDSA verify bridge) to
+ * verify signatures made with a supplied public key on the host instead of
+ * the device. Verification with a public key needs no secret so it does not
+ * have to occupy the device bus. See atcab_set_verify_policy.
+ */
+#ifndef ATCAB_VERIFY_EXTERN_HOST_EN
+#if defined(ATCA_MBEDTLS) && ATCAC_VERIFY_EN && ATCAB_VERIFY_EXTERN_EN
+#define ATCAB_VERIFY_EXTERN_HOST_EN         DEFAULT_ENABLED
+#else
+#define ATCAB_VERIFY_EXTERN_HOST_EN         DEFAULT_DISABLED
+#endif
+#endif
+
+/** \def ATCA_VERIFY_POLICY_DEFAULT
+ *
+ * Requires: ATCAB_VERIFY_EXTERN_HOST_EN
+ *
+ * Verify policy in effect at startup - one of ATCA_VERIFY_POLICY_DEVICE,
+ * ATCA_VERIFY_POLICY_HOST or ATCA_VERIFY_POLICY_AUTO.
+ */
+#ifndef ATCA_VERIFY_POLICY_DEFAULT
+#if ATCAB_VERIFY_EXTERN_HOST_EN
+#define ATCA_VERIFY_POLICY_DEFAULT          ATCA_VERIFY_POLICY_AUTO
+#else
+#define ATCA_VERIFY_POLICY_DEFAULT          ATCA_VERIFY_POLICY_DEVICE
+#endif
+#endif
+
 #endif /* ATCA_CONFIG_CHECK_H */
@@ -50,6 +50,38 @@
 #define ATCACERT_EN                         (ATCACERT_FULLSTOREDCERT_EN || ATCACERT_COMPCERT_EN)
 #endif
 
+/** \def ATCACERT_CACHE_EN
+ *
+ * Keep certificates rebuilt by atcacert_read_cert in RAM. The first read of
+ * a cached certificate in a session (see atcacert_cache_new_session) checks
+ * the device serial number, compressed certificate and subject public key
+ * are unchanged; later reads make no device reads at all.
+ */
+#ifndef ATCACERT_CACHE_EN
+#define ATCACERT_CACHE_EN                   DEFAULT_DISABLED
+#endif
+
+#if ATCACERT_CACHE_EN && !(ATCACERT_COMPCERT_EN && ATCAC_SHA256_EN)
+#error "ATCACERT_CACHE_EN requires ATCACERT_COMPCERT_EN and ATCAC_SHA256_EN"
+#endif
+
+/** \def ATCACERT_CACHE_ENTRIES
+ *
+ * Number of certificates held by the certificate cache
+ */
+#ifndef ATCACERT_CACHE_ENTRIES
+#define ATCACERT_CACHE_ENTRIES              (2u)
+#endif
+
+/** \def ATCACERT_CACHE_CERT_MAX_SIZE
+ *
+ * Largest certificate (in bytes) the certificate cache will hold. Larger
+ * certificates are always rebuilt from the device.
+ */
+#ifndef ATCACERT_CACHE_CERT_MAX_SIZE
+#define ATCACERT_CACHE_CERT_MAX_SIZE        (768u)
+#endif
+
 #ifndef ATCACERT_HW_CHALLENGE_EN
 #define ATCACERT_HW_CHALLENGE_EN            (ATCAB_RANDOM_EN && (ATCA_ECC_SUPPORT || ATCA_TA_SUPPORT))
 #endif
@@ -210,6 +210,223 @@ ATCA_STATUS atcacert_read_device_loc(const atcacert_device_loc_t*   device_loc,
 }
 #endif
 
+#if ATCACERT_CACHE_EN
+typedef struct atcacert_cache_entry_s
+{
+    ATCADevice            device;
+    const atcacert_def_t* cert_def;
+    uint8_t               key[ATCA_SHA2_256_DIGEST_SIZE];
+    uint8_t               ca_key[ATCA_SHA2_256_DIGEST_SIZE];
+    bool                  checked;
+    size_t                cert_size;
+    uint8_t               cert[ATCACERT_CACHE_CERT_MAX_SIZE];
+} atcacert_cache_entry_t;
+
+static atcacert_cache_entry_t atcacert_cache[ATCACERT_CACHE_ENTRIES];
+static size_t atcacert_cache_next;
+
+/* Device locations read for the cache key: the compressed certificate, the
+   subject public key and the serial number */
+#define ATCACERT_CACHE_KEY_LOCS     (3u)
+
+static uint8_t atcacert_cache_key_data[ATCACERT_CACHE_KEY_LOCS][ATCA_MAX_DATA_SIZE];
+
+static bool atcacert_cache_loc_contains(const atcacert_device_loc_t* outer, const atcacert_device_loc_t* inner)
+{
+    if ((DEVZONE_NONE == inner->zone) || (0u == inner->count))
+    {
+        return false;
+    }
+    if ((outer->zone != inner->zone) || (outer->is_genkey != inner->is_genkey) ||
+        ((DEVZONE_DATA == outer->zone) && (outer->slot != inner->slot)))
+    {
+        return false;
+    }
+    return ((inner->offset >= outer->offset) &&
+            (((size_t)inner->offset + inner->count) <= ((size_t)outer->offset + outer->count))) ? true : false;
+}
+
+static bool atcacert_cache_loc_has_sn(const atcacert_device_loc_t* device_loc)
+{
+    /* Config zone bytes 0-12 or the TA dedicated data */
+    return ((DEVZONE_DEDICATED_DATA == device_loc->zone) ||
+            ((DEVZONE_CONFIG == device_loc->zone) && (0u == device_loc->offset) && (13u <= device_loc->count))) ? true : false;
+}
+
+/* Everything that goes into the rebuilt certificate that isn't in the template
+   is either in the compressed certificate, the subject public key, tied to the
+   device serial number or the supplied CA key - so a digest over those
+   identifies the result. The locations read for it are listed in key_locs and
+   their data is left in atcacert_cache_key_data so a rebuild doesn't read them
+   again */
+static ATCA_STATUS atcacert_cache_key(ATCADevice                   device,
+                                      const atcacert_def_t*        cert_def,
+                                      const cal_buffer*            ca_public_key,
+                                      const atcacert_device_loc_t* device_locs,
+                                      size_t                       device_locs_count,
+                                      size_t                       key_locs[ATCACERT_CACHE_KEY_LOCS],
+                                      size_t*                      key_locs_count,
+                                      uint8_t                      key[ATCA_SHA2_256_DIGEST_SIZE])
+{
+    ATCA_STATUS ret;
+    uint8_t key_data[ATCA_SERIAL_NUM_SIZE + ATCA_SHA2_256_DIGEST_SIZE * (ATCACERT_CACHE_KEY_LOCS + 1u)];
+    bool has_sn = false;
+    size_t i;
+
+    (void)memset(key_data, 0, sizeof(key_data));
+    *key_locs_count = 0;
+
+    for (i = 0; i < device_locs_count; i++)
+    {
+        const atcacert_device_loc_t* device_loc = &device_locs[i];
+        bool is_sn = atcacert_cache_loc_has_sn(device_loc);
+
+        if (!is_sn && !atcacert_cache_loc_contains(device_loc, &cert_def->comp_cert_dev_loc) &&
+            !atcacert_cache_loc_contains(device_loc, &cert_def->public_key_dev_loc))
+        {
+            continue;
+        }
+        if ((*key_locs_count >= ATCACERT_CACHE_KEY_LOCS) || (device_loc->count > ATCA_MAX_DATA_SIZE))
+        {
+            return ATCACERT_E_BUFFER_TOO_SMALL;
+        }
+
+        if (ATCACERT_E_SUCCESS != (ret = atcacert_read_device_loc_ext(device, device_loc, atcacert_cache_key_data[*key_locs_count])))
+        {
+            return ret;
+        }
+        if (ATCA_SUCCESS != (ret = atcac_sw_sha2_256(atcacert_cache_key_data[*key_locs_count], device_loc->count,
+                                                     &key_data[ATCA_SERIAL_NUM_SIZE + ATCA_SHA2_256_DIGEST_SIZE * *key_locs_count])))
+        {
+            return ret;
+        }
+        has_sn = has_sn || is_sn;
+        key_locs[(*key_locs_count)++] = i;
+    }
+
+    /* The certificate doesn't use the serial number but the entry must still
+       not survive a device swap */
+    if (!has_sn)
+    {
+        if (ATCA_SUCCESS != (ret = atcab_read_serial_number_ext(device, key_data)))
+        {
+            return ret;
+        }
+    }
+
+    if ((NULL != ca_public_key) && (NULL != ca_public_key->buf))
+    {
+        if (ATCA_SUCCESS != (ret = atcac_sw_sha2_256(ca_public_key->buf, ca_public_key->len,
+                                                     &key_data[ATCA_SERIAL_NUM_SIZE + ATCA_SHA2_256_DIGEST_SIZE * ATCACERT_CACHE_KEY_LOCS])))
+        {
+            return ret;
+        }
+    }
+
+    return atcac_sw_sha2_256(key_data, sizeof(key_data), key);
+}
+
+static atcacert_cache_entry_t* atcacert_cache_find(ATCADevice device, const atcacert_def_t* cert_def)
+{
+    size_t i;
+
+    for (i = 0; i < ATCACERT_CACHE_ENTRIES; i++)
+    {
+        if ((0u != atcacert_cache[i].cert_size) && (device == atcacert_cache[i].device) &&
+            (cert_def == atcacert_cache[i].cert_def))
+        {
+            return &atcacert_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/* Digest of the CA public key, all zeros without one. Only host work, so a
+   checked entry can be matched against it without touching the device */
+static ATCA_STATUS atcacert_cache_ca_key(const cal_buffer* ca_public_key, uint8_t ca_key[ATCA_SHA2_256_DIGEST_SIZE])
+{
+    if ((NULL == ca_public_key) || (NULL == ca_public_key->buf))
+    {
+        (void)memset(ca_key, 0, ATCA_SHA2_256_DIGEST_SIZE);
+        return ATCA_SUCCESS;
+    }
+    return atcac_sw_sha2_256(ca_public_key->buf, ca_public_key->len, ca_key);
+}
+
+static ATCA_STATUS atcacert_cache_copy(const atcacert_cache_entry_t* entry, uint8_t* cert, size_t* cert_size)
+{
+    if (*cert_size < entry->cert_size)
+    {
+        *cert_size = entry->cert_size;
+        return ATCACERT_E_BUFFER_TOO_SMALL;
+    }
+    (void)memcpy(cert, entry->cert, entry->cert_size);
+    *cert_size = entry->cert_size;
+    return ATCACERT_E_SUCCESS;
+}
+
+static void atcacert_cache_store(ATCADevice               device,
+                                 const atcacert_def_t*    cert_def,
+                                 const uint8_t            key[ATCA_SHA2_256_DIGEST_SIZE],
+                                 const uint8_t            ca_key[ATCA_SHA2_256_DIGEST_SIZE],
+                                 const uint8_t*           cert,
+                                 size_t                   cert_size)
+{
+    atcacert_cache_entry_t* entry = atcacert_cache_find(device, cert_def);
+
+    if (cert_size > ATCACERT_CACHE_CERT_MAX_SIZE)
+    {
+        if (NULL != entry)
+        {
+            entry->cert_size = 0;
+        }
+        return;
+    }
+
+    if (NULL == entry)
+    {
+        entry = &atcacert_cache[atcacert_cache_next];
+        atcacert_cache_next = (atcacert_cache_next + 1u) % ATCACERT_CACHE_ENTRIES;
+    }
+
+    entry->device = device;
+    entry->cert_def = cert_def;
+    (void)memcpy(entry->key, key, ATCA_SHA2_256_DIGEST_SIZE);
+    (void)memcpy(entry->ca_key, ca_key, ATCA_SHA2_256_DIGEST_SIZE);
+    entry->checked = true;
+    (void)memcpy(entry->cert, cert, cert_size);
+    entry->cert_size = cert_size;
+}
+
+static void atcacert_cache_invalidate(const atcacert_def_t* cert_def)
+{
+    size_t i;
+
+    for (i = 0; i < ATCACERT_CACHE_ENTRIES; i++)
+    {
+        if ((NULL == cert_def) || (cert_def == atcacert_cache[i].cert_def))
+        {
+            atcacert_cache[i].cert_size = 0;
+        }
+    }
+}
+
+void atcacert_cache_clear(void)
+{
+    atcacert_cache_invalidate(NULL);
+}
+
+void atcacert_cache_new_session(void)
+{
+    size_t i;
+
+    for (i = 0; i < ATCACERT_CACHE_ENTRIES; i++)
+    {
+        atcacert_cache[i].checked = false;
+    }
+}
+#endif /* ATCACERT_CACHE_EN */
+
 ATCA_STATUS atcacert_read_cert_ext(ATCADevice               device,
                                    const atcacert_def_t*    cert_def,
                                    const cal_buffer*        ca_public_key,
@@ -224,6 +441,15 @@ ATCA_STATUS atcacert_read_cert_ext(ATCADevice               device,
     size_t i = 0;
     atcacert_build_state_t build_state;
 #endif
+#if ATCACERT_CACHE_EN
+    uint8_t cache_key[ATCA_SHA2_256_DIGEST_SIZE];
+    uint8_t cache_ca_key[ATCA_SHA2_256_DIGEST_SIZE];
+    atcacert_cache_entry_t* entry = NULL;
+    bool cache_key_valid = false;
+    size_t cache_key_locs[ATCACERT_CACHE_KEY_LOCS];
+    size_t cache_key_locs_count = 0;
+    size_t j = 0;
+#endif
 
     UNUSED_VAR(ca_public_key->buf[0]);
 
@@ -283,6 +509,19 @@ ATCA_STATUS atcacert_read_cert_ext(ATCADevice               device,
     }
     else
     {
+#if ATCACERT_CACHE_EN
+        /* Once an entry has been checked against the device this session,
+           serve it without any device reads */
+        if (ATCA_SUCCESS != (ret = atcacert_cache_ca_key(ca_public_key, cache_ca_key)))
+        {
+            return ret;
+        }
+        entry = atcacert_cache_find(device, cert_def);
+        if ((NULL != entry) && entry->checked && (0 == memcmp(entry->ca_key, cache_ca_key, sizeof(cache_ca_key))))
+        {
+            return atcacert_cache_copy(entry, cert, cert_size);
+        }
+#endif
 #if ATCACERT_COMPCERT_EN
         ret = atcacert_get_device_locs(
             device,
@@ -295,7 +534,26 @@ ATCA_STATUS atcacert_read_cert_ext(ATCADevice               device,
         {
             return ret;
         }
-
+#endif
+#if ATCACERT_CACHE_EN
+        if (ATCACERT_E_SUCCESS == atcacert_cache_key(device, cert_def, ca_public_key, device_locs, device_locs_count,
+                                                     cache_key_locs, &cache_key_locs_count, cache_key))
+        {
+            cache_key_valid = true;
+            if ((NULL != entry) && (0 == memcmp(entry->key, cache_key, sizeof(cache_key))))
+            {
+                (void)memcpy(entry->ca_key, cache_ca_key, sizeof(cache_ca_key));
+                entry->checked = true;
+                return atcacert_cache_copy(entry, cert, cert_size);
+            }
+        }
+        else
+        {
+            /* Nothing from a partial key read can be reused */
+            cache_key_locs_count = 0;
+        }
+#endif
+#if ATCACERT_COMPCERT_EN
         ret = atcacert_cert_build_start(device, &build_state, cert_def, cert, cert_size, ca_public_key);
         if (ret != ATCACERT_E_SUCCESS)
         {
@@ -305,13 +563,28 @@ ATCA_STATUS atcacert_read_cert_ext(ATCADevice               device,
         for (i = 0; i < device_locs_count; i++)
         {
             static uint8_t data[ATCA_MAX_DATA_SIZE];
-            ret = atcacert_read_device_loc_ext(device, &device_locs[i], data);
-            if (ret != ATCACERT_E_SUCCESS)
+            const uint8_t* loc_data = data;
+#if ATCACERT_CACHE_EN
+            /* Already read for the cache key */
+            for (j = 0; j < cache_key_locs_count; j++)
             {
-                return ret;
+                if (cache_key_locs[j] == i)
+                {
+                    loc_data = atcacert_cache_key_data[j];
+                    break;
+                }
+            }
+            if (loc_data == data)
+#endif
+            {
+                ret = atcacert_read_device_loc_ext(device, &device_locs[i], data);
+                if (ret != ATCACERT_E_SUCCESS)
+                {
+                    return ret;
+                }
             }
 
-            ret = atcacert_cert_build_process(&build_state, &device_locs[i], data);
+            ret = atcacert_cert_build_process(&build_state, &device_locs[i], loc_data);
             if (ret != ATCACERT_E_SUCCESS)
             {
                 return ret;
@@ -323,6 +596,12 @@ ATCA_STATUS atcacert_read_cert_ext(ATCADevice               device,
         {
             return ret;
         }
+#endif
+#if ATCACERT_CACHE_EN
+        if (cache_key_valid)
+        {
+            atcacert_cache_store(device, cert_def, cache_key, cache_ca_key, cert, *cert_size);
+        }
 #endif
     }
 
@@ -362,6 +641,10 @@ ATCA_STATUS atcacert_write_cert_ext(ATCADevice              device,
     }
 #endif
 
+#if ATCACERT_CACHE_EN
+    atcacert_cache_invalidate(cert_def);
+#endif
+
     if (CERTTYPE_X509_FULL_STORED == cert_def->type)
     {
 #if ATCACERT_FULLSTOREDCERT_EN
@@ -127,6 +127,23 @@ ATCA_STATUS atcacert_read_cert_ext(ATCADevice            device,
                                    uint8_t*              cert,
                                    size_t*               cert_size);
 
+#if ATCACERT_CACHE_EN
+/**
+ * \brief Drop every certificate held by the atcacert_read_cert cache. Needed
+ *        after changing the device contents behind the library's back (key
+ *        generation or raw writes to a certificate slot) within a session -
+ *        atcacert_write_cert already invalidates the certificate it writes.
+ */
+void atcacert_cache_clear(void);
+
+/**
+ * \brief Start a new cache session: the next atcacert_read_cert of each
+ *        cached certificate checks it against the device again, later ones
+ *        are served from RAM. Called by atcab_release_ext.
+ */
+void atcacert_cache_new_session(void);
+#endif
+
 /**
  * \brief Take a full certificate and write it to the ATECC508A device according to the
  *        certificate definition.
@@ -262,6 +262,9 @@ ATCA_STATUS calib_hw_sha2_256_init(ATCADevice device, atca_sha256_ctx_t* ctx);
 ATCA_STATUS calib_hw_sha2_256_update(ATCADevice device, atca_sha256_ctx_t* ctx, const uint8_t* data, size_t data_size);
 ATCA_STATUS calib_hw_sha2_256_finish(ATCADevice device, atca_sha256_ctx_t* ctx, uint8_t* digest);
 #endif
+#if CALIB_SHA_HYBRID_EN
+ATCA_STATUS calib_hw_sha2_256_hybrid(ATCADevice device, const uint8_t* data, size_t data_size, uint8_t* digest, uint8_t target);
+#endif
 #if CALIB_SHA_HMAC_EN
 ATCA_STATUS calib_sha_hmac_init(ATCADevice device, atca_hmac_sha256_ctx_t* ctx, uint16_t key_slot);
 ATCA_STATUS calib_sha_hmac_update(ATCADevice device, atca_hmac_sha256_ctx_t* ctx, const uint8_t* data, size_t data_size);
@@ -535,6 +535,22 @@
 #define CALIB_SHA_CONTEXT_EN          (ATCAB_SHA_CONTEXT_EN && CALIB_ECC608_EN)
 #endif
 
+/** \def CALIB_SHA_HYBRID_EN
+ *
+ * Requires:
+ *           CALIB_SHA_CONTEXT_EN
+ *
+ * Hash the whole-block prefix of a calib_hw_sha2_256 message on the host and
+ * load the midstate into the ATECC608 with Write_Context, so only the final
+ * partial block crosses the bus. The digest still ends up in TempKey or the
+ * message digest buffer as before.
+ *
+ * Supported API's: calib_hw_sha2_256, calib_hw_sha2_256_hybrid
+ **/
+#ifndef CALIB_SHA_HYBRID_EN
+#define CALIB_SHA_HYBRID_EN           (CALIB_SHA_CONTEXT_EN && CALIB_SHA_EN)
+#endif
+
 /****** SIGN command ******/
 
 /** \def CALIB_SIGN_EN
@@ -469,9 +469,12 @@ ATCA_STATUS calib_execute_command(ATCAPacket* packet, ATCADevice device)
     ATCA_STATUS status;
     uint32_t execution_or_wait_time;
     uint32_t max_delay_count;
-    uint16_t rxsize;
+    uint16_t rxsize = 0;
     uint8_t device_address = atcab_get_device_address(device);
     int32_t retries;
+    uint32_t wait_ms = 0;
+    uint16_t polls = 0;
+    TRACE_BEGIN(trace_start);
 
     do
     {
@@ -549,12 +552,14 @@ ATCA_STATUS calib_execute_command(ATCAPacket* packet, ATCADevice device)
 
         // Delay for execution time or initial wait before polling
         atca_delay_ms(execution_or_wait_time);
+        wait_ms = execution_or_wait_time;
 
         do
         {
             (void)memset(packet->data, 0, sizeof(packet->data));
             // receive the response
             rxsize = (uint16_t)sizeof(packet->data);
+            polls++;
 
             if (ATCA_SUCCESS == (status = calib_execute_receive(device, device_address, packet->data, &rxsize)))
             {
@@ -564,6 +569,7 @@ ATCA_STATUS calib_execute_command(ATCAPacket* packet, ATCADevice device)
 #ifndef ATCA_NO_POLL
             // delay for polling frequency time
             atca_delay_ms(ATCA_POLLING_FREQUENCY_TIME_MSEC);
+            wait_ms += ATCA_POLLING_FREQUENCY_TIME_MSEC;
 #endif
         }
         /* coverity[cert_int30_c_violation:FALSE]  No overflow possible */
@@ -607,5 +613,6 @@ ATCA_STATUS calib_execute_command(ATCAPacket* packet, ATCADevice device)
         device->device_state = (uint8_t)ATCA_DEVICE_STATE_IDLE;
     }
 
+    TRACE_END(trace_start, TRACE_ATCA_COMMAND, packet->opcode, rxsize, wait_ms, polls);
     return status;
 }
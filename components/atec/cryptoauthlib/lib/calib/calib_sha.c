@@ -33,6 +33,9 @@
  */
 
 #include "cryptoauthlib.h"
+#if CALIB_SHA_HYBRID_EN
+#include "crypto/hashes/sha2_routines.h"
+#endif
 
 #if CALIB_SHA_EN
 
@@ -368,7 +371,191 @@ ATCA_STATUS calib_hw_sha2_256_finish(ATCADevice device, atca_sha256_ctx_t* ctx,
     return ATCA_SUCCESS;
 }
 
+#if CALIB_SHA_HYBRID_EN
+/* Context returned by Read_Context on a block boundary - 32 byte state and a
+   4 byte message counter. The order and encoding of the two fields is learned
+   from the device once (calib_sha_hybrid_probe) rather than assumed. */
+#define SHA_HYBRID_CONTEXT_SIZE     (ATCA_SHA256_DIGEST_SIZE + 4u)
+
+#define SHA_HYBRID_STATE_FIRST      ((uint8_t)0x01)   //!< State precedes the counter
+#define SHA_HYBRID_STATE_LE         ((uint8_t)0x02)   //!< State words are little endian
+#define SHA_HYBRID_COUNT_LE         ((uint8_t)0x04)   //!< Counter is little endian
+#define SHA_HYBRID_COUNT_BITS       ((uint8_t)0x08)   //!< Counter is in bits rather than bytes
+#define SHA_HYBRID_VALID            ((uint8_t)0x80)   //!< Layout has been learned
+
+static ATCADevice calib_sha_hybrid_device;
+static uint8_t calib_sha_hybrid_layout;
+
+static void calib_sha_hybrid_put32(uint8_t* buf, uint32_t value, bool little_endian)
+{
+    uint8_t i;
+
+    for (i = 0u; i < 4u; i++)
+    {
+        buf[little_endian ? i : (3u - i)] = (uint8_t)((value >> (8u * i)) & 0xFFu);
+    }
+}
+
+static void calib_sha_hybrid_encode(uint8_t layout, const uint32_t hash[8], uint32_t msg_size, uint8_t* context)
+{
+    uint8_t* state = context;
+    uint8_t* count = &context[ATCA_SHA256_DIGEST_SIZE];
+    uint8_t i;
+
+    if (0u == (layout & SHA_HYBRID_STATE_FIRST))
+    {
+        count = context;
+        state = &context[4];
+    }
+
+    for (i = 0u; i < 8u; i++)
+    {
+        calib_sha_hybrid_put32(&state[i * 4u], hash[i], (0u != (layout & SHA_HYBRID_STATE_LE)));
+    }
+
+    calib_sha_hybrid_put32(count, (0u != (layout & SHA_HYBRID_COUNT_BITS)) ? (msg_size * 8u) : msg_size,
+                           (0u != (layout & SHA_HYBRID_COUNT_LE)));
+}
+
+/** \brief Learn how the device lays out a SHA context by hashing one known
+ *          block and matching the context it reports against every layout
+ *          the host could encode. Leaves the device SHA engine in use.
+ */
+static uint8_t calib_sha_hybrid_probe(ATCADevice device)
+{
+    uint8_t block[ATCA_SHA256_BLOCK_SIZE];
+    uint8_t context[SHA_HYBRID_CONTEXT_SIZE * 2u];
+    uint8_t expected[SHA_HYBRID_CONTEXT_SIZE];
+    uint16_t context_size = (uint16_t)sizeof(context);
+    uint32_t hash[8];
+    uint8_t layout;
+
+    (void)memset(block, 0, sizeof(block));
+
+    if ((ATCA_SUCCESS != calib_sha_start(device)) ||
+        (ATCA_SUCCESS != calib_sha_update(device, block)) ||
+        (ATCA_SUCCESS != calib_sha_read_context(device, context, &context_size)) ||
+        (SHA_HYBRID_CONTEXT_SIZE != context_size) ||
+        (ATCA_SUCCESS != sw_sha256_midstate(hash, block)))
+    {
+        return 0u;
+    }
+
+    for (layout = 0u; layout <= (SHA_HYBRID_STATE_FIRST | SHA_HYBRID_STATE_LE | SHA_HYBRID_COUNT_LE | SHA_HYBRID_COUNT_BITS); layout++)
+    {
+        calib_sha_hybrid_encode(layout, hash, ATCA_SHA256_BLOCK_SIZE, expected);
+        if (0 == memcmp(expected, context, SHA_HYBRID_CONTEXT_SIZE))
+        {
+            return layout | SHA_HYBRID_VALID;
+        }
+    }
+
+    return 0u;
+}
+
+/** \brief Compute a SHA-256 digest with the whole-block prefix of the message
+ *          hashed on the host. The resulting midstate is written into the
+ *          device with Write_Context and only the last partial block is sent
+ *          with the End command, so the digest still lands in the requested
+ *          device target. Only usable for unkeyed SHA-256 on the ATECC608;
+ *          other devices (or a device whose context layout isn't recognised)
+ *          hash the whole message on the device.
+ *
+ * \param[in]  device     Device context pointer
+ * \param[in]  data       Message data to be hashed.
+ * \param[in]  data_size  Size of data in bytes.
+ * \param[out] digest     Digest is returned here (32 bytes).
+ * \param[in]  target     Where to save the digest internal to the device.
+ *                        SHA_MODE_TARGET_TEMPKEY, SHA_MODE_TARGET_MSGDIGBUF,
+ *                        or SHA_MODE_TARGET_OUT_ONLY.
+ *
+ * \return ATCA_SUCCESS on success, otherwise an error code.
+ */
+ATCA_STATUS calib_hw_sha2_256_hybrid(ATCADevice device, const uint8_t* data, size_t data_size, uint8_t* digest, uint8_t target)
+{
+    ATCA_STATUS status = ATCA_SUCCESS;
+    size_t block_count;
+    size_t prefix_size;
+    uint16_t digest_size = ATCA_SHA256_DIGEST_SIZE;
+
+    if ((NULL == device) || ((NULL == data) && (0u < data_size)) || (UINT32_MAX / 8u < data_size))
+    {
+        return ATCA_TRACE(ATCA_BAD_PARAM, "Invalid parameter received");
+    }
+
+    if (ATECC608 != device->mIface.mIfaceCFG->devtype)
+    {
+        if (SHA_MODE_TARGET_TEMPKEY != target)
+        {
+            return ATCA_TRACE(ATCA_BAD_PARAM, "Digest target not supported by device");
+        }
+
+        calib_sha_hybrid_device = NULL;
+        return calib_hw_sha2_256(device, data, data_size, digest);
+    }
+
+    block_count = data_size / ATCA_SHA256_BLOCK_SIZE;
+
+    if ((0u < block_count) && (calib_sha_hybrid_device != device))
+    {
+        calib_sha_hybrid_layout = calib_sha_hybrid_probe(device);
+        calib_sha_hybrid_device = device;
+    }
+
+    if ((0u < block_count) && (0u != (calib_sha_hybrid_layout & SHA_HYBRID_VALID)))
+    {
+        uint8_t context[SHA_HYBRID_CONTEXT_SIZE];
+        uint32_t hash[8];
+
+        prefix_size = block_count * ATCA_SHA256_BLOCK_SIZE;
+
+        if (ATCA_SUCCESS != (status = sw_sha256_midstate(hash, data)))
+        {
+            return ATCA_TRACE(status, "sw_sha256_midstate - failed");
+        }
+
+        if ((1u < block_count) && (ATCA_SUCCESS != (status = sw_sha256_transform(hash, &data[ATCA_SHA256_BLOCK_SIZE], (uint32_t)(block_count - 1u)))))
+        {
+            return ATCA_TRACE(status, "sw_sha256_transform - failed");
+        }
+
+        calib_sha_hybrid_encode(calib_sha_hybrid_layout, hash, (uint32_t)prefix_size, context);
+
+        status = calib_sha_write_context(device, context, (uint16_t)sizeof(context));
+        (void)memset(hash, 0, sizeof(hash));
+        (void)memset(context, 0, sizeof(context));
+
+        if (ATCA_SUCCESS != status)
+        {
+            return ATCA_TRACE(status, "calib_sha_write_context - failed");
+        }
+    }
+    else
+    {
+        /* Context layout not recognised - whole message goes through the device */
+        atca_sha256_ctx_t ctx;
+
+        if (ATCA_SUCCESS != (status = calib_hw_sha2_256_init(device, &ctx)))
+        {
+            return ATCA_TRACE(status, "calib_hw_sha2_256_init - failed");
+        }
+
+        prefix_size = data_size - (data_size % ATCA_SHA256_BLOCK_SIZE);
+        if ((0u < prefix_size) && (ATCA_SUCCESS != (status = calib_hw_sha2_256_update(device, &ctx, data, prefix_size))))
+        {
+            return ATCA_TRACE(status, "calib_hw_sha2_256_update - failed");
+        }
+    }
+
+    return calib_sha_base(device, SHA_MODE_SHA256_END | target, (uint16_t)((data_size - prefix_size) & UINT16_MAX),
+                          &data[prefix_size], digest, &digest_size);
+}
+#endif /* CALIB_SHA_HYBRID_EN */
+
 /** \brief Use the SHA command to compute a SHA-256 digest.
+ *
+ * When CALIB_SHA_HYBRID_EN is enabled whole blocks are hashed on the host and
+ * only the midstate and final partial block are sent to the device.
  *
  * \param[in]  device     Device context pointer
  * \param[in]  data       Message data to be hashed.
@@ -382,6 +569,13 @@ ATCA_STATUS calib_hw_sha2_256(ATCADevice device, const uint8_t * data, size_t da
     ATCA_STATUS status = ATCA_SUCCESS;
     atca_sha256_ctx_t ctx;
 
+#if CALIB_SHA_HYBRID_EN
+    if ((NULL != device) && (ATECC608 == device->mIface.mIfaceCFG->devtype) && (ATCA_SHA256_BLOCK_SIZE <= data_size))
+    {
+        return calib_hw_sha2_256_hybrid(device, data, data_size, digest, SHA_MODE_TARGET_TEMPKEY);
+    }
+#endif
+
     if (ATCA_SUCCESS != (status = calib_hw_sha2_256_init(device, &ctx)))
     {
         return ATCA_TRACE(status, "calib_hw_sha2_256_init - failed");
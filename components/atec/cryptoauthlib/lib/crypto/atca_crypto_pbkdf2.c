@@ -30,7 +30,79 @@
 #include "cal_internal.h"
 
 #if ATCAC_PBKDF2_SHA256_EN
+#include "hashes/sha2_routines.h"
+
+/* Length in bits of an inner or outer HMAC message once the 64 byte key block
+   has been absorbed into the midstate and a 32 byte digest appended */
+#define ATCAC_PBKDF2_HMAC_MSG_BITS      ((ATCA_SHA2_256_BLOCK_SIZE + ATCA_SHA2_256_DIGEST_SIZE) * 8u)
+
+static void atcac_pbkdf2_sha256_store(uint8_t* digest, const uint32_t hash[8])
+{
+    uint32_t i;
+
+    for (i = 0u; i < 8u; i++)
+    {
+        digest[i * 4u + 0u] = (uint8_t)(hash[i] >> 24u);
+        digest[i * 4u + 1u] = (uint8_t)(hash[i] >> 16u);
+        digest[i * 4u + 2u] = (uint8_t)(hash[i] >> 8u);
+        digest[i * 4u + 3u] = (uint8_t)(hash[i]);
+    }
+}
+
+/** \brief Finish a SHA256 whose earlier blocks are already in hash. msg_len is
+ *         the length of the whole message including those blocks.
+ */
+static ATCA_STATUS atcac_pbkdf2_sha256_tail(
+    uint32_t       hash[8],
+    uint64_t       msg_len,
+    const uint8_t* data,
+    size_t         data_len,
+    uint8_t        digest[ATCA_SHA2_256_DIGEST_SIZE]
+    )
+{
+    ATCA_STATUS status = ATCA_SUCCESS;
+    uint8_t block[ATCA_SHA2_256_BLOCK_SIZE];
+    uint64_t bit_len = msg_len * 8u;
+    size_t full = data_len / ATCA_SHA2_256_BLOCK_SIZE;
+    size_t rem = data_len % ATCA_SHA2_256_BLOCK_SIZE;
+    uint32_t i;
+
+    if (0u < full)
+    {
+        status = sw_sha256_transform(hash, data, (uint32_t)full);
+    }
+
+    (void)memset(block, 0, sizeof(block));
+    (void)memcpy(block, &data[full * ATCA_SHA2_256_BLOCK_SIZE], rem);
+    block[rem] = 0x80u;
+
+    if ((ATCA_SUCCESS == status) && (rem >= (ATCA_SHA2_256_BLOCK_SIZE - 8u)))
+    {
+        status = sw_sha256_transform(hash, block, 1u);
+        (void)memset(block, 0, sizeof(block));
+    }
+
+    if (ATCA_SUCCESS == status)
+    {
+        for (i = 0u; i < 8u; i++)
+        {
+            block[ATCA_SHA2_256_BLOCK_SIZE - 1u - i] = (uint8_t)(bit_len >> (i * 8u));
+        }
+        status = sw_sha256_transform(hash, block, 1u);
+    }
+
+    if (ATCA_SUCCESS == status)
+    {
+        atcac_pbkdf2_sha256_store(digest, hash);
+    }
+
+    return status;
+}
+
 /** \brief Calculate a PBKDF2 hash of a given password and salt
+ *
+ * The HMAC ipad and opad key blocks are hashed once into midstates so every
+ * iteration costs two SHA256 compressions rather than four.
  *
  *  \return ATCA_SUCCESS on success, otherwise an error code.
  */
@@ -45,66 +117,108 @@ ATCA_STATUS atcac_pbkdf2_sha256(
     )
 {
     ATCA_STATUS status = ATCA_BAD_PARAM;
-    atcac_hmac_ctx_t ctx;
+    uint32_t inner_mid[8];
+    uint32_t outer_mid[8];
+    uint32_t hash[8];
     uint32_t i, j;
     uint32_t counter = 1;
+    uint8_t key_block[ATCA_SHA2_256_BLOCK_SIZE];
+    uint8_t block[ATCA_SHA2_256_BLOCK_SIZE];
     uint8_t temp1_digest[ATCA_SHA256_DIGEST_SIZE] = { 0 };
     uint8_t temp2_digest[ATCA_SHA256_DIGEST_SIZE] = { 0 };
-    atcac_sha2_256_ctx_t sha256_ctx;
+    uint8_t message[ATCA_SHA2_256_BLOCK_SIZE + 4u];
+    size_t salt_blocks = salt_len / ATCA_SHA2_256_BLOCK_SIZE;
+    size_t salt_rem = salt_len % ATCA_SHA2_256_BLOCK_SIZE;
 
-    if ((0U >= result_len))
+    if ((0U >= result_len) || (NULL == password) || (NULL == result) || ((NULL == salt) && (0u < salt_len)))
     {
         return status;
     }
 
-    do
+    /* K0 - keys longer than a block are hashed first */
+    (void)memset(key_block, 0, sizeof(key_block));
+    if (password_len > ATCA_SHA2_256_BLOCK_SIZE)
     {
-        size_t temp_size = ATCA_SHA256_DIGEST_SIZE;
-        uint32_t temp_u32;
+        status = atcac_sw_sha2_256(password, password_len, key_block);
+    }
+    else
+    {
+        (void)memcpy(key_block, password, password_len);
+        status = ATCA_SUCCESS;
+    }
 
-        if (ATCA_SUCCESS != (status = atcac_sha256_hmac_init(&ctx, &sha256_ctx, password, (uint8_t)(password_len & 0xFFu))))
+    /* Cache the keyed inner and outer midstates */
+    if (ATCA_SUCCESS == status)
+    {
+        for (j = 0u; j < ATCA_SHA2_256_BLOCK_SIZE; j++)
         {
-            break;
+            block[j] = key_block[j] ^ 0x36u;
         }
+        status = sw_sha256_midstate(inner_mid, block);
+    }
 
-        if (ATCA_SUCCESS != (status = atcac_sha256_hmac_update(&ctx, salt, salt_len)))
+    if (ATCA_SUCCESS == status)
+    {
+        for (j = 0u; j < ATCA_SHA2_256_BLOCK_SIZE; j++)
         {
-            break;
+            block[j] = key_block[j] ^ 0x5Cu;
         }
+        status = sw_sha256_midstate(outer_mid, block);
+    }
 
-        temp_u32 = ATCA_UINT32_HOST_TO_BE(counter);
-        if (ATCA_SUCCESS != (status = atcac_sha256_hmac_update(&ctx, (uint8_t*)&temp_u32, 4)))
+    while ((ATCA_SUCCESS == status) && (0u < result_len))
+    {
+        uint32_t temp_u32 = ATCA_UINT32_HOST_TO_BE(counter);
+
+        /* U1 = PRF(P, S || INT(counter)) */
+        (void)memcpy(hash, inner_mid, sizeof(hash));
+        if (0u < salt_blocks)
         {
-            break;
+            status = sw_sha256_transform(hash, salt, (uint32_t)salt_blocks);
         }
-
-        if (ATCA_SUCCESS != (status = atcac_sha256_hmac_finish(&ctx, temp1_digest, &temp_size)))
+        if (0u < salt_rem)
         {
-            break;
+            (void)memcpy(message, &salt[salt_blocks * ATCA_SHA2_256_BLOCK_SIZE], salt_rem);
         }
+        (void)memcpy(&message[salt_rem], (uint8_t*)&temp_u32, 4);
 
-        (void)memcpy(temp2_digest, temp1_digest, ATCA_SHA256_DIGEST_SIZE);
+        if (ATCA_SUCCESS == status)
+        {
+            status = atcac_pbkdf2_sha256_tail(hash, (uint64_t)ATCA_SHA2_256_BLOCK_SIZE + salt_len + 4u,
+                                              message, salt_rem + 4u, temp2_digest);
+        }
 
-        for (i = 1; i < iter; i++)
+        if (ATCA_SUCCESS == status)
         {
-            if (ATCA_SUCCESS != (status = atcac_sha256_hmac_init(&ctx, &sha256_ctx, password, (uint8_t)password_len)))
-            {
-                break;
-            }
+            (void)memcpy(hash, outer_mid, sizeof(hash));
+            status = atcac_pbkdf2_sha256_tail(hash, (uint64_t)ATCA_SHA2_256_BLOCK_SIZE + ATCA_SHA256_DIGEST_SIZE,
+                                              temp2_digest, ATCA_SHA256_DIGEST_SIZE, temp1_digest);
+        }
 
-            if (ATCA_SUCCESS != (status = atcac_sha256_hmac_update(&ctx, temp2_digest, ATCA_SHA256_DIGEST_SIZE)))
-            {
-                break;
-            }
+        /* Every later Un is a 32 byte message - lay out the padding once and
+           only swap the digest in for each compression */
+        (void)memset(block, 0, sizeof(block));
+        (void)memcpy(block, temp1_digest, ATCA_SHA256_DIGEST_SIZE);
+        block[ATCA_SHA256_DIGEST_SIZE] = 0x80u;
+        block[ATCA_SHA2_256_BLOCK_SIZE - 2u] = (uint8_t)(ATCAC_PBKDF2_HMAC_MSG_BITS >> 8u);
+        block[ATCA_SHA2_256_BLOCK_SIZE - 1u] = (uint8_t)(ATCAC_PBKDF2_HMAC_MSG_BITS & 0xFFu);
+
+        for (i = 1; (ATCA_SUCCESS == status) && (i < iter); i++)
+        {
+            (void)memcpy(hash, inner_mid, sizeof(hash));
+            status = sw_sha256_transform(hash, block, 1u);
+            atcac_pbkdf2_sha256_store(block, hash);
 
-            if (ATCA_SUCCESS != (status = atcac_sha256_hmac_finish(&ctx, temp2_digest, &temp_size)))
+            if (ATCA_SUCCESS == status)
             {
-                break;
+                (void)memcpy(hash, outer_mid, sizeof(hash));
+                status = sw_sha256_transform(hash, block, 1u);
+                atcac_pbkdf2_sha256_store(block, hash);
             }
 
             for (j = 0u; j < ATCA_SHA256_DIGEST_SIZE; j++)
             {
-                temp1_digest[j] ^= temp2_digest[j];
+                temp1_digest[j] ^= block[j];
             }
         }
 
@@ -120,7 +234,12 @@ ATCA_STATUS atcac_pbkdf2_sha256(
         /* coverity[cert_int30_c_violation:FALSE] counter can't wrap as result_len is checked to be less than SIZE_MAX */
         counter++;
     }
-    while (0u < result_len);
+
+    (void)memset(key_block, 0, sizeof(key_block));
+    (void)memset(block, 0, sizeof(block));
+    (void)memset(inner_mid, 0, sizeof(inner_mid));
+    (void)memset(outer_mid, 0, sizeof(outer_mid));
+
     return status;
 }
 #endif /* ATCAC_PBKDF2_SHA256 */
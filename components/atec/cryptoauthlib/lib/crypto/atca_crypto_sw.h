@@ -236,6 +236,10 @@ ATCA_STATUS atcac_pk_verify(struct atcac_pk_ctx* ctx, const uint8_t* digest, siz
 ATCA_STATUS atcac_pk_derive(struct atcac_pk_ctx* private_ctx, struct atcac_pk_ctx* public_ctx, uint8_t* buf, size_t* buflen);
 #endif /* ATCAC_PKEY_EN */
 
+#if ATCAB_VERIFY_EXTERN_HOST_EN
+ATCA_STATUS atcac_sw_ecdsa_verify_p256(const uint8_t* digest, const uint8_t* signature, const uint8_t* public_key, bool* is_verified);
+#endif
+
 #if ATCAC_PBKDF2_SHA256_EN
 ATCA_STATUS atcac_pbkdf2_sha256(const uint32_t iter, const uint8_t* password, const size_t password_len,
                                 const uint8_t* salt, const size_t salt_len, uint8_t* result, size_t result_len);
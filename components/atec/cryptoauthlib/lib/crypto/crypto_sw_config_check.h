@@ -230,6 +230,19 @@
 #define ATCAC_PBKDF2_SHA256_EN      ATCAC_SHA256_HMAC_EN
 #endif
 
+/** \def  ATCA_CRYPTO_SHA256_TRANSFORM_EN
+ *
+ * Build the raw SHA256 compression function from the internal SHA2 routines
+ * even when the host library provides SHA256. atcac_pbkdf2_sha256 uses it to
+ * run its iterations on cached HMAC ipad/opad midstates and the hybrid calib
+ * SHA uses it to hash message prefixes on the host.
+ *
+ * Supported API's: sw_sha256_transform, sw_sha256_midstate
+ **/
+#ifndef ATCA_CRYPTO_SHA256_TRANSFORM_EN
+#define ATCA_CRYPTO_SHA256_TRANSFORM_EN     (ATCA_CRYPTO_SHA256_EN || ATCAC_PBKDF2_SHA256_EN || CALIB_SHA_HYBRID_EN)
+#endif
+
 /** \def  ATCAB_PBKDF2_SHA256_EN
  *
  * Requires: CALIB_SHA_HMAC_EN
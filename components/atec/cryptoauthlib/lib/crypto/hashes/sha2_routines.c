@@ -36,23 +36,24 @@
 #define rotate_right(value, places) (((value) >> (places)) | ((value) << (32U - (places))))
 #define rotate_right_64bit(value, places) (((value) >> (places)) | ((value) << (64U - (places))))
 
-#if ATCA_CRYPTO_SHA256_EN
+#if ATCA_CRYPTO_SHA256_TRANSFORM_EN
 /**
- * \brief Processes whole blocks (64 bytes) of data.
+ * \brief Runs the SHA256 compression function over whole blocks (64 bytes)
+ *        of data without any buffering or padding.
  *
- * \param[in] ctx          SHA256 hash context
- * \param[in] blocks       Raw blocks to be processed
- * \param[in] block_count  Number of 64-byte blocks to process
+ * \param[in,out] hash         SHA256 chaining state
+ * \param[in]     blocks       Raw blocks to be processed
+ * \param[in]     block_count  Number of 64-byte blocks to process
  *
  * \return ATCA_SUCCESS on success, otherwise an error code.
  */
-static ATCA_STATUS sw_sha256_process(sw_sha256_ctx* ctx, const uint8_t* blocks, uint32_t block_count)
+ATCA_STATUS sw_sha256_transform(uint32_t hash[8], const uint8_t* blocks, uint32_t block_count)
 {
     ATCA_STATUS status = ATCA_BAD_PARAM;
     uint16_t i = 0u;
     uint32_t block = 0u;
 
-    if((NULL == ctx) || (NULL == blocks))
+    if((NULL == hash) || (NULL == blocks))
     {
         return status;
     }
@@ -115,7 +116,7 @@ static ATCA_STATUS sw_sha256_process(sw_sha256_ctx* ctx, const uint8_t* blocks,
         // Initialize hash value for this chunk.
         for (i = 0U; i < 8U; i++)
         {
-            rotate_register[i] = ctx->hash[i];
+            rotate_register[i] = hash[i];
         }
 
         // hash calculation loop
@@ -148,12 +149,60 @@ static ATCA_STATUS sw_sha256_process(sw_sha256_ctx* ctx, const uint8_t* blocks,
         // Add the hash of this block to current result.
         for (i = 0U; i < 8U; i++)
         {
-            ctx->hash[i] += rotate_register[i];
+            hash[i] += rotate_register[i];
         }
     }
 
     return (status = ATCA_SUCCESS);
 }
+
+/**
+ * \brief Hash a single 64-byte block from the SHA256 initial state, leaving
+ *        the intermediate (midstate) chaining value in hash. Used to cache
+ *        the keyed ipad/opad states of HMAC.
+ *
+ * \param[out] hash   SHA256 chaining state after the block
+ * \param[in]  block  64-byte block to process
+ *
+ * \return ATCA_SUCCESS on success, otherwise an error code.
+ */
+ATCA_STATUS sw_sha256_midstate(uint32_t hash[8], const uint8_t block[SHA256_BLOCK_SIZE])
+{
+    static const uint32_t hash_init[] = {
+        0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+        0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+    };
+
+    if (NULL == hash)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    (void)memcpy(hash, hash_init, sizeof(hash_init));
+
+    return sw_sha256_transform(hash, block, 1u);
+}
+#endif
+
+#if ATCA_CRYPTO_SHA256_EN
+/**
+ * \brief Processes whole blocks (64 bytes) of data.
+ *
+ * \param[in] ctx          SHA256 hash context
+ * \param[in] blocks       Raw blocks to be processed
+ * \param[in] block_count  Number of 64-byte blocks to process
+ *
+ * \return ATCA_SUCCESS on success, otherwise an error code.
+ */
+static ATCA_STATUS sw_sha256_process(sw_sha256_ctx* ctx, const uint8_t* blocks, uint32_t block_count)
+{
+    if (NULL == ctx)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    return sw_sha256_transform(ctx->hash, blocks, block_count);
+}
 #endif
 
 #if ATCA_CRYPTO_SHA512_EN
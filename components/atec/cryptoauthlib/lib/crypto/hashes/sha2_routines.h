@@ -78,6 +78,12 @@ typedef struct
 } sw_sha512_ctx;
 #endif
 
+#if ATCA_CRYPTO_SHA256_TRANSFORM_EN
+// Raw SHA256 compression function
+ATCA_STATUS sw_sha256_transform(uint32_t hash[8], const uint8_t* blocks, uint32_t block_count);
+ATCA_STATUS sw_sha256_midstate(uint32_t hash[8], const uint8_t block[SHA256_BLOCK_SIZE]);
+#endif
+
 #if ATCA_CRYPTO_SHA256_EN
 // SHA256
 ATCA_STATUS sw_sha256_init(sw_sha256_ctx* ctx);
@@ -250,6 +250,10 @@ ATCA_STATUS hal_init_mutex(void * pMutex, bool shared);
 ATCA_STATUS hal_destroy_mutex(void * pMutex);
 ATCA_STATUS hal_lock_mutex(void * pMutex);
 ATCA_STATUS hal_unlock_mutex(void * pMutex);
+ATCA_STATUS hal_create_semaphore(void ** ppSem);
+ATCA_STATUS hal_destroy_semaphore(void * pSem);
+ATCA_STATUS hal_wait_semaphore(void * pSem);
+ATCA_STATUS hal_post_semaphore(void * pSem);
 ATCA_STATUS hal_alloc_shared(void ** pShared, size_t size, const char* pName, bool* initialized);
 ATCA_STATUS hal_free_shared(void * pShared, size_t size);
 
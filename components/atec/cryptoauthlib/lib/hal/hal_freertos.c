@@ -154,4 +154,64 @@ ATCA_STATUS hal_unlock_mutex(void * pMutex)
     }
 }
 
+ATCA_STATUS hal_create_semaphore(void ** ppSem)
+{
+    if (!ppSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    /* Binary semaphores are created empty */
+    (*ppSem) = xSemaphoreCreateBinary();
+
+    if (!*ppSem)
+    {
+        return ATCA_FUNC_FAIL;
+    }
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_destroy_semaphore(void * pSem)
+{
+    if (!pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    vSemaphoreDelete(pSem);
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_wait_semaphore(void * pSem)
+{
+    if (!pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    if (!xSemaphoreTake((SemaphoreHandle_t)pSem, portMAX_DELAY))
+    {
+        return ATCA_GEN_FAIL;
+    }
+    else
+    {
+        return ATCA_SUCCESS;
+    }
+}
+
+ATCA_STATUS hal_post_semaphore(void * pSem)
+{
+    if (!pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    /* Giving a semaphore that is already given fails but leaves it given */
+    (void)xSemaphoreGive((SemaphoreHandle_t)pSem);
+
+    return ATCA_SUCCESS;
+}
+
 /** @} */
@@ -384,6 +384,82 @@ ATCA_STATUS hal_unlock_mutex(void *pMutex)
 }
 #endif
 
+#include <semaphore.h>
+
+/**
+ * \brief Create an unnamed semaphore that starts taken, for one thread to
+ * wait on until another posts it
+ * \param[in,out] ppSem location to receive ptr to the semaphore
+ */
+ATCA_STATUS hal_create_semaphore(void ** ppSem)
+{
+    sem_t * sem;
+
+    if (NULL == ppSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    /* coverity[misra_c_2012_rule_21_3_violation] Required for the linux environment */
+    if (NULL == (sem = malloc(sizeof(sem_t))))
+    {
+        return ATCA_ALLOC_FAILURE;
+    }
+
+    if (0 != sem_init(sem, 0, 0))
+    {
+        /* coverity[misra_c_2012_rule_21_3_violation] Required for the linux environment */
+        free(sem);
+        return ATCA_GEN_FAIL;
+    }
+
+    *ppSem = sem;
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_destroy_semaphore(void * pSem)
+{
+    if (NULL == pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    (void)sem_destroy((sem_t*)pSem);
+    /* coverity[misra_c_2012_rule_21_3_violation] Required for the linux environment */
+    free(pSem);
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_wait_semaphore(void * pSem)
+{
+    int rv;
+
+    if (NULL == pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    do
+    {
+        rv = sem_wait((sem_t*)pSem);
+    }
+    while ((0 != rv) && (EINTR == errno));
+
+    return (0 != rv) ? ATCA_GEN_FAIL : ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_post_semaphore(void * pSem)
+{
+    if (NULL == pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    return (0 != sem_post((sem_t*)pSem)) ? ATCA_GEN_FAIL : ATCA_SUCCESS;
+}
+
 /** \brief Check if the pid exists in the system
  */
 ATCA_STATUS hal_check_pid(hal_pid_t pid)
@@ -162,6 +162,64 @@ ATCA_STATUS hal_unlock_mutex(void* pMutex)
     return rv;
 }
 
+/**
+ * \brief Create a semaphore that starts taken, for one thread to wait on
+ * until another posts it
+ * \param[IN/OUT] ppSem location to receive ptr to the semaphore
+ */
+ATCA_STATUS hal_create_semaphore(void** ppSem)
+{
+    if (NULL == ppSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    *ppSem = CreateSemaphore(NULL, 0, 1, NULL);
+
+    if (NULL == *ppSem)
+    {
+        return ATCA_GEN_FAIL;
+    }
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_destroy_semaphore(void* pSem)
+{
+    if (NULL == pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    (void)CloseHandle(pSem);
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_wait_semaphore(void* pSem)
+{
+    if (NULL == pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    /* coverity[misra_c_2012_rule_10_4_violation:SUPPRESS] Win32 API */
+    return (WAIT_OBJECT_0 == WaitForSingleObject((HANDLE)pSem, INFINITE)) ? ATCA_SUCCESS : ATCA_GEN_FAIL;
+}
+
+ATCA_STATUS hal_post_semaphore(void* pSem)
+{
+    if (NULL == pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    /* Posting a semaphore that is already posted fails but leaves it posted */
+    (void)ReleaseSemaphore((HANDLE)pSem, 1, NULL);
+
+    return ATCA_SUCCESS;
+}
+
 /** \brief Check if the pid exists in the system
  */
 ATCA_STATUS hal_check_pid(hal_pid_t pid)
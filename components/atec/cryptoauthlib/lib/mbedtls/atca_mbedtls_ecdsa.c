@@ -154,6 +154,7 @@ int mbedtls_ecdsa_verify(mbedtls_ecp_group *grp,
 
         if (!ret)
         {
+            /* Goes to the host or the device as atcab_set_verify_policy selects */
             ret = atcab_verify_extern(buf, raw_sig, public_key, &verified);
 
             if (!ret && !verified)
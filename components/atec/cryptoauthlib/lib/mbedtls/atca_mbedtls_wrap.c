@@ -1207,6 +1207,196 @@ ATCA_STATUS atcac_pk_derive(
     return status;
 }
 
+#if ATCAB_VERIFY_EXTERN_HOST_EN
+/** \brief Verify an ECDSA signature entirely in software (SEC1 4.1.4) using
+ *          the mbedTLS ECP primitives. This deliberately avoids
+ *          mbedtls_ecdsa_verify which may be routed back to the device by
+ *          MBEDTLS_ECDSA_VERIFY_ALT.
+ *
+ * \return 0 on success, MBEDTLS_ERR_ECP_VERIFY_FAILED if the signature does
+ *         not match, otherwise an mbedTLS error code.
+ */
+static int atca_mbedtls_ecdsa_verify_host(
+    mbedtls_ecp_group*       grp,
+    const unsigned char*     buf,
+    size_t                   blen,
+    const mbedtls_ecp_point* Q,
+    const mbedtls_mpi*       r,
+    const mbedtls_mpi*       s
+    )
+{
+    int ret = MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+
+    if ((NULL != grp) && (NULL != buf) && (NULL != Q) && (NULL != r) && (NULL != s))
+    {
+        mbedtls_mpi e, s_inv, u1, u2;
+        mbedtls_ecp_point R;
+        size_t n_size = (grp->nbits + 7u) / 8u;
+        size_t use_size = (blen > n_size) ? n_size : blen;
+
+        mbedtls_ecp_point_init(&R);
+        mbedtls_mpi_init(&e);
+        mbedtls_mpi_init(&s_inv);
+        mbedtls_mpi_init(&u1);
+        mbedtls_mpi_init(&u2);
+
+        /* r and s must be in [1, n-1] */
+        if ((mbedtls_mpi_cmp_int(r, 1) < 0) || (mbedtls_mpi_cmp_mpi(r, &grp->N) >= 0) ||
+            (mbedtls_mpi_cmp_int(s, 1) < 0) || (mbedtls_mpi_cmp_mpi(s, &grp->N) >= 0))
+        {
+            ret = MBEDTLS_ERR_ECP_VERIFY_FAILED;
+        }
+        else
+        {
+            ret = mbedtls_ecp_check_pubkey(grp, Q);
+        }
+
+        /* Derive e from the digest, truncated to the bit length of n */
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_read_binary(&e, buf, use_size);
+        }
+        if ((0 == ret) && (use_size * 8u > grp->nbits))
+        {
+            ret = mbedtls_mpi_shift_r(&e, use_size * 8u - grp->nbits);
+        }
+        if ((0 == ret) && (mbedtls_mpi_cmp_mpi(&e, &grp->N) >= 0))
+        {
+            ret = mbedtls_mpi_sub_mpi(&e, &e, &grp->N);
+        }
+
+        /* u1 = e / s mod n, u2 = r / s mod n */
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_inv_mod(&s_inv, s, &grp->N);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_mul_mpi(&u1, &e, &s_inv);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_mod_mpi(&u1, &u1, &grp->N);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_mul_mpi(&u2, r, &s_inv);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_mod_mpi(&u2, &u2, &grp->N);
+        }
+
+        /* R = u1 G + u2 Q */
+        if (0 == ret)
+        {
+            ret = mbedtls_ecp_muladd(grp, &R, &u1, &grp->G, &u2, Q);
+        }
+        if ((0 == ret) && (0 != mbedtls_ecp_is_zero(&R)))
+        {
+            ret = MBEDTLS_ERR_ECP_VERIFY_FAILED;
+        }
+
+        /* Signature is valid if R.x mod n == r */
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_mod_mpi(&R.X, &R.X, &grp->N);
+        }
+        if ((0 == ret) && (0 != mbedtls_mpi_cmp_mpi(&R.X, r)))
+        {
+            ret = MBEDTLS_ERR_ECP_VERIFY_FAILED;
+        }
+
+        mbedtls_ecp_point_free(&R);
+        mbedtls_mpi_free(&e);
+        mbedtls_mpi_free(&s_inv);
+        mbedtls_mpi_free(&u1);
+        mbedtls_mpi_free(&u2);
+    }
+
+    return ret;
+}
+
+/** \brief Verify a P256 ECDSA signature with a supplied public key on the
+ *          host. Same arguments and results as atcab_verify_extern.
+ *
+ * \return ATCA_SUCCESS on verification success or failure, otherwise an
+ *         error code.
+ */
+ATCA_STATUS atcac_sw_ecdsa_verify_p256(
+    const uint8_t* digest,
+    const uint8_t* signature,
+    const uint8_t* public_key,
+    bool*          is_verified
+    )
+{
+    ATCA_STATUS status = ATCA_BAD_PARAM;
+
+    if ((NULL != digest) && (NULL != signature) && (NULL != public_key) && (NULL != is_verified))
+    {
+        mbedtls_ecp_group grp;
+        mbedtls_ecp_point Q;
+        mbedtls_mpi r, s;
+        int ret;
+
+        mbedtls_ecp_group_init(&grp);
+        mbedtls_ecp_point_init(&Q);
+        mbedtls_mpi_init(&r);
+        mbedtls_mpi_init(&s);
+
+        *is_verified = false;
+
+        ret = mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256R1);
+
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_read_binary(&Q.X, public_key, ATCA_ECCP256_PUBKEY_SIZE / 2u);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_read_binary(&Q.Y, &public_key[ATCA_ECCP256_PUBKEY_SIZE / 2u], ATCA_ECCP256_PUBKEY_SIZE / 2u);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_lset(&Q.Z, 1);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_read_binary(&r, signature, ATCA_ECCP256_SIG_SIZE / 2u);
+        }
+        if (0 == ret)
+        {
+            ret = mbedtls_mpi_read_binary(&s, &signature[ATCA_ECCP256_SIG_SIZE / 2u], ATCA_ECCP256_SIG_SIZE / 2u);
+        }
+        if (0 == ret)
+        {
+            ret = atca_mbedtls_ecdsa_verify_host(&grp, digest, ATCA_SHA256_DIGEST_SIZE, &Q, &r, &s);
+        }
+
+        if (0 == ret)
+        {
+            *is_verified = true;
+            status = ATCA_SUCCESS;
+        }
+        else if ((MBEDTLS_ERR_ECP_VERIFY_FAILED == ret) || (MBEDTLS_ERR_ECP_INVALID_KEY == ret))
+        {
+            /* Matches the device - a bad signature or key is not an error */
+            status = ATCA_SUCCESS;
+        }
+        else
+        {
+            status = ATCA_FUNC_FAIL;
+        }
+
+        mbedtls_ecp_group_free(&grp);
+        mbedtls_ecp_point_free(&Q);
+        mbedtls_mpi_free(&r);
+        mbedtls_mpi_free(&s);
+    }
+
+    return status;
+}
+#endif /* ATCAB_VERIFY_EXTERN_HOST_EN */
 
 #ifndef MBEDTLS_ECDSA_SIGN_ALT
 #include "pk_internal.h"
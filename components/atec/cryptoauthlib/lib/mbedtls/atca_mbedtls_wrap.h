@@ -132,6 +132,7 @@ typedef struct atcac_pk_ctx
 #include "atca_device.h"
 
 #include "mbedtls/bignum.h"
+#include "mbedtls/ecp.h"
 
 #ifdef __cplusplus
 extern "C" {
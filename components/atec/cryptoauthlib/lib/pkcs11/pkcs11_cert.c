@@ -41,6 +41,7 @@
 #include "pkcs11_os.h"
 #include "pkcs11_util.h"
 #include "pkcs11_slot.h"
+#include "pkcs11_key.h"
 
 /**
  * \defgroup pkcs11 Key (pkcs11_key_)
@@ -165,7 +165,11 @@ static const pkcs11_attrib_model *pkcs11_find_attrib_match(pkcs11_object_ptr pOb
         }
 
         /* Search criteria has a value to we must match it */
-        if (NULL != pTemplate->pValue && NULL != pAttribute->func)
+        if (TRUE == pkcs11_object_index_match(pObject, pAttribute, pTemplate, &found))
+        {
+            /* Answered from the object index without touching the device */
+        }
+        else if (NULL != pTemplate->pValue && NULL != pAttribute->func)
         {
             CK_ATTRIBUTE temp = { 0 };
 #ifdef ATCA_NO_HEAP
@@ -178,7 +182,7 @@ static const pkcs11_attrib_model *pkcs11_find_attrib_match(pkcs11_object_ptr pOb
 #endif
 
             /* Get the attribute */
-            if (CKR_OK == pAttribute->func(pObject, &temp, pSession))
+            if (CKR_OK == pkcs11_object_get_attribute(pObject, pAttribute, &temp, pSession))
             {
                 if ((temp.ulValueLen == pTemplate->ulValueLen) && (NULL != temp.pValue))
                 {
@@ -214,48 +218,63 @@ static const pkcs11_attrib_model *pkcs11_find_attrib_match(pkcs11_object_ptr pOb
     return NULL;
 }
 
+/** Match every template entry - attributes the object index answers are
+   compared first so a class, label or cached id mismatch never reaches the device */
+static CK_BBOOL pkcs11_find_template_match(pkcs11_object_ptr pObject, const CK_ATTRIBUTE_PTR pTemplate, CK_ULONG ulCount,
+                                           pkcs11_session_ctx_ptr pSession)
+{
+    CK_ULONG pass;
+    CK_ULONG j;
+
+    for (pass = 0; pass < 2u; pass++)
+    {
+        for (j = 0; j < ulCount; j++)
+        {
+            const pkcs11_attrib_model *pAttribute = pkcs11_find_attrib(pObject->attributes, pObject->count, &pTemplate[j]);
+            CK_BBOOL indexed = pkcs11_object_index_cached(pObject, pAttribute);
+
+            if (((0u == pass) && (TRUE == indexed)) || ((0u != pass) && (TRUE != indexed)))
+            {
+                if (NULL == pkcs11_find_attrib_match(pObject, pObject->attributes, pObject->count, &pTemplate[j], pSession))
+                {
+                    return FALSE;
+                }
+            }
+        }
+    }
+
+    return TRUE;
+}
+
 static CK_OBJECT_HANDLE pkcs11_find_handle(const CK_SLOT_ID slotid, const CK_ATTRIBUTE_PTR pTemplate, CK_ULONG ulCount, CK_ULONG_PTR index,
                                            pkcs11_session_ctx_ptr pSession)
 {
     CK_ULONG i;
-    CK_ULONG j;
     CK_OBJECT_HANDLE rv = NULL_PTR;
 
-    /* Finds the first or next match - Iterate through objects */
-    for (i = (NULL != index) ? *index : 0u; i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i++)
+    /* Finds the first or next match - Iterate through the objects of the slot */
+    for (i = pkcs11_object_slot_next(slotid, (NULL != index) ? *index : 0u); i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED;
+         i = pkcs11_object_slot_next(slotid, i + 1u))
     {
         pkcs11_object_ptr pObject = pkcs11_object_cache[i].object;
-        if (NULL != pObject && slotid == pkcs11_object_cache[i].slotid)
+        if (NULL != pObject && TRUE == pkcs11_find_template_match(pObject, pTemplate, ulCount, pSession))
         {
-            /* Iterate through attribute list */
-            for (j = 0; j < ulCount; j++)
+            /* Full match */
+            if (ulCount != 0u)
             {
-                /* See if a match failed */
-                if (NULL == pkcs11_find_attrib_match(pObject, pObject->attributes,
-                                                     pObject->count, &pTemplate[j], pSession))
-                {
-                    break;
-                }
+                rv = pkcs11_object_cache[i].handle;
+                break;
             }
-            if (j == ulCount)
+            else if ((CKO_HW_FEATURE != pObject->class_id) && (CKO_MECHANISM != pObject->class_id))
             {
-                /* Full match */
-                if (ulCount != 0u)
-                {
-                    rv = pkcs11_object_cache[i].handle;
-                    break;
-                }
-                else if ((CKO_HW_FEATURE != pObject->class_id) && (CKO_MECHANISM != pObject->class_id))
-                {
-                    /* Special condition where ulCount is zero we match all
-                       objects except HW Features and Mechanisms */
-                    rv = pkcs11_object_cache[i].handle;
-                    break;
-                }
-                else
-                {
-                    /* do nothing */
-                }
+                /* Special condition where ulCount is zero we match all
+                   objects except HW Features and Mechanisms */
+                rv = pkcs11_object_cache[i].handle;
+                break;
+            }
+            else
+            {
+                /* do nothing */
             }
         }
     }
@@ -473,13 +492,30 @@ CK_RV pkcs11_find_get_attribute(CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hOb
                 rv = CKR_ATTRIBUTE_TYPE_INVALID;
             }
         }
+        else if (TRUE == pkcs11_object_index_cached(pObject, pAttribute))
+        {
+            /* Host-only attribute - does not need to queue for the device */
+            if (CKR_OK == pkcs11_lock_context(pLibCtx))
+            {
+                rv = pkcs11_object_get_attribute(pObject, pAttribute, &pTemplate[i], pSession);
+                (void)pkcs11_unlock_context(pLibCtx);
+            }
+            else if (CKR_OK == rv)
+            {
+                rv = CKR_GENERAL_ERROR;
+            }
+            else
+            {
+                /* Do Nothing */
+            }
+        }
         else if (NULL != pAttribute->func)
         {
             /* coverity[cert_con39_c_violation:FALSE] pkcs11_lock_both does not retain a lock for any return code other than CKR_OK */
             if (CKR_OK == pkcs11_lock_both(pLibCtx))
             {
                 /* Attribute function found so try to execute it */
-                CK_RV temp = pAttribute->func(pObject, &pTemplate[i], pSession);
+                CK_RV temp = pkcs11_object_get_attribute(pObject, pAttribute, &pTemplate[i], pSession);
                 rv = temp;
                 (void)pkcs11_unlock_both(pLibCtx);
             }
@@ -143,7 +143,8 @@ CK_RV pkcs11_unlock_context(pkcs11_lib_ctx_ptr pContext)
     return rv;
 }
 
-CK_RV pkcs11_lock_device(pkcs11_lib_ctx_ptr pContext)
+/* Interprocess device lock for shared memory platforms */
+static CK_RV pkcs11_lock_device_os(pkcs11_lib_ctx_ptr pContext)
 {
     CK_RV rv = CKR_OK;
 
@@ -158,12 +159,14 @@ CK_RV pkcs11_lock_device(pkcs11_lib_ctx_ptr pContext)
             }
         }
     }
+#else
+    ((void)pContext);
 #endif
 
     return rv;
 }
 
-CK_RV pkcs11_unlock_device(pkcs11_lib_ctx_ptr pContext)
+static CK_RV pkcs11_unlock_device_os(pkcs11_lib_ctx_ptr pContext)
 {
     CK_RV rv = CKR_OK;
 
@@ -183,11 +186,145 @@ CK_RV pkcs11_unlock_device(pkcs11_lib_ctx_ptr pContext)
             }
         }
     }
+#else
+    ((void)pContext);
  #endif
 
     return rv;
 }
 
+CK_RV pkcs11_lock_device(pkcs11_lib_ctx_ptr pContext)
+{
+    CK_RV rv;
+
+    if (CKR_OK == (rv = pkcs11_sched_acquire(pContext, NULL)))
+    {
+        if (CKR_OK != (rv = pkcs11_lock_device_os(pContext)))
+        {
+            (void)pkcs11_sched_release(pContext, NULL);
+        }
+    }
+
+    return rv;
+}
+
+CK_RV pkcs11_unlock_device(pkcs11_lib_ctx_ptr pContext)
+{
+    CK_RV rv1 = pkcs11_unlock_device_os(pContext);
+    CK_RV rv2 = pkcs11_sched_release(pContext, NULL);
+
+    return CKR_OK != rv1 ? rv1 : rv2;
+}
+
+/* The context lock can only be handed off when it is not also the device lock */
+static CK_BBOOL pkcs11_lock_can_handoff(pkcs11_lib_ctx_ptr pContext)
+{
+    return ((NULL != pContext) && (NULL != pContext->lib_lock)) ? TRUE : FALSE;
+}
+
+/**
+ * \brief Queue for the device on behalf of a session. Must be called with the
+ * context lock held. The context lock is released while the request waits
+ * and while the device is held, so host-only work from other sessions is not
+ * serialized behind device commands.
+ *
+ * Another thread may close the session or destroy the key meanwhile, so
+ * everything the device operation needs (device, key slot, public key) has to
+ * be copied to locals before this call and the session and key pointers must
+ * not be used until pkcs11_unlock_device_ext has checked them again.
+ */
+CK_RV pkcs11_lock_device_ext(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket)
+{
+    CK_BBOOL handoff;
+    CK_RV rv = CKR_OK;
+
+    if (NULL == pTicket)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if (NULL == pContext)
+    {
+        pContext = pkcs11_get_context();
+    }
+
+    handoff = pkcs11_lock_can_handoff(pContext);
+
+    if (TRUE == handoff)
+    {
+        rv = pkcs11_unlock_context(pContext);
+    }
+
+    if (CKR_OK == rv)
+    {
+        if (CKR_OK == (rv = pkcs11_sched_acquire(pContext, pTicket)))
+        {
+            if (CKR_OK != (rv = pkcs11_lock_device_os(pContext)))
+            {
+                (void)pkcs11_sched_release(pContext, pTicket);
+            }
+        }
+
+        if ((CKR_OK != rv) && (TRUE == handoff))
+        {
+            /* Give the caller back the lock it came in with */
+            (void)pkcs11_lock_context(pContext);
+        }
+    }
+
+    return rv;
+}
+
+/**
+ * \brief Release the device acquired with pkcs11_lock_device_ext, retake the
+ * context lock and check that the session and the object of the ticket still
+ * exist.
+ *
+ * \param[in] result Result of the device operation
+ * \return result, or CKR_SESSION_HANDLE_INVALID / CKR_OBJECT_HANDLE_INVALID
+ * when the session was closed or the object destroyed while the context lock
+ * was released. The caller must look its session and object up again from
+ * their handles before using them.
+ */
+CK_RV pkcs11_unlock_device_ext(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket, CK_RV result)
+{
+    pkcs11_session_ctx_ptr pSession = NULL;
+    CK_RV rv;
+
+    if (NULL == pContext)
+    {
+        pContext = pkcs11_get_context();
+    }
+
+    (void)pkcs11_unlock_device_os(pContext);
+    (void)pkcs11_sched_release(pContext, pTicket);
+
+    if (TRUE == pkcs11_lock_can_handoff(pContext))
+    {
+        if (CKR_OK != (rv = pkcs11_lock_context(pContext)))
+        {
+            return rv;
+        }
+    }
+
+    if (CKR_OK != pkcs11_session_check(&pSession, pTicket->session))
+    {
+        rv = CKR_SESSION_HANDLE_INVALID;
+    }
+    else if ((0u != pTicket->object) && (CKR_OK != pkcs11_object_check(NULL, pTicket->object)))
+    {
+        (void)pkcs11_sched_account(pContext, pSession, pTicket);
+        rv = CKR_OBJECT_HANDLE_INVALID;
+    }
+    else
+    {
+        (void)pkcs11_sched_account(pContext, pSession, pTicket);
+        rv = result;
+    }
+
+    return rv;
+}
+
 CK_RV pkcs11_lock_both(pkcs11_lib_ctx_ptr pContext)
 {
     CK_RV rv = CKR_OK;
@@ -383,6 +520,13 @@ CK_RV pkcs11_init(CK_C_INITIALIZE_ARGS const *pInitArgs)
         /* Save off the arguments passed to the library from the application for future access */
         (void)memcpy(&lib_ctx->init_args, pInitArgs, sizeof(CK_C_INITIALIZE_ARGS));
 
+        /* Device requests from all sessions are queued through the scheduler */
+        if (CKR_OK != (rv = pkcs11_sched_init(lib_ctx)))
+        {
+            (void)pkcs11_unlock_context(lib_ctx);
+            return rv;
+        }
+
         /* Initialize the Crypto device */
         lib_ctx->slots = pkcs11_slot_initslots(PKCS11_MAX_SLOTS_ALLOWED);
         if (NULL != lib_ctx->slots)
@@ -417,6 +561,11 @@ CK_RV pkcs11_init(CK_C_INITIALIZE_ARGS const *pInitArgs)
             /*If initialize successful set to true*/
             lib_ctx->initialized = TRUE;
         }
+        else
+        {
+            /* Nothing can be queued yet - just free the lock and semaphores */
+            (void)pkcs11_sched_deinit(lib_ctx);
+        }
 
         (void)pkcs11_unlock_context(lib_ctx);
     }
@@ -503,9 +652,10 @@ CK_RV pkcs11_deinit(CK_VOID_PTR pReserved)
         /* Free allocated memory for all slots */
         (void)pkcs11_slot_deinitslots(lib_ctx);
 
-        /** \todo If other threads are waiting for something to happen this call should
-           cause those calls to unblock and return CKR_CRYPTOKI_NOT_INITIALIZED - How
-           that is done by this simplified mutex API is yet to be determined */
+        /* Sessions still queued for the device return CKR_CRYPTOKI_NOT_INITIALIZED;
+           this waits for them, and for a request still holding the device, to
+           leave the scheduler before its semaphores are destroyed */
+        (void)pkcs11_sched_deinit(lib_ctx);
 
         /* the library is now closing */
         (void)pkcs11_unlock_context(lib_ctx);
@@ -31,6 +31,7 @@
 #include "atca_compiler.h"
 #include "pkcs11_config.h"
 #include "pkcs11_os.h"
+#include "pkcs11_sched.h"
 #include "cryptoauthlib.h"
 
 #ifdef __cplusplus
@@ -112,6 +113,9 @@ CK_RV pkcs11_unlock_context(pkcs11_lib_ctx_ptr pContext);
 CK_RV pkcs11_lock_device(pkcs11_lib_ctx_ptr pContext);
 CK_RV pkcs11_unlock_device(pkcs11_lib_ctx_ptr pContext);
 
+CK_RV pkcs11_lock_device_ext(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket);
+CK_RV pkcs11_unlock_device_ext(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket, CK_RV result);
+
 CK_RV pkcs11_lock_both(pkcs11_lib_ctx_ptr pContext);
 CK_RV pkcs11_unlock_both(pkcs11_lib_ctx_ptr pContext);
 
@@ -63,6 +63,253 @@ static CK_OBJECT_HANDLE pkcs11_object_alloc_handle(void)
     return pkcs11_object_last_handle;
 }
 
+/** Handle to cache index hash table. Entries hold the cache index plus one so
+   that zero marks an empty bucket. Collisions are resolved by linear probing */
+static uint16_t pkcs11_object_handle_table[PKCS11_OBJECT_HANDLE_TABLE_SIZE];
+
+static CK_ULONG pkcs11_object_handle_hash(CK_OBJECT_HANDLE hObject)
+{
+    return (CK_ULONG)(hObject % (CK_OBJECT_HANDLE)PKCS11_OBJECT_HANDLE_TABLE_SIZE);
+}
+
+static void pkcs11_object_handle_insert(CK_OBJECT_HANDLE hObject, CK_ULONG index)
+{
+    CK_ULONG pos = pkcs11_object_handle_hash(hObject);
+    CK_ULONG i;
+
+    for (i = 0; i < (CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE; i++)
+    {
+        if (0u == pkcs11_object_handle_table[pos])
+        {
+            pkcs11_object_handle_table[pos] = (uint16_t)(index + 1u);
+            break;
+        }
+        pos = (pos + 1u) % (CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE;
+    }
+}
+
+/** Returns the table bucket holding the handle or PKCS11_OBJECT_HANDLE_TABLE_SIZE */
+static CK_ULONG pkcs11_object_handle_bucket(CK_OBJECT_HANDLE hObject)
+{
+    CK_ULONG pos = pkcs11_object_handle_hash(hObject);
+    CK_ULONG i;
+
+    for (i = 0; i < (CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE; i++)
+    {
+        uint16_t entry = pkcs11_object_handle_table[pos];
+
+        if (0u == entry)
+        {
+            break;
+        }
+        else if (hObject == pkcs11_object_cache[entry - 1u].handle)
+        {
+            return pos;
+        }
+        else
+        {
+            pos = (pos + 1u) % (CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE;
+        }
+    }
+
+    return (CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE;
+}
+
+/** Removes a handle and shifts the rest of its probe chain back so lookups
+   never need tombstones */
+static void pkcs11_object_handle_remove(CK_OBJECT_HANDLE hObject)
+{
+    CK_ULONG hole = pkcs11_object_handle_bucket(hObject);
+    CK_ULONG next;
+
+    if ((CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE == hole)
+    {
+        return;
+    }
+
+    pkcs11_object_handle_table[hole] = 0;
+    next = hole;
+
+    for (;;)
+    {
+        CK_ULONG home;
+        CK_BBOOL move;
+
+        next = (next + 1u) % (CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE;
+        if (0u == pkcs11_object_handle_table[next])
+        {
+            break;
+        }
+
+        home = pkcs11_object_handle_hash(pkcs11_object_cache[pkcs11_object_handle_table[next] - 1u].handle);
+
+        /* The entry may fill the hole unless its home bucket lies cyclically in (hole, next] */
+        if (hole < next)
+        {
+            move = ((home <= hole) || (home > next)) ? TRUE : FALSE;
+        }
+        else
+        {
+            move = ((home <= hole) && (home > next)) ? TRUE : FALSE;
+        }
+
+        if (TRUE == move)
+        {
+            pkcs11_object_handle_table[hole] = pkcs11_object_handle_table[next];
+            pkcs11_object_handle_table[next] = 0;
+            hole = next;
+        }
+    }
+}
+
+/** Find the cache entry of an object - uses the index stored in the object and
+   falls back to a scan if it is stale */
+static CK_ULONG pkcs11_object_cache_index(const pkcs11_object_ptr pObject)
+{
+    CK_ULONG i;
+
+    if (NULL == pObject)
+    {
+        return (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED;
+    }
+
+    if ((pObject->cache_index < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED) &&
+        (pObject == pkcs11_object_cache[pObject->cache_index].object))
+    {
+        return pObject->cache_index;
+    }
+
+    for (i = 0; i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i++)
+    {
+        if (pObject == pkcs11_object_cache[i].object)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/** Per slot index - the objects of each slot are chained through the cache
+   entries in ascending cache order so searches only visit the slot's objects */
+typedef struct pkcs11_object_slot_index_s
+{
+    CK_SLOT_ID slotid;
+    /** First object of the slot - cache index plus one, zero marks a free entry */
+    uint16_t head;
+} pkcs11_object_slot_index_t;
+
+static pkcs11_object_slot_index_t pkcs11_object_slot_index[PKCS11_MAX_SLOTS_ALLOWED];
+
+static pkcs11_object_slot_index_t * pkcs11_object_slot_find(CK_SLOT_ID slotId, CK_BBOOL create)
+{
+    pkcs11_object_slot_index_t * pFree = NULL;
+    CK_ULONG i;
+
+    for (i = 0; i < (CK_ULONG)PKCS11_MAX_SLOTS_ALLOWED; i++)
+    {
+        if (0u == pkcs11_object_slot_index[i].head)
+        {
+            if (NULL == pFree)
+            {
+                pFree = &pkcs11_object_slot_index[i];
+            }
+        }
+        else if (slotId == pkcs11_object_slot_index[i].slotid)
+        {
+            return &pkcs11_object_slot_index[i];
+        }
+        else
+        {
+            /* do nothing */
+        }
+    }
+
+    if ((TRUE == create) && (NULL != pFree))
+    {
+        pFree->slotid = slotId;
+        return pFree;
+    }
+
+    return NULL;
+}
+
+static CK_RV pkcs11_object_slot_insert(CK_SLOT_ID slotId, CK_ULONG index)
+{
+    pkcs11_object_slot_index_t * pEntry = pkcs11_object_slot_find(slotId, TRUE);
+    uint16_t * pLink;
+
+    if (NULL == pEntry)
+    {
+        return CKR_HOST_MEMORY;
+    }
+
+    pLink = &pEntry->head;
+    while ((0u != *pLink) && ((CK_ULONG)(*pLink - 1u) < index))
+    {
+        pLink = &pkcs11_object_cache[*pLink - 1u].next;
+    }
+
+    pkcs11_object_cache[index].next = *pLink;
+    *pLink = (uint16_t)(index + 1u);
+
+    return CKR_OK;
+}
+
+static void pkcs11_object_slot_remove(CK_ULONG index)
+{
+    pkcs11_object_slot_index_t * pEntry = pkcs11_object_slot_find(pkcs11_object_cache[index].slotid, FALSE);
+    uint16_t * pLink;
+
+    if (NULL == pEntry)
+    {
+        return;
+    }
+
+    pLink = &pEntry->head;
+    while ((0u != *pLink) && ((CK_ULONG)(*pLink - 1u) != index))
+    {
+        pLink = &pkcs11_object_cache[*pLink - 1u].next;
+    }
+
+    if (0u != *pLink)
+    {
+        *pLink = pkcs11_object_cache[index].next;
+    }
+}
+
+/**
+ * \brief Cache index of the first object owned by the slot at or after index
+ *
+ * Stepping from the previous result (index = last + 1) follows its chain link
+ * directly.
+ *
+ * \return The cache index or PKCS11_MAX_OBJECTS_ALLOWED when there is none
+ */
+CK_ULONG pkcs11_object_slot_next(CK_SLOT_ID slotId, CK_ULONG index)
+{
+    pkcs11_object_slot_index_t * pEntry;
+    uint16_t next;
+
+    if ((0u < index) && (index <= (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED) &&
+        (NULL != pkcs11_object_cache[index - 1u].object) && (slotId == pkcs11_object_cache[index - 1u].slotid))
+    {
+        next = pkcs11_object_cache[index - 1u].next;
+    }
+    else
+    {
+        pEntry = pkcs11_object_slot_find(slotId, FALSE);
+        next = (NULL != pEntry) ? pEntry->head : 0u;
+
+        while ((0u != next) && ((CK_ULONG)(next - 1u) < index))
+        {
+            next = pkcs11_object_cache[next - 1u].next;
+        }
+    }
+
+    return (0u != next) ? (CK_ULONG)(next - 1u) : (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED;
+}
+
 /**
  * CKA_CLASS == CKO_HW_FEATURE_TYPE
  * CKA_HW_FEATURE_TYPE == CKH_MONOTONIC_COUNTER
@@ -146,16 +393,26 @@ CK_RV pkcs11_object_alloc(CK_SLOT_ID slotId, pkcs11_object_ptr *ppObject)
 #else
                 *ppObject = pkcs11_os_malloc(sizeof(pkcs11_object));
 #endif
-                if (NULL != *ppObject)
+                if (NULL == *ppObject)
+                {
+                    rv = CKR_HOST_MEMORY;
+                }
+                else if (CKR_OK != (rv = pkcs11_object_slot_insert(slotId, i)))
+                {
+#ifdef ATCA_HEAP
+                    pkcs11_os_free(*ppObject);
+#endif
+                    *ppObject = NULL;
+                }
+                else
                 {
                     (void)memset(*ppObject, 0, sizeof(pkcs11_object));
+                    (*ppObject)->cache_index = i;
                     pkcs11_object_cache[i].handle = pkcs11_object_alloc_handle();
                     pkcs11_object_cache[i].slotid = slotId;
                     pkcs11_object_cache[i].object = *ppObject;
-                }
-                else
-                {
-                    rv = CKR_HOST_MEMORY;
+                    pkcs11_object_cache[i].id_cached = FALSE;
+                    pkcs11_object_handle_insert(pkcs11_object_cache[i].handle, i);
                 }
 
                 break;
@@ -177,16 +434,14 @@ CK_RV pkcs11_object_alloc(CK_SLOT_ID slotId, pkcs11_object_ptr *ppObject)
 
 CK_RV pkcs11_object_free(pkcs11_object_ptr pObject)
 {
-    CK_ULONG i;
+    CK_ULONG i = pkcs11_object_cache_index(pObject);
 
-    for (i = 0; i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i++)
+    if (i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED)
     {
-        if (pObject == pkcs11_object_cache[i].object)
-        {
-            /* Delink it */
-            pkcs11_object_cache[i].object = NULL;
-            pkcs11_object_cache[i].handle = 0;
-        }
+        /* Delink it */
+        pkcs11_object_handle_remove(pkcs11_object_cache[i].handle);
+        pkcs11_object_slot_remove(i);
+        (void)pkcs11_util_memset(&pkcs11_object_cache[i], sizeof(pkcs11_object_cache_t), 0, sizeof(pkcs11_object_cache_t));
     }
 
     if (NULL != pObject)
@@ -228,20 +483,15 @@ CK_RV pkcs11_object_check(pkcs11_object_ptr *ppObject, CK_OBJECT_HANDLE hObject)
         return CKR_OBJECT_HANDLE_INVALID;
     }
 
-    for (i = 0; i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i++)
-    {
-        if (hObject == pkcs11_object_cache[i].handle)
-        {
-            break;
-        }
-    }
-    if (i == (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED)
+    i = pkcs11_object_handle_bucket(hObject);
+
+    if (i == (CK_ULONG)PKCS11_OBJECT_HANDLE_TABLE_SIZE)
     {
         return CKR_OBJECT_HANDLE_INVALID;
     }
     else if (NULL != ppObject)
     {
-        *ppObject = pkcs11_object_cache[i].object;
+        *ppObject = pkcs11_object_cache[pkcs11_object_handle_table[i] - 1u].object;
     }
     else
     {
@@ -260,19 +510,15 @@ CK_RV pkcs11_object_get_handle(pkcs11_object_ptr pObject, CK_OBJECT_HANDLE_PTR p
         return CKR_ARGUMENTS_BAD;
     }
 
-    for (i = 0; i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i++)
-    {
-        if (pObject == pkcs11_object_cache[i].object)
-        {
-            *phObject = pkcs11_object_cache[i].handle;
-            break;
-        }
-    }
+    i = pkcs11_object_cache_index(pObject);
+
     if (i == (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED)
     {
         return CKR_OBJECT_HANDLE_INVALID;
     }
 
+    *phObject = pkcs11_object_cache[i].handle;
+
     return CKR_OK;
 }
 
@@ -282,26 +528,173 @@ CK_RV pkcs11_object_get_owner(pkcs11_object_ptr pObject, CK_SLOT_ID_PTR pSlotId)
 
     if (NULL != pObject && NULL != pSlotId)
     {
-        CK_ULONG i;
-        for (i = 0; i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i++)
+        CK_ULONG i = pkcs11_object_cache_index(pObject);
+
+        if ((CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED == i)
+        {
+            rv = CKR_OBJECT_HANDLE_INVALID;
+        }
+        else
+        {
+            *pSlotId = pkcs11_object_cache[i].slotid;
+            rv = CKR_OK;
+        }
+    }
+
+    return rv;
+}
+
+/** Attribute values of an object may be cached once the device can no longer
+   change them - the data zone and the object's key slot are both locked */
+static CK_BBOOL pkcs11_object_is_locked(const pkcs11_object_ptr pObject)
+{
+    CK_BBOOL locked = FALSE;
+
+#if ATCA_CA_SUPPORT
+    const atecc608_config_t * cfg_zone = (const atecc608_config_t *)pObject->config;
+
+    if ((NULL != cfg_zone) && (pObject->slot < 16u))
+    {
+        if ((ATCA_UNLOCKED != cfg_zone->LockValue) &&
+            (0u == (cfg_zone->SlotLocked & (1u << pObject->slot))))
+        {
+            locked = TRUE;
+        }
+    }
+#else
+    ((void)pObject);
+#endif
+
+    return locked;
+}
+
+/**
+ * \brief Try to match a search attribute against the object index without
+ * calling the attribute function
+ *
+ * CKA_CLASS and CKA_LABEL are compared against the object fields directly and
+ * CKA_ID is compared against the cached value when one is available.
+ *
+ * \return TRUE if the index answered the query and pMatch holds the result
+ */
+CK_BBOOL pkcs11_object_index_match(pkcs11_object_ptr pObject, const pkcs11_attrib_model * pAttribute, const CK_ATTRIBUTE_PTR pTemplate, CK_BBOOL * pMatch)
+{
+    CK_BBOOL indexed = FALSE;
+
+    if (NULL == pObject || NULL == pAttribute || NULL == pTemplate || NULL == pTemplate->pValue || NULL == pMatch)
+    {
+        return FALSE;
+    }
+
+    *pMatch = FALSE;
+
+    if (pkcs11_object_get_class == pAttribute->func)
+    {
+        indexed = TRUE;
+        if (sizeof(pObject->class_id) == pTemplate->ulValueLen)
+        {
+            /* coverity[misra_c_2012_rule_21_16_violation:FALSE] CK_VOID_PTR is a pointer type */
+            *pMatch = (0 == memcmp(&pObject->class_id, pTemplate->pValue, pTemplate->ulValueLen)) ? TRUE : FALSE;
+        }
+    }
+    else if (pkcs11_object_get_name == pAttribute->func)
+    {
+        indexed = TRUE;
+        if (strlen((char*)pObject->name) == pTemplate->ulValueLen)
         {
-            if (pObject == pkcs11_object_cache[i].object)
+            /* coverity[misra_c_2012_rule_21_16_violation:FALSE] CK_VOID_PTR is a pointer type */
+            *pMatch = (0 == memcmp(pObject->name, pTemplate->pValue, pTemplate->ulValueLen)) ? TRUE : FALSE;
+        }
+    }
+    else if (CKA_ID == pAttribute->type)
+    {
+        CK_ULONG i = pkcs11_object_cache_index(pObject);
+
+        if ((i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED) && (TRUE == pkcs11_object_cache[i].id_cached))
+        {
+            indexed = TRUE;
+            if (pkcs11_object_cache[i].id_len == pTemplate->ulValueLen)
             {
-                *pSlotId = pkcs11_object_cache[i].slotid;
-                break;
+                /* coverity[misra_c_2012_rule_21_16_violation:FALSE] CK_VOID_PTR is a pointer type */
+                *pMatch = (0 == memcmp(pkcs11_object_cache[i].id, pTemplate->pValue, pTemplate->ulValueLen)) ? TRUE : FALSE;
             }
         }
+    }
+    else
+    {
+        /* do nothing */
+    }
 
-        if ((CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED == i)
+    return indexed;
+}
+
+/**
+ * \brief Check if an attribute can be read without touching the device
+ */
+CK_BBOOL pkcs11_object_index_cached(pkcs11_object_ptr pObject, const pkcs11_attrib_model * pAttribute)
+{
+    CK_BBOOL cached = FALSE;
+
+    if (NULL != pObject && NULL != pAttribute)
+    {
+        if ((pkcs11_object_get_class == pAttribute->func) || (pkcs11_object_get_name == pAttribute->func))
         {
-            rv = CKR_OBJECT_HANDLE_INVALID;
+            cached = TRUE;
+        }
+        else if (CKA_ID == pAttribute->type)
+        {
+            CK_ULONG i = pkcs11_object_cache_index(pObject);
+
+            if (i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED)
+            {
+                cached = pkcs11_object_cache[i].id_cached;
+            }
         }
         else
         {
-            rv = CKR_OK;
+            /* do nothing */
         }
     }
 
+    return cached;
+}
+
+/**
+ * \brief Read an attribute through its model function, serving CKA_ID from the
+ * object index when cached and caching it for objects in locked slots
+ */
+CK_RV pkcs11_object_get_attribute(pkcs11_object_ptr pObject, const pkcs11_attrib_model * pAttribute, CK_ATTRIBUTE_PTR pAttrib, pkcs11_session_ctx_ptr pSession)
+{
+    CK_ULONG i;
+    CK_RV rv;
+
+    if (NULL == pObject || NULL == pAttribute || NULL == pAttribute->func || NULL == pAttrib)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if (CKA_ID != pAttribute->type)
+    {
+        return pAttribute->func(pObject, pAttrib, pSession);
+    }
+
+    i = pkcs11_object_cache_index(pObject);
+
+    if ((i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED) && (TRUE == pkcs11_object_cache[i].id_cached))
+    {
+        return pkcs11_attrib_fill(pAttrib, pkcs11_object_cache[i].id, pkcs11_object_cache[i].id_len);
+    }
+
+    rv = pAttribute->func(pObject, pAttrib, pSession);
+
+    if ((CKR_OK == rv) && (i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED) && (NULL != pAttrib->pValue) && (0u < pAttrib->ulValueLen) &&
+        (pAttrib->ulValueLen <= (CK_ULONG)PKCS11_OBJECT_INDEX_ID_SIZE) && (TRUE == pkcs11_object_is_locked(pObject)))
+    {
+        (void)memcpy(pkcs11_object_cache[i].id, pAttrib->pValue, pAttrib->ulValueLen);
+        pkcs11_object_cache[i].id_len = pAttrib->ulValueLen;
+        pkcs11_object_cache[i].id_cached = TRUE;
+    }
+
     return rv;
 }
 
@@ -433,10 +826,10 @@ CK_RV pkcs11_object_find(CK_SLOT_ID slotId, pkcs11_object_ptr *ppObject, CK_ATTR
 
     if (NULL != pName)
     {
-        for (i = 0; i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i++)
+        for (i = pkcs11_object_slot_next(slotId, 0); i < (CK_ULONG)PKCS11_MAX_OBJECTS_ALLOWED; i = pkcs11_object_slot_next(slotId, i + 1u))
         {
             pkcs11_object_ptr pObj = pkcs11_object_cache[i].object;
-            if (NULL != pObj && (pkcs11_object_cache[i].slotid == slotId))
+            if (NULL != pObj)
             {
                 if ((pObj->class_id == class) && (strlen((char*)pObj->name) == pName->ulValueLen))
                 {
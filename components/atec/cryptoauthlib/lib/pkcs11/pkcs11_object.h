@@ -38,6 +38,17 @@
 extern "C" {
 #endif
 
+/** Size of the object handle hash table - kept at twice the object count so
+   linear probe chains stay short */
+#ifndef PKCS11_OBJECT_HANDLE_TABLE_SIZE
+#define PKCS11_OBJECT_HANDLE_TABLE_SIZE     (2U * PKCS11_MAX_OBJECTS_ALLOWED)
+#endif
+
+/** Largest CKA_ID value held in the object attribute index */
+#ifndef PKCS11_OBJECT_INDEX_ID_SIZE
+#define PKCS11_OBJECT_INDEX_ID_SIZE         (32U)
+#endif
+
 typedef struct pkcs11_object_s
 {
     /** The Class Identifier */
@@ -59,6 +70,8 @@ typedef struct pkcs11_object_s
 #if ATCA_TA_SUPPORT
     ta_element_attributes_t handle_info;
 #endif
+    /** Position of this object in pkcs11_object_cache */
+    CK_ULONG cache_index;
 } pkcs11_object;
 
 typedef struct pkcs11_object_cache_s
@@ -69,6 +82,12 @@ typedef struct pkcs11_object_cache_s
     CK_SLOT_ID slotid;
     /** The actual object  */
     pkcs11_object_ptr object;
+    /** Next object of the same slot - cache index plus one, zero ends the chain */
+    uint16_t next;
+    /** Cached CKA_ID value - only populated for objects in locked slots */
+    CK_BBOOL id_cached;
+    CK_ULONG id_len;
+    CK_BYTE  id[PKCS11_OBJECT_INDEX_ID_SIZE];
 } pkcs11_object_cache_t;
 
 extern pkcs11_object_cache_t pkcs11_object_cache[];
@@ -96,6 +115,12 @@ CK_RV pkcs11_object_is_private(pkcs11_object_ptr pObject, CK_BBOOL* is_private,
 CK_RV pkcs11_object_deinit(pkcs11_lib_ctx_ptr pContext);
 CK_RV pkcs11_object_get_owner(pkcs11_object_ptr pObject, CK_SLOT_ID_PTR pSlotId);
 
+/* Object Attribute Index */
+CK_ULONG pkcs11_object_slot_next(CK_SLOT_ID slotId, CK_ULONG index);
+CK_BBOOL pkcs11_object_index_match(pkcs11_object_ptr pObject, const pkcs11_attrib_model * pAttribute, const CK_ATTRIBUTE_PTR pTemplate, CK_BBOOL * pMatch);
+CK_BBOOL pkcs11_object_index_cached(pkcs11_object_ptr pObject, const pkcs11_attrib_model * pAttribute);
+CK_RV pkcs11_object_get_attribute(pkcs11_object_ptr pObject, const pkcs11_attrib_model * pAttribute, CK_ATTRIBUTE_PTR pAttrib, pkcs11_session_ctx_ptr pSession);
+
 #if ATCA_TA_SUPPORT
 ATCA_STATUS pkcs11_object_load_handle_info(ATCADevice device, pkcs11_lib_ctx_ptr pContext);
 #endif
@@ -70,6 +70,31 @@ CK_RV pkcs11_os_unlock_mutex(CK_VOID_PTR pMutex)
     return pkcs11_util_convert_rv(hal_unlock_mutex(pMutex));
 }
 
+/**
+ * \brief Create a semaphore for a thread to block on until another thread
+ * posts it - starts taken
+ * \param[in,out] ppSem location to receive ptr to the semaphore
+ */
+CK_RV pkcs11_os_create_semaphore(CK_VOID_PTR_PTR ppSem)
+{
+    return pkcs11_util_convert_rv(hal_create_semaphore(ppSem));
+}
+
+CK_RV pkcs11_os_destroy_semaphore(CK_VOID_PTR pSem)
+{
+    return pkcs11_util_convert_rv(hal_destroy_semaphore(pSem));
+}
+
+CK_RV pkcs11_os_wait_semaphore(CK_VOID_PTR pSem)
+{
+    return pkcs11_util_convert_rv(hal_wait_semaphore(pSem));
+}
+
+CK_RV pkcs11_os_post_semaphore(CK_VOID_PTR pSem)
+{
+    return pkcs11_util_convert_rv(hal_post_semaphore(pSem));
+}
+
 CK_RV pkcs11_os_alloc_shared_ctx(void ** ppShared, size_t size)
 {
     ATCA_STATUS status = ATCA_GEN_FAIL;
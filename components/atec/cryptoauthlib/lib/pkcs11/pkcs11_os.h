@@ -36,6 +36,11 @@ CK_RV pkcs11_os_destroy_mutex(CK_VOID_PTR pMutex);
 CK_RV pkcs11_os_lock_mutex(CK_VOID_PTR pMutex);
 CK_RV pkcs11_os_unlock_mutex(CK_VOID_PTR pMutex);
 
+CK_RV pkcs11_os_create_semaphore(CK_VOID_PTR_PTR ppSem);
+CK_RV pkcs11_os_destroy_semaphore(CK_VOID_PTR pSem);
+CK_RV pkcs11_os_wait_semaphore(CK_VOID_PTR pSem);
+CK_RV pkcs11_os_post_semaphore(CK_VOID_PTR pSem);
+
 CK_RV pkcs11_os_alloc_shared_ctx(void ** ppShared, size_t size);
 CK_RV pkcs11_os_free_shared_ctx(void * pShared, size_t size);
 
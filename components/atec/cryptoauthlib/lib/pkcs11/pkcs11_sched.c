@@ -0,0 +1,547 @@
+/**
+ * \file
+ * \brief PKCS11 Library Device Command Scheduler
+ *
+ * \copyright (c) 2015-2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip software
+ * and any derivatives exclusively with Microchip products. It is your
+ * responsibility to comply with third party license terms applicable to your
+ * use of third party software (including open source software) that may
+ * accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+ * PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+ * SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE
+ * OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF
+ * MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+ * FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+ * LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+ * THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+ * THIS SOFTWARE.
+ */
+
+#include "cryptoauthlib.h"
+
+#include "pkcs11_config.h"
+#include "pkcs11_init.h"
+#include "pkcs11_os.h"
+#include "pkcs11_session.h"
+#include "pkcs11_sched.h"
+
+/**
+ * \defgroup pkcs11 Scheduler (pkcs11_sched_)
+ *
+ * Device commands from all sessions are granted the device one at a time in
+ * priority order (then arrival order). Requests made through
+ * pkcs11_lock_device_ext give up the library context lock while they wait
+ * and run, so host-only work from other sessions (cached attributes,
+ * software digests) proceeds while the device is busy. A waiting request
+ * blocks on its own semaphore, which the request releasing the device posts
+ * when it is next in line. pkcs11_sched_deinit turns queued requests away
+ * and waits for them and the current holder to leave before the semaphores
+ * are destroyed.
+   @{ */
+
+typedef struct pkcs11_sched_request_s
+{
+    /** Session the request is made for - zero for library requests */
+    CK_SESSION_HANDLE       session;
+    uint32_t                ticket;
+    pkcs11_sched_prio       prio;
+    CK_BBOOL                in_use;
+    /** Posted when the request may be next to hold the device */
+    CK_VOID_PTR             wake;
+} pkcs11_sched_request;
+
+typedef struct pkcs11_sched_state_s
+{
+    /** Protects the scheduler state - independent of the library context lock */
+    CK_VOID_PTR             lock;
+    /** Device is currently granted */
+    CK_BBOOL                busy;
+    /** Session holding the device - zero for library requests */
+    CK_SESSION_HANDLE       owner;
+    /** Nesting depth of library requests */
+    CK_ULONG                depth;
+    /** Time the device was granted */
+    uint32_t                granted_us;
+    /** Set by pkcs11_sched_deinit - no requests are granted anymore */
+    CK_BBOOL                closing;
+    /** Posted while closing whenever a request leaves the scheduler */
+    CK_VOID_PTR             drained;
+    uint32_t                next_ticket;
+    pkcs11_sched_request    queue[PKCS11_SCHED_QUEUE_SIZE];
+} pkcs11_sched_state;
+
+static pkcs11_sched_state pkcs11_sched;
+
+static CK_RV pkcs11_sched_lock(pkcs11_lib_ctx_ptr pContext)
+{
+    CK_RV rv = CKR_OK;
+
+    if (NULL != pkcs11_sched.lock)
+    {
+        if (NULL != pContext->init_args.LockMutex)
+        {
+            rv = pContext->init_args.LockMutex(pkcs11_sched.lock);
+        }
+        else
+        {
+            rv = pkcs11_os_lock_mutex(pkcs11_sched.lock);
+        }
+    }
+    return rv;
+}
+
+static CK_RV pkcs11_sched_unlock(pkcs11_lib_ctx_ptr pContext)
+{
+    CK_RV rv = CKR_OK;
+
+    if (NULL != pkcs11_sched.lock)
+    {
+        if (NULL != pContext->init_args.UnlockMutex)
+        {
+            rv = pContext->init_args.UnlockMutex(pkcs11_sched.lock);
+        }
+        else
+        {
+            rv = pkcs11_os_unlock_mutex(pkcs11_sched.lock);
+        }
+    }
+    return rv;
+}
+
+static CK_ULONG pkcs11_sched_enqueue(CK_SESSION_HANDLE hSession, pkcs11_sched_prio prio)
+{
+    CK_ULONG i;
+
+    for (i = 0; i < (CK_ULONG)PKCS11_SCHED_QUEUE_SIZE; i++)
+    {
+        if (FALSE == pkcs11_sched.queue[i].in_use)
+        {
+            pkcs11_sched.queue[i].session = hSession;
+            pkcs11_sched.queue[i].ticket = pkcs11_sched.next_ticket++;
+            pkcs11_sched.queue[i].prio = prio;
+            pkcs11_sched.queue[i].in_use = TRUE;
+            break;
+        }
+    }
+    return i;
+}
+
+/** Returns the queued request that should be granted the device next */
+static CK_ULONG pkcs11_sched_head(void)
+{
+    CK_ULONG head = (CK_ULONG)PKCS11_SCHED_QUEUE_SIZE;
+    CK_ULONG i;
+
+    for (i = 0; i < (CK_ULONG)PKCS11_SCHED_QUEUE_SIZE; i++)
+    {
+        if (TRUE == pkcs11_sched.queue[i].in_use)
+        {
+            if ((CK_ULONG)PKCS11_SCHED_QUEUE_SIZE == head)
+            {
+                head = i;
+            }
+            else if ((pkcs11_sched.queue[i].prio < pkcs11_sched.queue[head].prio) ||
+                     ((pkcs11_sched.queue[i].prio == pkcs11_sched.queue[head].prio) &&
+                      ((int32_t)(pkcs11_sched.queue[i].ticket - pkcs11_sched.queue[head].ticket) < 0)))
+            {
+                head = i;
+            }
+            else
+            {
+                /* do nothing */
+            }
+        }
+    }
+    return head;
+}
+
+/** Wake the request that is next in line - called with the scheduler lock held */
+static void pkcs11_sched_wake_head(void)
+{
+    CK_ULONG head = pkcs11_sched_head();
+
+    if (((CK_ULONG)PKCS11_SCHED_QUEUE_SIZE != head) && (NULL != pkcs11_sched.queue[head].wake))
+    {
+        (void)pkcs11_os_post_semaphore(pkcs11_sched.queue[head].wake);
+    }
+}
+
+static CK_BBOOL pkcs11_sched_idle(void)
+{
+    CK_ULONG i;
+
+    if (TRUE == pkcs11_sched.busy)
+    {
+        return FALSE;
+    }
+    for (i = 0; i < (CK_ULONG)PKCS11_SCHED_QUEUE_SIZE; i++)
+    {
+        if (TRUE == pkcs11_sched.queue[i].in_use)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/** A request left the queue or gave up the device - called with the
+   scheduler lock held */
+static void pkcs11_sched_left(void)
+{
+    if ((TRUE == pkcs11_sched.closing) && (NULL != pkcs11_sched.drained))
+    {
+        (void)pkcs11_os_post_semaphore(pkcs11_sched.drained);
+    }
+    else if (FALSE == pkcs11_sched.busy)
+    {
+        pkcs11_sched_wake_head();
+    }
+    else
+    {
+        /* do nothing */
+    }
+}
+
+/**
+ * \brief Create the scheduler lock and the request semaphores. They are only
+ * needed when the application accesses the library from multiple threads.
+ */
+CK_RV pkcs11_sched_init(pkcs11_lib_ctx_ptr pContext)
+{
+    CK_RV rv = CKR_OK;
+    CK_ULONG i;
+
+    if (NULL == pContext)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    (void)memset(&pkcs11_sched, 0, sizeof(pkcs11_sched));
+
+    if ((NULL != pContext->lib_lock) || (TRUE == pContext->dev_lock_enabled))
+    {
+        if (NULL != pContext->init_args.CreateMutex)
+        {
+            rv = pContext->init_args.CreateMutex(&pkcs11_sched.lock);
+        }
+        else
+        {
+            rv = pkcs11_os_create_mutex(&pkcs11_sched.lock);
+        }
+
+        for (i = 0; (CKR_OK == rv) && (i < (CK_ULONG)PKCS11_SCHED_QUEUE_SIZE); i++)
+        {
+            rv = pkcs11_os_create_semaphore(&pkcs11_sched.queue[i].wake);
+        }
+
+        if (CKR_OK == rv)
+        {
+            rv = pkcs11_os_create_semaphore(&pkcs11_sched.drained);
+        }
+
+        if (CKR_OK != rv)
+        {
+            (void)pkcs11_sched_deinit(pContext);
+        }
+    }
+    return rv;
+}
+
+/**
+ * \brief Turn away queued requests, wait for them and the request holding the
+ * device to leave, then destroy the lock and the semaphores. Called with the
+ * context lock held, so no new requests can be made meanwhile.
+ */
+CK_RV pkcs11_sched_deinit(pkcs11_lib_ctx_ptr pContext)
+{
+    CK_RV rv = CKR_OK;
+    CK_ULONG i;
+
+    if (NULL == pContext)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if ((NULL != pkcs11_sched.lock) && (NULL != pkcs11_sched.drained) &&
+        (CKR_OK == pkcs11_sched_lock(pContext)))
+    {
+        pkcs11_sched.closing = TRUE;
+
+        for (i = 0; i < (CK_ULONG)PKCS11_SCHED_QUEUE_SIZE; i++)
+        {
+            if ((TRUE == pkcs11_sched.queue[i].in_use) && (NULL != pkcs11_sched.queue[i].wake))
+            {
+                (void)pkcs11_os_post_semaphore(pkcs11_sched.queue[i].wake);
+            }
+        }
+
+        while (FALSE == pkcs11_sched_idle())
+        {
+            if ((CKR_OK != pkcs11_sched_unlock(pContext)) ||
+                (CKR_OK != pkcs11_os_wait_semaphore(pkcs11_sched.drained)) ||
+                (CKR_OK != pkcs11_sched_lock(pContext)))
+            {
+                /* Someone may still use the semaphores - leave them be */
+                return CKR_CANT_LOCK;
+            }
+        }
+
+        (void)pkcs11_sched_unlock(pContext);
+    }
+
+    if (NULL != pkcs11_sched.drained)
+    {
+        (void)pkcs11_os_destroy_semaphore(pkcs11_sched.drained);
+    }
+
+    for (i = 0; i < (CK_ULONG)PKCS11_SCHED_QUEUE_SIZE; i++)
+    {
+        if (NULL != pkcs11_sched.queue[i].wake)
+        {
+            (void)pkcs11_os_destroy_semaphore(pkcs11_sched.queue[i].wake);
+        }
+    }
+
+    if (NULL != pkcs11_sched.lock)
+    {
+        if (NULL != pContext->init_args.DestroyMutex)
+        {
+            rv = pContext->init_args.DestroyMutex(pkcs11_sched.lock);
+        }
+        else
+        {
+            rv = pkcs11_os_destroy_mutex(pkcs11_sched.lock);
+        }
+    }
+
+    (void)memset(&pkcs11_sched, 0, sizeof(pkcs11_sched));
+
+    return rv;
+}
+
+/**
+ * \brief Wait until the device is granted to the caller
+ *
+ * Library requests (pTicket == NULL) are always made with the context lock
+ * held, so a library request while the library already owns the device is a
+ * nested call from the same thread and is granted immediately.
+ */
+CK_RV pkcs11_sched_acquire(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket)
+{
+    uint32_t start = (uint32_t)PKCS11_SCHED_TIMESTAMP_US();
+    CK_SESSION_HANDLE hSession = (NULL != pTicket) ? pTicket->session : 0u;
+    pkcs11_sched_prio prio = (NULL != pTicket) ? pTicket->prio : PKCS11_SCHED_PRIO_NORMAL;
+    CK_ULONG index;
+    CK_RV rv;
+
+    if (NULL == pContext)
+    {
+        pContext = pkcs11_get_context();
+    }
+
+    if (NULL == pContext)
+    {
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    if (CKR_OK != (rv = pkcs11_sched_lock(pContext)))
+    {
+        return rv;
+    }
+
+    if (TRUE == pkcs11_sched.closing)
+    {
+        (void)pkcs11_sched_unlock(pContext);
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    if ((NULL == pTicket) && (TRUE == pkcs11_sched.busy) && (0u == pkcs11_sched.owner))
+    {
+        pkcs11_sched.depth++;
+        return pkcs11_sched_unlock(pContext);
+    }
+
+    index = pkcs11_sched_enqueue(hSession, prio);
+
+    if ((CK_ULONG)PKCS11_SCHED_QUEUE_SIZE == index)
+    {
+        /* Each session has at most one request in flight unless it is used
+           from several threads at once */
+        (void)pkcs11_sched_unlock(pContext);
+        return CKR_FUNCTION_FAILED;
+    }
+
+    while ((TRUE == pkcs11_sched.busy) || (index != pkcs11_sched_head()))
+    {
+        if (NULL == pkcs11_sched.queue[index].wake)
+        {
+            /* Single threaded - nothing will release the device */
+            rv = CKR_FUNCTION_FAILED;
+        }
+        else if (CKR_OK == (rv = pkcs11_sched_unlock(pContext)))
+        {
+            rv = pkcs11_os_wait_semaphore(pkcs11_sched.queue[index].wake);
+
+            if (CKR_OK != pkcs11_sched_lock(pContext))
+            {
+                /* Without the lock the request can not be withdrawn safely */
+                return CKR_CANT_LOCK;
+            }
+
+            if ((CKR_OK == rv) && (TRUE == pkcs11_sched.closing))
+            {
+                rv = CKR_CRYPTOKI_NOT_INITIALIZED;
+            }
+        }
+        else
+        {
+            return rv;
+        }
+
+        if (CKR_OK != rv)
+        {
+            /* Withdraw the request and pass the wake up on in case it was ours */
+            pkcs11_sched.queue[index].in_use = FALSE;
+            pkcs11_sched_left();
+            (void)pkcs11_sched_unlock(pContext);
+            return rv;
+        }
+    }
+
+    pkcs11_sched.queue[index].in_use = FALSE;
+    pkcs11_sched.busy = TRUE;
+    pkcs11_sched.owner = hSession;
+    pkcs11_sched.depth = 1;
+    pkcs11_sched.granted_us = (uint32_t)PKCS11_SCHED_TIMESTAMP_US();
+
+    if (NULL != pTicket)
+    {
+        pTicket->wait_us = pkcs11_sched.granted_us - start;
+    }
+
+    return pkcs11_sched_unlock(pContext);
+}
+
+/**
+ * \brief Give the device back to the scheduler and wake the next request
+ */
+CK_RV pkcs11_sched_release(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket)
+{
+    CK_RV rv;
+
+    if (NULL == pContext)
+    {
+        pContext = pkcs11_get_context();
+    }
+
+    if (NULL == pContext)
+    {
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    if (CKR_OK != (rv = pkcs11_sched_lock(pContext)))
+    {
+        return rv;
+    }
+
+    if (pkcs11_sched.depth > 1u)
+    {
+        pkcs11_sched.depth--;
+    }
+    else
+    {
+        if (NULL != pTicket)
+        {
+            pTicket->exec_us = (uint32_t)PKCS11_SCHED_TIMESTAMP_US() - pkcs11_sched.granted_us;
+        }
+        pkcs11_sched.busy = FALSE;
+        pkcs11_sched.owner = 0;
+        pkcs11_sched.depth = 0;
+        pkcs11_sched_left();
+    }
+
+    return pkcs11_sched_unlock(pContext);
+}
+
+/**
+ * \brief Add a completed request to the statistics of its session. Must be
+ * called with the context lock held and the session checked.
+ */
+CK_RV pkcs11_sched_account(pkcs11_lib_ctx_ptr pContext, pkcs11_session_ctx_ptr pSession, const pkcs11_sched_ticket * pTicket)
+{
+    CK_RV rv;
+
+    if (NULL == pContext || NULL == pSession || NULL == pTicket)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if (CKR_OK != (rv = pkcs11_sched_lock(pContext)))
+    {
+        return rv;
+    }
+
+    pSession->sched_stats.commands++;
+    pSession->sched_stats.wait_total_us += pTicket->wait_us;
+    if (pTicket->wait_us > pSession->sched_stats.wait_max_us)
+    {
+        pSession->sched_stats.wait_max_us = pTicket->wait_us;
+    }
+    pSession->sched_stats.exec_total_us += pTicket->exec_us;
+    if (pTicket->exec_us > pSession->sched_stats.exec_max_us)
+    {
+        pSession->sched_stats.exec_max_us = pTicket->exec_us;
+    }
+
+    return pkcs11_sched_unlock(pContext);
+}
+
+/**
+ * \brief Read the device usage statistics of a session
+ */
+CK_RV pkcs11_sched_get_stats(CK_SESSION_HANDLE hSession, pkcs11_sched_stats * pStats)
+{
+    pkcs11_lib_ctx_ptr pLibCtx;
+    pkcs11_session_ctx_ptr pSession;
+    CK_RV rv;
+
+    if (NULL == pStats)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    rv = pkcs11_init_check(&pLibCtx, FALSE);
+    if (CKR_OK != rv)
+    {
+        return rv;
+    }
+
+    /* The context lock keeps the session from being closed meanwhile */
+    if (CKR_OK != (rv = pkcs11_lock_context(pLibCtx)))
+    {
+        return rv;
+    }
+
+    if (CKR_OK == (rv = pkcs11_session_check(&pSession, hSession)))
+    {
+        if (CKR_OK == (rv = pkcs11_sched_lock(pLibCtx)))
+        {
+            (void)memcpy(pStats, &pSession->sched_stats, sizeof(pkcs11_sched_stats));
+            rv = pkcs11_sched_unlock(pLibCtx);
+        }
+    }
+
+    (void)pkcs11_unlock_context(pLibCtx);
+
+    return rv;
+}
+
+/** @} */
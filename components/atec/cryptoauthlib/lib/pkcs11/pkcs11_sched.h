@@ -0,0 +1,99 @@
+/**
+ * \file
+ * \brief PKCS11 Library Device Command Scheduler
+ *
+ * \copyright (c) 2015-2024 Microchip Technology Inc. and its subsidiaries.
+ *
+ * \page License
+ *
+ * Subject to your compliance with these terms, you may use Microchip software
+ * and any derivatives exclusively with Microchip products. It is your
+ * responsibility to comply with third party license terms applicable to your
+ * use of third party software (including open source software) that may
+ * accompany Microchip software.
+ *
+ * THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+ * EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+ * WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+ * PARTICULAR PURPOSE. IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT,
+ * SPECIAL, PUNITIVE, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE
+ * OF ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF
+ * MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+ * FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL
+ * LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+ * THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+ * THIS SOFTWARE.
+ */
+
+#ifndef PKCS11_SCHED_H_
+#define PKCS11_SCHED_H_
+
+#include "cryptoki.h"
+#include "pkcs11_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Microsecond timestamp used for the per-session latency statistics. When
+   the platform does not provide one only the command counters are kept */
+#ifndef PKCS11_SCHED_TIMESTAMP_US
+#define PKCS11_SCHED_TIMESTAMP_US()     (0UL)
+#endif
+
+/** Every session may have one request queued plus one library request */
+#define PKCS11_SCHED_QUEUE_SIZE         (PKCS11_MAX_SESSIONS_ALLOWED + 1U)
+
+/** Device request priorities - lower values are granted the device first */
+typedef enum
+{
+    /** Short commands that other operations wait on (random, nonce) */
+    PKCS11_SCHED_PRIO_HIGH   = 0,
+    /** Cryptographic operations (sign, verify, ecdh) */
+    PKCS11_SCHED_PRIO_NORMAL = 1,
+    /** Long running or management commands (key generation, writes) */
+    PKCS11_SCHED_PRIO_LOW    = 2,
+} pkcs11_sched_prio;
+
+/** Per-session device usage statistics */
+typedef struct pkcs11_sched_stats_s
+{
+    /** Number of device requests granted */
+    CK_ULONG commands;
+    /** Time spent queued for the device */
+    uint32_t wait_total_us;
+    uint32_t wait_max_us;
+    /** Time the device was held */
+    uint32_t exec_total_us;
+    uint32_t exec_max_us;
+} pkcs11_sched_stats;
+
+/** A device request made on behalf of a session. Only handles are kept since
+   the session and its key may be closed or destroyed by another thread while
+   the request holds the device without the context lock */
+typedef struct pkcs11_sched_ticket_s
+{
+    CK_SESSION_HANDLE   session;
+    /** Object the request operates on - zero if none */
+    CK_OBJECT_HANDLE    object;
+    pkcs11_sched_prio   prio;
+    uint32_t            wait_us;
+    uint32_t            exec_us;
+} pkcs11_sched_ticket;
+
+#define PKCS11_SCHED_TICKET_INIT(s, o, p)   { (s), (o), (p), 0U, 0U }
+
+struct pkcs11_session_ctx_s;
+
+CK_RV pkcs11_sched_init(pkcs11_lib_ctx_ptr pContext);
+CK_RV pkcs11_sched_deinit(pkcs11_lib_ctx_ptr pContext);
+CK_RV pkcs11_sched_acquire(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket);
+CK_RV pkcs11_sched_release(pkcs11_lib_ctx_ptr pContext, pkcs11_sched_ticket * pTicket);
+CK_RV pkcs11_sched_account(pkcs11_lib_ctx_ptr pContext, struct pkcs11_session_ctx_s * pSession, const pkcs11_sched_ticket * pTicket);
+CK_RV pkcs11_sched_get_stats(CK_SESSION_HANDLE hSession, pkcs11_sched_stats * pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PKCS11_SCHED_H_ */
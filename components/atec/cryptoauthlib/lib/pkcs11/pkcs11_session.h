@@ -31,6 +31,7 @@
 #include "cryptoki.h"
 #include "pkcs11_config.h"
 #include "cal_internal.h"
+#include "pkcs11_sched.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -89,6 +90,7 @@ typedef struct pkcs11_session_ctx_s
     CK_OBJECT_HANDLE        active_object;
     CK_MECHANISM_TYPE       active_mech;
     pkcs11_session_mech_ctx active_mech_data;
+    pkcs11_sched_stats      sched_stats;
 } pkcs11_session_ctx, *pkcs11_session_ctx_ptr;
 
 #ifdef __cplusplus
@@ -278,21 +278,30 @@ CK_RV pkcs11_signature_sign(
 
     if (CKR_OK == (rv = pkcs11_lock_context(pLibCtx)))
     {   
-        ATCADeviceType dev_type = atcab_get_device_type_ext(pSession->slot->device_ctx);
+        /* The device is held without the context lock, so the session and
+           the key are only used through these copies until it is released */
+        ATCADevice device = pSession->slot->device_ctx;
+        ATCADeviceType dev_type = atcab_get_device_type_ext(device);
+        CK_MECHANISM_TYPE mech = pSession->active_mech;
+        uint16_t key_slot = pKey->slot;
+#if ATCA_TA_SUPPORT
+        uint8_t key_type = ((pKey->handle_info.element_CKA & TA_HANDLE_INFO_KEY_TYPE_MASK) >> TA_HANDLE_INFO_KEY_TYPE_SHIFT);
+#endif
+        pkcs11_sched_ticket ticket = PKCS11_SCHED_TICKET_INIT(hSession, pSession->active_object, PKCS11_SCHED_PRIO_NORMAL);
 
-        switch (pSession->active_mech)
+        switch (mech)
         {
         //Key type is symmetric
         case CKM_SHA256_HMAC:
             if (CKR_OK == (rv = pkcs11_signature_check_params(pSignature, pulSignatureLen, ATCA_SHA256_DIGEST_SIZE)))
             {
-                if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
+                if (CKR_OK == (rv = pkcs11_lock_device_ext(pLibCtx, &ticket)))
                 {
                     rv =
-                        pkcs11_util_convert_rv(atcab_sha_hmac_ext(pSession->slot->device_ctx, pData, ulDataLen, pKey->slot, pSignature,
+                        pkcs11_util_convert_rv(atcab_sha_hmac_ext(device, pData, ulDataLen, key_slot, pSignature,
                                                                   SHA_MODE_TARGET_OUT_ONLY));
 
-                    (void)pkcs11_unlock_device(pLibCtx);
+                    rv = pkcs11_unlock_device_ext(pLibCtx, &ticket, rv);
                 }
             }
             break;
@@ -301,27 +310,26 @@ CK_RV pkcs11_signature_sign(
             {   
                 if (atcab_is_ca_device(dev_type))
                 {
-                    if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
+                    if (CKR_OK == (rv = pkcs11_lock_device_ext(pLibCtx, &ticket)))
                     {
 #if ATCA_CA_SUPPORT
-                        rv = pkcs11_util_convert_rv(atcab_sign_ext(pSession->slot->device_ctx, pKey->slot, pData, pSignature));
+                        rv = pkcs11_util_convert_rv(atcab_sign_ext(device, key_slot, pData, pSignature));
 #endif              
-                        (void)pkcs11_unlock_device(pLibCtx);
+                        rv = pkcs11_unlock_device_ext(pLibCtx, &ticket, rv);
                     }
                 }
                 else if (atcab_is_ta_device(dev_type))
                 {   
-                    if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
+                    if (CKR_OK == (rv = pkcs11_lock_device_ext(pLibCtx, &ticket)))
                     {
 #if ATCA_TA_SUPPORT     
-                        uint8_t key_type = ((pKey->handle_info.element_CKA & TA_HANDLE_INFO_KEY_TYPE_MASK) >> TA_HANDLE_INFO_KEY_TYPE_SHIFT);
                         cal_buffer msg_buf = CAL_BUF_INIT(ulDataLen, pData);
                         cal_buffer sign_buf = CAL_BUF_INIT(*pulSignatureLen, pSignature);
                         //EC CURVE type depend on minium message size constraints for signing external messages in TA devices
-                        rv = pkcs11_util_convert_rv(talib_sign_external(pSession->slot->device_ctx, key_type, pKey->slot, TA_HANDLE_INPUT_BUFFER, &msg_buf,
+                        rv = pkcs11_util_convert_rv(talib_sign_external(device, key_type, key_slot, TA_HANDLE_INPUT_BUFFER, &msg_buf,
                                                                         &sign_buf));
 #endif              
-                        (void)pkcs11_unlock_device(pLibCtx);
+                        rv = pkcs11_unlock_device_ext(pLibCtx, &ticket, rv);
                     }
                 }
                 else
@@ -337,10 +345,9 @@ CK_RV pkcs11_signature_sign(
             {
                 if (atcab_is_ta_device(dev_type))
                 {   
-                    if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
+                    if (CKR_OK == (rv = pkcs11_lock_device_ext(pLibCtx, &ticket)))
                     {     
-                        uint8_t key_type = ((pKey->handle_info.element_CKA & TA_HANDLE_INFO_KEY_TYPE_MASK) >> TA_HANDLE_INFO_KEY_TYPE_SHIFT);
-                        uint8_t mode = (CKM_RSA_PKCS == pSession->active_mech) ? (key_type) : (uint8_t)(key_type | (uint8_t)(TA_ALG_MODE_RSA_SSA_PSS << TA_ALG_MODE_SHIFT));
+                        uint8_t mode = (CKM_RSA_PKCS == mech) ? (key_type) : (uint8_t)(key_type | (uint8_t)(TA_ALG_MODE_RSA_SSA_PSS << TA_ALG_MODE_SHIFT));
                         cal_buffer msg_buf = CAL_BUF_INIT(ulDataLen, pData);
                         cal_buffer sign_buf = CAL_BUF_INIT(*pulSignatureLen, pSignature);
 
@@ -356,10 +363,10 @@ CK_RV pkcs11_signature_sign(
                                 (void)memmove(pData, &pData[sizeof(pkcs11_sha256_asn1_hdr)], TA_SHA256_DIGEST_SIZE);
                                 msg_buf.len = TA_SHA256_DIGEST_SIZE;
                             }
-                            rv = pkcs11_util_convert_rv(talib_sign_external(pSession->slot->device_ctx, mode, pKey->slot, TA_HANDLE_INPUT_BUFFER, &msg_buf,
+                            rv = pkcs11_util_convert_rv(talib_sign_external(device, mode, key_slot, TA_HANDLE_INPUT_BUFFER, &msg_buf,
                                                                            &sign_buf));
                         }           
-                        (void)pkcs11_unlock_device(pLibCtx);
+                        rv = pkcs11_unlock_device_ext(pLibCtx, &ticket, rv);
                     }
                 }   
             }
@@ -371,18 +378,22 @@ CK_RV pkcs11_signature_sign(
             break;
         }
 
-        (void)pkcs11_unlock_context(pLibCtx);
-
         if (CKR_VENDOR_DEFINED == rv)
         {
             /* Made it through the pSignature buffer check so pulSignatureLen is populated */
             rv = CKR_OK;
         }
-        else
+        else if (CKR_SESSION_HANDLE_INVALID != rv)
         {
             /* Any other condition resets the sign operation */
             pSession->active_mech = CKM_VENDOR_DEFINED;
         }
+        else
+        {
+            /* Session closed while the device was held */
+        }
+
+        (void)pkcs11_unlock_context(pLibCtx);
     }
 
     return rv;
@@ -509,7 +520,17 @@ CK_RV pkcs11_signature_verify(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_
         return rv;
     }
 
-    switch (pSession->active_mech)
+    /* The device is held without the context lock, so the session and the key
+       are only used through these copies until it is released */
+    ATCADevice device = pSession->slot->device_ctx;
+    CK_MECHANISM_TYPE mech = pSession->active_mech;
+    uint16_t key_slot = pKey->slot;
+#if ATCA_TA_SUPPORT
+    uint8_t key_type = ((pKey->handle_info.element_CKA & TA_HANDLE_INFO_KEY_TYPE_MASK) >> TA_HANDLE_INFO_KEY_TYPE_SHIFT);
+#endif
+    pkcs11_sched_ticket ticket = PKCS11_SCHED_TICKET_INIT(hSession, pSession->active_object, PKCS11_SCHED_PRIO_NORMAL);
+
+    switch (mech)
     {
     case CKM_SHA256_HMAC:
     {
@@ -529,10 +550,10 @@ CK_RV pkcs11_signature_verify(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_
             return CKR_SIGNATURE_LEN_RANGE;
         }
 
-        if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
+        if (CKR_OK == (rv = pkcs11_lock_device_ext(pLibCtx, &ticket)))
         {
             if (CKR_OK ==
-                (rv = pkcs11_util_convert_rv(atcab_sha_hmac_ext(pSession->slot->device_ctx, pData, ulDataLen, pKey->slot, buf, SHA_MODE_TARGET_OUT_ONLY))))
+                (rv = pkcs11_util_convert_rv(atcab_sha_hmac_ext(device, pData, ulDataLen, key_slot, buf, SHA_MODE_TARGET_OUT_ONLY))))
             {
                 if (0 == memcmp(pSignature, buf, ATCA_SHA256_DIGEST_SIZE))
                 {
@@ -540,13 +561,14 @@ CK_RV pkcs11_signature_verify(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_
                 }
             }
 
-            (void)pkcs11_unlock_device(pLibCtx);
+            rv = pkcs11_unlock_device_ext(pLibCtx, &ticket, rv);
         }
     }
     break;
     case CKM_ECDSA:
         if (NULL == key_data || NULL == key_data->ecc_key_info)
         {
+            (void)pkcs11_unlock_context(pLibCtx);
             return CKR_ARGUMENTS_BAD;
         }
         
@@ -566,77 +588,86 @@ CK_RV pkcs11_signature_verify(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_
 
         if (CKR_OK == (rv = pkcs11_object_is_private(pKey, &is_private, pSession)))
         {
-            if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
+            ATCADeviceType dev_type = atcab_get_device_type_ext(device);
+
+            /* Device can't verify against a private key so ask the device for
+               the public key first then perform an external verify */
+            uint8_t pub_key[PKCS11_MAX_ECC_PB_KEY_SIZE];
+#if ATCA_TA_SUPPORT
+            cal_buffer ec_pubkey_buf = CAL_BUF_INIT(key_data->ecc_key_info->pubkey_sz, pub_key);
+
+            if (is_private && atcab_is_ta_device(dev_type))
             {
-                ATCADeviceType dev_type = atcab_get_device_type_ext(pSession->slot->device_ctx);
+                /* Reading it walks the object and slot tables so it is done
+                   before the context lock is released */
+                if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
+                {
+                    rv = pkcs11_ta_get_pubkey(pKey, &ec_pubkey_buf, pSession);
+                    (void)pkcs11_unlock_device(pLibCtx);
+                }
+            }
+#endif
 
-                /* Device can't verify against a private key so ask the device for
-                   the public key first then perform an external verify */
-                uint8_t pub_key[PKCS11_MAX_ECC_PB_KEY_SIZE];
-                if (is_private)
+            if (CKR_OK == rv)
+            {
+                if (CKR_OK == (rv = pkcs11_lock_device_ext(pLibCtx, &ticket)))
                 {
-                    if (atcab_is_ca_device(dev_type))
+                    if (is_private)
                     {
-#if ATCA_CA_SUPPORT
-                        if (CKR_OK == (rv = pkcs11_util_convert_rv(atcab_get_pubkey_ext(pSession->slot->device_ctx, pKey->slot, pub_key))))
+                        if (atcab_is_ca_device(dev_type))
                         {
-                            rv = pkcs11_util_convert_rv(atcab_verify_extern_ext(pSession->slot->device_ctx, pData, pSignature, pub_key, &verified));
-                        }
+#if ATCA_CA_SUPPORT
+                            if (CKR_OK == (rv = pkcs11_util_convert_rv(atcab_get_pubkey_ext(device, key_slot, pub_key))))
+                            {
+                                rv = pkcs11_util_convert_rv(atcab_verify_extern_ext(device, pData, pSignature, pub_key, &verified));
+                            }
 #endif
-                    }
-                    else if ((atcab_is_ta_device(dev_type)) && (NULL != key_data->ecc_key_info))
-                    {
-#if ATCA_TA_SUPPORT
-                        cal_buffer ec_pubkey_buf = CAL_BUF_INIT(key_data->ecc_key_info->pubkey_sz, pub_key);
-                        if (CKR_OK == (rv = pkcs11_ta_get_pubkey(pKey, &ec_pubkey_buf, pSession)))
+                        }
+                        else if (atcab_is_ta_device(dev_type))
                         {
-#if TALIB_VERIFY_EXTERN_EN
-                            uint8_t key_type = ((pKey->handle_info.element_CKA & TA_HANDLE_INFO_KEY_TYPE_MASK) >> TA_HANDLE_INFO_KEY_TYPE_SHIFT);
+#if ATCA_TA_SUPPORT && TALIB_VERIFY_EXTERN_EN
                             cal_buffer sign_buf = CAL_BUF_INIT(ulSignatureLen, pSignature);
-                            cal_buffer pbkey_buf = CAL_BUF_INIT(key_data->ecc_key_info->pubkey_sz, pub_key);
                             cal_buffer msg_buf = CAL_BUF_INIT(ulDataLen, pData);
 
-                            rv = pkcs11_util_convert_rv(talib_verify_extern(pSession->slot->device_ctx, key_type, TA_HANDLE_INPUT_BUFFER, &pbkey_buf, &sign_buf,
+                            rv = pkcs11_util_convert_rv(talib_verify_extern(device, key_type, TA_HANDLE_INPUT_BUFFER, &ec_pubkey_buf, &sign_buf,
                                                                            &msg_buf, &verified));
 #endif
                         }
-#endif
+                        else
+                        {
+                            /* do nothing */
+                        }
                     }
                     else
                     {
-                        /* do nothing */
-                    }
-                }
-                else
-                {
-                    /* Assume Public Key has been stored properly and verify against
-                        whatever is stored */
-                    if (atcab_is_ca_device(dev_type))
-                    {
+                        /* Assume Public Key has been stored properly and verify against
+                            whatever is stored */
+                        if (atcab_is_ca_device(dev_type))
+                        {
 #if ATCA_CA_SUPPORT
-                        rv = pkcs11_util_convert_rv(atcab_verify_stored_ext(pSession->slot->device_ctx, pData, pSignature, pKey->slot, &verified));
+                            rv = pkcs11_util_convert_rv(atcab_verify_stored_ext(device, pData, pSignature, key_slot, &verified));
 #endif
-                    }
-                    else if (atcab_is_ta_device(dev_type))
-                    {
+                        }
+                        else if (atcab_is_ta_device(dev_type))
+                        {
 #if ATCA_TA_SUPPORT
 #if TALIB_VERIFY_STORED_EN
-                        uint8_t key_type = ((pKey->handle_info.element_CKA & TA_HANDLE_INFO_KEY_TYPE_MASK) >> TA_HANDLE_INFO_KEY_TYPE_SHIFT);
-                        cal_buffer sign_buf = CAL_BUF_INIT(ulSignatureLen, pSignature);
-                        cal_buffer msg_buf = CAL_BUF_INIT(ulDataLen, pData);
+                            cal_buffer sign_buf = CAL_BUF_INIT(ulSignatureLen, pSignature);
+                            cal_buffer msg_buf = CAL_BUF_INIT(ulDataLen, pData);
 
-                        rv = pkcs11_util_convert_rv(talib_verify_stored(pSession->slot->device_ctx, key_type, TA_HANDLE_INPUT_BUFFER, pKey->slot, &sign_buf,
-                                                                       &msg_buf, &verified));
+                            rv = pkcs11_util_convert_rv(talib_verify_stored(device, key_type, TA_HANDLE_INPUT_BUFFER, key_slot, &sign_buf,
+                                                                           &msg_buf, &verified));
 #endif
 #endif
-                    }
-                    else
-                    {
-                        /* do nothing */
-                    }
+                        }
+                        else
+                        {
+                            /* do nothing */
+                        }
 
+                    }
+                    rv = pkcs11_unlock_device_ext(pLibCtx, &ticket, rv);
                 }
-                (void)pkcs11_unlock_device(pLibCtx);
             }
         }
         break;
@@ -645,6 +676,7 @@ CK_RV pkcs11_signature_verify(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_
     case CKM_RSA_PKCS_PSS:
         if (NULL == key_data || NULL == key_data->rsa_key_info)
         {
+            (void)pkcs11_unlock_context(pLibCtx);
             return CKR_ARGUMENTS_BAD;
         }
         
@@ -664,49 +696,57 @@ CK_RV pkcs11_signature_verify(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_
 
         if (CKR_OK == (rv = pkcs11_object_is_private(pKey, &is_private, pSession)))
         {
-            if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
-            {
-                ATCADeviceType dev_type = atcab_get_device_type_ext(pSession->slot->device_ctx);
+            ATCADeviceType dev_type = atcab_get_device_type_ext(device);
+            uint8_t pub_key[PKCS11_MAX_RSA_PB_KEY_SIZE];
+            cal_buffer rsa_pubkey_buf = CAL_BUF_INIT(key_data->rsa_key_info->pubkey_sz, pub_key);
 
-                if (atcab_is_ta_device(dev_type))
+            if (true == is_private && atcab_is_ta_device(dev_type))
+            {
+                /* Device can't verify against a private key so ask the device for the public key
+                first then perform an external verify - reading it walks the object and slot
+                tables so it is done before the context lock is released */
+                if (CKR_OK == (rv = pkcs11_lock_device(pLibCtx)))
                 {
-                    uint8_t key_type = ((pKey->handle_info.element_CKA & TA_HANDLE_INFO_KEY_TYPE_MASK) >> TA_HANDLE_INFO_KEY_TYPE_SHIFT);
-                    uint8_t mode = (CKM_RSA_PKCS == pSession->active_mech) ? (key_type) : (uint8_t)(key_type | (uint8_t)(TA_ALG_MODE_RSA_SSA_PSS << TA_ALG_MODE_SHIFT));
-                    cal_buffer sign_buf = CAL_BUF_INIT(ulSignatureLen, pSignature);
-                    cal_buffer msg_buf = CAL_BUF_INIT(ulDataLen, pData);
+                    rv = pkcs11_ta_get_pubkey(pKey, &rsa_pubkey_buf, pSession);
+                    (void)pkcs11_unlock_device(pLibCtx);
+                }
+            }
 
-                    // Data to be verified should not include encoded data(asn1 header) of SHA256
-                    if (0 == memcmp(pData, pkcs11_sha256_asn1_hdr, sizeof(pkcs11_sha256_asn1_hdr)))
+            if (CKR_OK == rv)
+            {
+                if (CKR_OK == (rv = pkcs11_lock_device_ext(pLibCtx, &ticket)))
+                {
+                    if (atcab_is_ta_device(dev_type))
                     {
-                        (void)memmove(pData, &pData[sizeof(pkcs11_sha256_asn1_hdr)], TA_SHA256_DIGEST_SIZE);
-                        msg_buf.len = TA_SHA256_DIGEST_SIZE;
-                    }
+                        uint8_t mode = (CKM_RSA_PKCS == mech) ? (key_type) : (uint8_t)(key_type | (uint8_t)(TA_ALG_MODE_RSA_SSA_PSS << TA_ALG_MODE_SHIFT));
+                        cal_buffer sign_buf = CAL_BUF_INIT(ulSignatureLen, pSignature);
+                        cal_buffer msg_buf = CAL_BUF_INIT(ulDataLen, pData);
 
-                    if (true == is_private)
-                    {
-                        /* Device can't verify against a private key so ask the device for the public key
-                        first then perform an external verify */
-                        uint8_t pub_key[PKCS11_MAX_RSA_PB_KEY_SIZE];
-                        cal_buffer rsa_pubkey_buf = CAL_BUF_INIT(key_data->rsa_key_info->pubkey_sz, pub_key);
-                        
-                        if (CKR_OK == (rv = pkcs11_ta_get_pubkey(pKey, &rsa_pubkey_buf, pSession)))
+                        // Data to be verified should not include encoded data(asn1 header) of SHA256
+                        if (0 == memcmp(pData, pkcs11_sha256_asn1_hdr, sizeof(pkcs11_sha256_asn1_hdr)))
+                        {
+                            (void)memmove(pData, &pData[sizeof(pkcs11_sha256_asn1_hdr)], TA_SHA256_DIGEST_SIZE);
+                            msg_buf.len = TA_SHA256_DIGEST_SIZE;
+                        }
+
+                        if (true == is_private)
                         {
 #if TALIB_VERIFY_EXTERN_EN
-                            rv = pkcs11_util_convert_rv(talib_verify_extern(pSession->slot->device_ctx, mode, TA_HANDLE_INPUT_BUFFER, &rsa_pubkey_buf, &sign_buf,
+                            rv = pkcs11_util_convert_rv(talib_verify_extern(device, mode, TA_HANDLE_INPUT_BUFFER, &rsa_pubkey_buf, &sign_buf,
                                                                            &msg_buf, &verified));
 #endif
                         }
-                    }
-                    else
-                    {
-                        /* Assume Public Key has been stored properly and verify against whatever is stored */              
+                        else
+                        {
+                            /* Assume Public Key has been stored properly and verify against whatever is stored */              
 #if TALIB_VERIFY_STORED_EN
-                        rv = pkcs11_util_convert_rv(talib_verify_stored(pSession->slot->device_ctx, mode, TA_HANDLE_INPUT_BUFFER, pKey->slot, &sign_buf,
-                                                                       &msg_buf, &verified));
+                            rv = pkcs11_util_convert_rv(talib_verify_stored(device, mode, TA_HANDLE_INPUT_BUFFER, key_slot, &sign_buf,
+                                                                           &msg_buf, &verified));
 #endif
+                        }
                     }
+                    rv = pkcs11_unlock_device_ext(pLibCtx, &ticket, rv);
                 }
-                (void)pkcs11_unlock_device(pLibCtx);
             }
         }
         break;
@@ -715,10 +755,21 @@ CK_RV pkcs11_signature_verify(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_
         break;
     }
 
-    pSession->active_mech = CKM_VENDOR_DEFINED;
+    if (CKR_SESSION_HANDLE_INVALID != rv)
+    {
+        pSession->active_mech = CKM_VENDOR_DEFINED;
+    }
+    else
+    {
+        /* Session closed while the device was held */
+    }
     (void)pkcs11_unlock_context(pLibCtx);
 
-    if ((CKR_OK != rv || TRUE != verified))
+    if ((CKR_SESSION_HANDLE_INVALID == rv) || (CKR_OBJECT_HANDLE_INVALID == rv))
+    {
+        /* Report the stale handle rather than a bad signature */
+    }
+    else if ((CKR_OK != rv || TRUE != verified))
     {
         rv = CKR_SIGNATURE_INVALID;
     }
@@ -654,12 +654,16 @@ CK_RV pkcs11_token_random(CK_SESSION_HANDLE hSession, CK_BYTE_PTR pRandomData, C
 
     if (CKR_OK == (rv = pkcs11_lock_context(lib_ctx)))
     {
+        /* The session may be closed while the device is held */
+        ATCADevice device = pSession->slot->device_ctx;
+        pkcs11_sched_ticket ticket = PKCS11_SCHED_TICKET_INIT(hSession, 0u, PKCS11_SCHED_PRIO_HIGH);
+
         do
         {
-            if (CKR_OK == (rv = pkcs11_lock_device(lib_ctx)))
+            if (CKR_OK == (rv = pkcs11_lock_device_ext(lib_ctx, &ticket)))
             {
-                rv = pkcs11_util_convert_rv(atcab_random_ext(pSession->slot->device_ctx, buf));
-                (void)pkcs11_unlock_device(lib_ctx);
+                rv = pkcs11_util_convert_rv(atcab_random_ext(device, buf));
+                rv = pkcs11_unlock_device_ext(lib_ctx, &ticket, rv);
             }
 
             if (CKR_OK == rv)
@@ -202,6 +202,7 @@ ATCA_STATUS hal_i2c_send(ATCAIface iface, uint8_t word_address, uint8_t *txdata,
     //ESP_LOGD(TAG, "txdata: %p , txlength: %d", txdata, txlength);
     //ESP_LOG_BUFFER_HEXDUMP(TAG, txdata, txlength, 3);
 
+    TRACE_BEGIN(trace_start);
     i2c_cmd_handle_t cmd = i2c_cmd_link_create();
     (void)i2c_master_start(cmd);
     (void)i2c_master_write_byte(cmd, device_address | I2C_MASTER_WRITE, ACK_CHECK_EN);
@@ -214,6 +215,7 @@ ATCA_STATUS hal_i2c_send(ATCAIface iface, uint8_t word_address, uint8_t *txdata,
     (void)i2c_master_stop(cmd);
     rc = i2c_master_cmd_begin(cfg->atcai2c.bus, cmd, 10);
     (void)i2c_cmd_link_delete(cmd);
+    TRACE_END(trace_start, TRACE_I2C_SEND, device_address, txlength + 1, rc, 0);
 
     if (ESP_OK != rc)
     {
@@ -245,6 +247,7 @@ ATCA_STATUS hal_i2c_receive(ATCAIface iface, uint8_t address, uint8_t *rxdata, u
         return ATCA_TRACE(ATCA_BAD_PARAM, "NULL pointer encountered");
     }
 
+    TRACE_BEGIN(trace_start);
     cmd = i2c_cmd_link_create();
     (void)i2c_master_start(cmd);
     (void)i2c_master_write_byte(cmd, address | I2C_MASTER_READ, ACK_CHECK_EN);
@@ -256,6 +259,7 @@ ATCA_STATUS hal_i2c_receive(ATCAIface iface, uint8_t address, uint8_t *rxdata, u
     (void)i2c_master_stop(cmd);
     rc = i2c_master_cmd_begin(cfg->atcai2c.bus, cmd, 10);
     (void)i2c_cmd_link_delete(cmd);
+    TRACE_END(trace_start, TRACE_I2C_RECEIVE, address, *rxlength, rc, 0);
 
     //ESP_LOG_BUFFER_HEXDUMP(TAG, rxdata, *rxlength, 3);
 
@@ -131,4 +131,64 @@ ATCA_STATUS hal_unlock_mutex(void * pMutex)
     return ATCA_SUCCESS;
 }
 
+ATCA_STATUS hal_create_semaphore(void ** ppSem)
+{
+    if (!ppSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    (*ppSem) = (struct k_sem*)k_malloc(sizeof(struct k_sem));
+
+    if (!*ppSem)
+    {
+        return ATCA_FUNC_FAIL;
+    }
+
+    k_sem_init((struct k_sem*)(*ppSem), 0, 1);
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_destroy_semaphore(void * pSem)
+{
+    if (!pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    k_free(pSem);
+
+    return ATCA_SUCCESS;
+}
+
+ATCA_STATUS hal_wait_semaphore(void * pSem)
+{
+    if (!pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    if (k_sem_take((struct k_sem*)pSem, K_FOREVER))
+    {
+        return ATCA_GEN_FAIL;
+    }
+    else
+    {
+        return ATCA_SUCCESS;
+    }
+}
+
+ATCA_STATUS hal_post_semaphore(void * pSem)
+{
+    if (!pSem)
+    {
+        return ATCA_BAD_PARAM;
+    }
+
+    k_sem_give((struct k_sem*)pSem);
+
+    return ATCA_SUCCESS;
+}
+
 /** @} */
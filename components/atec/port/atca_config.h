@@ -26,6 +26,13 @@ This requires the `esp_idf_version.h' to be defined.
 #if CONFIG_ATCA_MBEDTLS_ECDSA
 #define ATCA_MBEDTLS
 #endif
+
+/* Where to verify signatures made with a supplied public key */
+#if CONFIG_ATCA_VERIFY_POLICY_DEVICE
+#define ATCA_VERIFY_POLICY_DEFAULT  ATCA_VERIFY_POLICY_DEVICE
+#elif CONFIG_ATCA_VERIFY_POLICY_HOST
+#define ATCA_VERIFY_POLICY_DEFAULT  ATCA_VERIFY_POLICY_HOST
+#endif
 //#define ATCA_CA_SUPPORT
 /* Included device support */
 #define ATCA_ATECC608_SUPPORT
@@ -35,6 +42,9 @@ This requires the `esp_idf_version.h' to be defined.
 #define ATCA_TNGTLS_SUPPORT
 #define ATCA_TNGLORA_SUPPORT
 
+/* Keep the rebuilt device/signer certificates in RAM between reads */
+#define ATCACERT_CACHE_EN           1
+
 /* \brief How long to wait after an initial wake failure for the POST to
  *         complete.
  * If Power-on self test (POST) is enabled, the self test will run on waking
@@ -44,9 +54,22 @@ This requires the `esp_idf_version.h' to be defined.
 #define ATCA_POST_DELAY_MSEC 25
 #endif
 
+#if CONFIG_ATCA_POOL
+#include "atca_pool.h"
+#define ATCA_PLATFORM_MALLOC atca_pool_malloc
+#define ATCA_PLATFORM_FREE atca_pool_free
+#else
 #define ATCA_PLATFORM_MALLOC malloc
 #define ATCA_PLATFORM_FREE free
+#endif
+
+/* Microsecond clock for the PKCS#11 scheduler latency statistics */
+#include "esp_timer.h"
+#define PKCS11_SCHED_TIMESTAMP_US() ((uint32_t)esp_timer_get_time())
 
 #define hal_delay_ms atca_delay_ms
 #define ATCA_PRINTF
+
+/* Timing probes in calib_execute_command() and the I2C HAL */
+#include "trace.h"
 #endif // ATCA_CONFIG_H
@@ -0,0 +1,256 @@
+/**
+ * \file
+ * \brief Fixed size class pool behind ATCA_PLATFORM_MALLOC/FREE.
+ *
+ * Each class is a static array of equal blocks with a free list threaded
+ * through the free blocks, so allocating and freeing are a few pointer
+ * operations under a spinlock and the blocks never fragment the heap.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "cryptoauthlib.h"
+#include "calib/calib_command.h"
+#include "atca_pool.h"
+
+static const char *TAG = "atca_pool";
+
+typedef struct pool_block
+{
+    struct pool_block* next;
+} pool_block_t;
+
+typedef struct
+{
+    uint8_t*      base;
+    uint16_t      size;
+    uint16_t      count;
+    pool_block_t* free;
+    uint16_t      used;
+    uint16_t      high_water;
+    uint32_t      allocs;
+    uint32_t      full;
+} pool_class_t;
+
+#define ATCA_POOL_STORAGE(size, count) \
+    static uint8_t pool_ ## size[(count) * (size)] __attribute__((aligned(8)));
+ATCA_POOL_CLASSES(ATCA_POOL_STORAGE)
+
+#define ATCA_POOL_CLASS(size, count) { pool_ ## size, (size), (count), NULL, 0, 0, 0, 0 },
+static pool_class_t classes[ATCA_POOL_CLASS_COUNT] = { ATCA_POOL_CLASSES(ATCA_POOL_CLASS) };
+
+static portMUX_TYPE pool_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool initialized;
+static bool refused;            /* strict mode and the working set does not fit */
+static uint32_t heap_allocs;
+static uint32_t failures;
+
+/* Objects alive at the same time during a session */
+static const struct
+{
+    const char* what;
+    size_t      size;
+    uint16_t    count;
+} working_set[] = {
+    { "device", sizeof(struct atca_device), 1 },
+    { "packet", sizeof(ATCAPacket),         ATCA_POOL_PACKETS },
+};
+
+static bool working_set_fits(void)
+{
+    uint16_t left[ATCA_POOL_CLASS_COUNT];
+    bool fits = true;
+
+    for (size_t c = 0; c < ATCA_POOL_CLASS_COUNT; c++)
+    {
+        left[c] = classes[c].count;
+    }
+    for (size_t i = 0; i < sizeof(working_set) / sizeof(working_set[0]); i++)
+    {
+        for (uint16_t n = 0; n < working_set[i].count; n++)
+        {
+            size_t c = 0;
+            while (c < ATCA_POOL_CLASS_COUNT && (classes[c].size < working_set[i].size || left[c] == 0u))
+            {
+                c++;
+            }
+            if (c == ATCA_POOL_CLASS_COUNT)
+            {
+                ESP_LOGE(TAG, "no block left for %s %u of %u (%u bytes)", working_set[i].what,
+                         (unsigned)n + 1u, (unsigned)working_set[i].count, (unsigned)working_set[i].size);
+                fits = false;
+                break;
+            }
+            left[c]--;
+        }
+    }
+    return fits;
+}
+
+bool atca_pool_init(void)
+{
+    bool fits = working_set_fits();
+    bool built = false;
+    size_t total = 0;
+
+    portENTER_CRITICAL(&pool_mux);
+    if (!initialized)
+    {
+        for (size_t c = 0; c < ATCA_POOL_CLASS_COUNT; c++)
+        {
+            pool_class_t* pc = &classes[c];
+            pc->free = NULL;
+            for (uint16_t i = pc->count; i > 0u; i--)
+            {
+                pool_block_t* block = (pool_block_t*)(pc->base + (size_t)(i - 1u) * pc->size);
+                block->next = pc->free;
+                pc->free = block;
+            }
+        }
+#if CONFIG_ATCA_POOL_STRICT
+        refused = !fits;
+#endif
+        initialized = true;
+        built = true;
+    }
+    portEXIT_CRITICAL(&pool_mux);
+
+    if (!built)
+    {
+        /* Another task got here first and has already reported */
+        return fits;
+    }
+    for (size_t c = 0; c < ATCA_POOL_CLASS_COUNT; c++)
+    {
+        total += (size_t)classes[c].size * classes[c].count;
+    }
+    if (!fits)
+    {
+#if CONFIG_ATCA_POOL_STRICT
+        ESP_LOGE(TAG, "pool too small for the working set, allocations refused");
+#else
+        ESP_LOGW(TAG, "pool too small for the working set, the heap takes the rest");
+#endif
+    }
+    else
+    {
+        ESP_LOGI(TAG, "%u classes, %u bytes", (unsigned)ATCA_POOL_CLASS_COUNT, (unsigned)total);
+    }
+    return fits;
+}
+
+void* atca_pool_malloc(size_t size)
+{
+    void* ptr = NULL;
+    bool fitted = false;
+    bool ready;
+
+    /* Read under the lock: a task that sees the flag set must also see the
+     * free lists the initializing task built */
+    portENTER_CRITICAL(&pool_mux);
+    ready = initialized;
+    portEXIT_CRITICAL(&pool_mux);
+    if (!ready)
+    {
+        (void)atca_pool_init();
+    }
+    if (size == 0u)
+    {
+        return NULL;
+    }
+
+    portENTER_CRITICAL(&pool_mux);
+    if (!refused)
+    {
+        for (size_t c = 0; c < ATCA_POOL_CLASS_COUNT; c++)
+        {
+            pool_class_t* pc = &classes[c];
+            if (pc->size < size)
+            {
+                continue;
+            }
+            if (pc->free == NULL)
+            {
+                if (!fitted)
+                {
+                    pc->full++;
+                }
+                fitted = true;
+                continue;
+            }
+            ptr = pc->free;
+            pc->free = pc->free->next;
+            pc->used++;
+            pc->allocs++;
+            if (pc->used > pc->high_water)
+            {
+                pc->high_water = pc->used;
+            }
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&pool_mux);
+
+#if !CONFIG_ATCA_POOL_STRICT
+    if (ptr == NULL)
+    {
+        ptr = malloc(size);
+        portENTER_CRITICAL(&pool_mux);
+        heap_allocs += (ptr != NULL) ? 1u : 0u;
+        portEXIT_CRITICAL(&pool_mux);
+    }
+#endif
+    if (ptr == NULL)
+    {
+        portENTER_CRITICAL(&pool_mux);
+        failures++;
+        portEXIT_CRITICAL(&pool_mux);
+    }
+    return ptr;
+}
+
+void atca_pool_free(void* ptr)
+{
+    uint8_t* p = (uint8_t*)ptr;
+
+    if (p == NULL)
+    {
+        return;
+    }
+    for (size_t c = 0; c < ATCA_POOL_CLASS_COUNT; c++)
+    {
+        pool_class_t* pc = &classes[c];
+        if (p >= pc->base && p < pc->base + (size_t)pc->count * pc->size)
+        {
+            /* Packets and contexts hold key material */
+            (void)memset(p, 0, pc->size);
+            portENTER_CRITICAL(&pool_mux);
+            ((pool_block_t*)p)->next = pc->free;
+            pc->free = (pool_block_t*)p;
+            pc->used--;
+            portEXIT_CRITICAL(&pool_mux);
+            return;
+        }
+    }
+    free(ptr);
+}
+
+void atca_pool_get_stats(atca_pool_stats_t* stats)
+{
+    portENTER_CRITICAL(&pool_mux);
+    for (size_t c = 0; c < ATCA_POOL_CLASS_COUNT; c++)
+    {
+        stats->classes[c].block_size = classes[c].size;
+        stats->classes[c].blocks = classes[c].count;
+        stats->classes[c].used = classes[c].used;
+        stats->classes[c].high_water = classes[c].high_water;
+        stats->classes[c].allocs = classes[c].allocs;
+        stats->classes[c].full = classes[c].full;
+    }
+    stats->heap_allocs = heap_allocs;
+    stats->failures = failures;
+    portEXIT_CRITICAL(&pool_mux);
+}
@@ -0,0 +1,71 @@
+/* Fixed size class pool for cryptoauthlib allocations */
+#ifndef ATCA_POOL_H
+#define ATCA_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Block size and count of each class, smallest first. Sizes must be
+ * multiples of 8. A request takes a block of the smallest class that fits
+ * and has one free, so a full class spills into the next larger one.
+ *   32:  device, interface and HAL objects
+ *   208: ATCAPacket (200 bytes), one per command in flight
+ *   512: software hash and mbedTLS contexts
+ */
+#ifndef ATCA_POOL_CLASSES
+#define ATCA_POOL_CLASSES(X) \
+    X(32, 8)                 \
+    X(64, 4)                 \
+    X(128, 4)                \
+    X(208, 4)                \
+    X(512, 2)
+#endif
+
+/* ATCA commands in flight at once, for the working set check */
+#ifndef ATCA_POOL_PACKETS
+#define ATCA_POOL_PACKETS 2
+#endif
+
+#define ATCA_POOL_COUNT_CLASS(size, count) + 1
+#define ATCA_POOL_CLASS_COUNT (0 ATCA_POOL_CLASSES(ATCA_POOL_COUNT_CLASS))
+
+typedef struct
+{
+    uint16_t block_size;
+    uint16_t blocks;
+    uint16_t used;
+    uint16_t high_water;    /* most blocks in use at once */
+    uint32_t allocs;
+    uint32_t full;          /* requests that fit this class but found it full */
+} atca_pool_class_stats_t;
+
+typedef struct
+{
+    atca_pool_class_stats_t classes[ATCA_POOL_CLASS_COUNT];
+    uint32_t heap_allocs;   /* larger than any class or the pool was full */
+    uint32_t failures;      /* requests that returned NULL */
+} atca_pool_stats_t;
+
+/** \brief Build the free lists and check that the pool holds the objects
+ *         a session needs at once (device, packets).
+ *
+ * Runs on the first allocation, i.e. from atcab_init(). With
+ * CONFIG_ATCA_POOL_STRICT a pool that is too small refuses every
+ * allocation, so atcab_init() fails instead of a command later on.
+ *
+ * \return true if the working set fits.
+ */
+bool atca_pool_init(void);
+
+/** \brief ATCA_PLATFORM_MALLOC. Constant time; falls back to the heap
+ *         unless CONFIG_ATCA_POOL_STRICT is set.
+ */
+void* atca_pool_malloc(size_t size);
+
+/** \brief ATCA_PLATFORM_FREE. Pool blocks are zeroed before reuse. */
+void atca_pool_free(void* ptr);
+
+void atca_pool_get_stats(atca_pool_stats_t* stats);
+
+#endif /* ATCA_POOL_H */
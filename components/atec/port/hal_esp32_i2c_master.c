@@ -0,0 +1,210 @@
+/* ATECC HAL on an ESP-IDF i2c_master bus shared with other devices */
+#include <string.h>
+#include "driver/i2c_master.h"
+#include "cryptoauthlib.h"
+#include "hal_esp32_i2c_master.h"
+
+/* Per transfer; a command is at most ATCA_CMD_SIZE_MAX bytes and the device
+ * answers within tEXEC, which calib polls for with rx_retries */
+#define HAL_I2C_TIMEOUT_MS      10
+/* Writing 0x00 at 100 kHz holds SDA low long enough to wake the device */
+#define HAL_I2C_WAKE_HZ         100000u
+#define HAL_I2C_TX_MAX          (1u + ATCA_CMD_SIZE_MAX)
+
+typedef struct
+{
+    i2c_master_dev_handle_t dev;        /* the ATECC at its configured address */
+    i2c_master_dev_handle_t wake_dev;   /* general call address, no ACK check */
+    int                     ref_ct;
+} hal_i2c_master_t;
+
+static i2c_master_bus_handle_t hal_bus;
+static hal_i2c_master_t hal_data;
+
+void hal_esp32_i2c_set_bus(i2c_master_bus_handle_t bus)
+{
+    hal_bus = bus;
+}
+
+static uint8_t hal_i2c_address(ATCAIfaceCfg* cfg)
+{
+#ifdef ATCA_ENABLE_DEPRECATED
+    return ATCA_IFACECFG_VALUE(cfg, atcai2c.slave_address);
+#else
+    return ATCA_IFACECFG_VALUE(cfg, atcai2c.address);
+#endif
+}
+
+static void hal_i2c_remove_devices(void)
+{
+    if (NULL != hal_data.dev)
+    {
+        (void)i2c_master_bus_rm_device(hal_data.dev);
+        hal_data.dev = NULL;
+    }
+    if (NULL != hal_data.wake_dev)
+    {
+        (void)i2c_master_bus_rm_device(hal_data.wake_dev);
+        hal_data.wake_dev = NULL;
+    }
+}
+
+/** \brief Add the ATECC and the wake address to the shared bus, once per
+ *         bus user
+ * \param[in] iface  interface being initialized
+ * \param[in] cfg    interface configuration
+ * \return ATCA_SUCCESS on success, otherwise an error code.
+ */
+ATCA_STATUS hal_i2c_init(ATCAIface iface, ATCAIfaceCfg* cfg)
+{
+    esp_err_t rc = ESP_OK;
+
+    if ((NULL == iface) || (NULL == cfg) || (NULL == hal_bus))
+    {
+        return ATCA_TRACE(ATCA_BAD_PARAM, "no i2c_master bus set");
+    }
+
+    if (0 == hal_data.ref_ct)
+    {
+        i2c_device_config_t dev_cfg = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address  = (uint16_t)(hal_i2c_address(cfg) >> 1),
+            .scl_speed_hz    = ATCA_IFACECFG_VALUE(cfg, atcai2c.baud),
+        };
+        i2c_device_config_t wake_cfg = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address  = 0x00,
+            .scl_speed_hz    = HAL_I2C_WAKE_HZ,
+            .flags.disable_ack_check = 1,
+        };
+
+        rc = i2c_master_bus_add_device(hal_bus, &dev_cfg, &hal_data.dev);
+        if (ESP_OK == rc)
+        {
+            rc = i2c_master_bus_add_device(hal_bus, &wake_cfg, &hal_data.wake_dev);
+        }
+        if (ESP_OK != rc)
+        {
+            hal_i2c_remove_devices();
+            return ATCA_COMM_FAIL;
+        }
+    }
+    hal_data.ref_ct++;
+    iface->hal_data = &hal_data;
+
+    return ATCA_SUCCESS;
+}
+
+/** \brief HAL implementation of I2C post init
+ * \param[in] iface  instance
+ * \return ATCA_SUCCESS
+ */
+ATCA_STATUS hal_i2c_post_init(ATCAIface iface)
+{
+    (void)iface;
+    return ATCA_SUCCESS;
+}
+
+/** \brief HAL implementation of I2C send. Address 0 (set by calib for the
+ *         wake pulse) goes to the general call device.
+ * \param[in] iface         instance
+ * \param[in] word_address  device transaction type
+ * \param[in] txdata        pointer to space to bytes to send
+ * \param[in] txlength      number of bytes to send
+ * \return ATCA_SUCCESS on success, otherwise an error code.
+ */
+ATCA_STATUS hal_i2c_send(ATCAIface iface, uint8_t word_address, uint8_t* txdata, int txlength)
+{
+    ATCAIfaceCfg* cfg = atgetifacecfg(iface);
+    hal_i2c_master_t* hal = (NULL != iface) ? (hal_i2c_master_t*)iface->hal_data : NULL;
+    uint8_t buf[HAL_I2C_TX_MAX];
+    size_t len = 1u;
+    uint8_t device_address;
+    esp_err_t rc;
+
+    if ((NULL == cfg) || (NULL == hal) || (txlength < 0) || ((size_t)txlength > sizeof(buf) - 1u))
+    {
+        return ATCA_BAD_PARAM;
+    }
+    device_address = hal_i2c_address(cfg);
+
+    /* One transfer: word address then the packet */
+    buf[0] = word_address;
+    if ((NULL != txdata) && (0 < txlength))
+    {
+        (void)memcpy(&buf[1], txdata, (size_t)txlength);
+        len += (size_t)txlength;
+    }
+
+    TRACE_BEGIN(trace_start);
+    rc = i2c_master_transmit((0u == device_address) ? hal->wake_dev : hal->dev, buf, len, HAL_I2C_TIMEOUT_MS);
+    TRACE_END(trace_start, TRACE_I2C_SEND, device_address, len, rc, 0);
+
+    return (ESP_OK == rc) ? ATCA_SUCCESS : ATCA_COMM_FAIL;
+}
+
+/** \brief HAL implementation of I2C receive function
+ * \param[in]    iface          Device to interact with.
+ * \param[in]    address        Device address
+ * \param[out]   rxdata         Data received will be returned here.
+ * \param[in,out] rxlength      As input, the size of the rxdata buffer.
+ *                              As output, the number of bytes received.
+ * \return ATCA_SUCCESS on success, otherwise an error code.
+ */
+ATCA_STATUS hal_i2c_receive(ATCAIface iface, uint8_t address, uint8_t* rxdata, uint16_t* rxlength)
+{
+    hal_i2c_master_t* hal = (NULL != iface) ? (hal_i2c_master_t*)iface->hal_data : NULL;
+    esp_err_t rc;
+
+    if ((NULL == hal) || (NULL == rxlength) || (NULL == rxdata) || (0u == *rxlength))
+    {
+        return ATCA_TRACE(ATCA_BAD_PARAM, "NULL pointer encountered");
+    }
+
+    TRACE_BEGIN(trace_start);
+    rc = i2c_master_receive(hal->dev, rxdata, *rxlength, HAL_I2C_TIMEOUT_MS);
+    TRACE_END(trace_start, TRACE_I2C_RECEIVE, address, *rxlength, rc, 0);
+
+    return (ESP_OK == rc) ? ATCA_SUCCESS : ATCA_COMM_FAIL;
+}
+
+/** \brief Drop a reference and remove the device handles with the last one.
+ *         The bus itself stays with its owner.
+ * \param[in] hal_data - opaque pointer to hal data structure
+ * \return ATCA_SUCCESS
+ */
+ATCA_STATUS hal_i2c_release(void* hal_data)
+{
+    hal_i2c_master_t* hal = (hal_i2c_master_t*)hal_data;
+
+    if ((NULL != hal) && (0 < hal->ref_ct) && (0 == --hal->ref_ct))
+    {
+        hal_i2c_remove_devices();
+    }
+    return ATCA_SUCCESS;
+}
+
+/** \brief Perform control operations. The ATECC handle keeps the configured
+ *         speed and the wake device runs at 100 kHz, so a baud change has
+ *         nothing to do.
+ * \param[in]     iface          Interface to interact with.
+ * \param[in]     option         Control parameter identifier
+ * \param[in]     param          Optional pointer to parameter value
+ * \param[in]     paramlen       Length of the parameter
+ * \return ATCA_SUCCESS on success, otherwise an error code.
+ */
+ATCA_STATUS hal_i2c_control(ATCAIface iface, uint8_t option, void* param, size_t paramlen)
+{
+    (void)param;
+    (void)paramlen;
+
+    if ((NULL == iface) || (NULL == iface->mIfaceCFG))
+    {
+        return ATCA_BAD_PARAM;
+    }
+    if (ATCA_HAL_CHANGE_BAUD == option)
+    {
+        return ATCA_SUCCESS;
+    }
+    return ATCA_UNIMPLEMENTED;
+}
@@ -0,0 +1,16 @@
+/* ATECC HAL on an ESP-IDF i2c_master bus shared with other devices */
+#ifndef HAL_ESP32_I2C_MASTER_H
+#define HAL_ESP32_I2C_MASTER_H
+
+#include "driver/i2c_master.h"
+
+/** \brief Set the bus the ATECC sits on. Call before atcab_init().
+ *
+ * The bus belongs to the caller (the display uses it too); the HAL only
+ * adds and removes its own device handles on it. The legacy driver/i2c.h
+ * HAL cannot share the pins with it: ESP-IDF aborts at boot when both
+ * drivers are linked.
+ */
+void hal_esp32_i2c_set_bus(i2c_master_bus_handle_t bus);
+
+#endif /* HAL_ESP32_I2C_MASTER_H */
@@ -0,0 +1,20 @@
+/* PKCS#11 slot configuration for the ESP32 port */
+#include "cryptoauthlib.h"
+#include "pkcs11_config.h"
+#include "pkcs11/pkcs11_slot.h"
+
+/** \brief The single slot is the ATECC on the I2C bus set up by
+ *         hal_esp32_i2c_set_bus()
+ * \param[in] pSlot  slot being configured
+ * \return CKR_OK on success, otherwise an error code.
+ */
+CK_RV pkcs11_config_interface(pkcs11_slot_ctx_ptr pSlot)
+{
+    if (NULL == pSlot)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    (void)memcpy(&pSlot->interface_config, &cfg_ateccx08a_i2c_default, sizeof(ATCAIfaceCfg));
+    return CKR_OK;
+}
@@ -180,26 +180,25 @@ int bn_bitcount(const bignum256 *a) {
   return 0;
 }
 
-#define DIGITS 78  // log10(2 ^ 256)
 
 unsigned int bn_digitcount(const bignum256 *a) {
   bignum256 val;
   memcpy(&val, a, sizeof(bignum256));
 
-  unsigned int digits = 1;
+  unsigned int digits = 0;
+  uint32_t limb = 0;
 
-  for (unsigned int i = 0; i < DIGITS; i += 3) {
-    uint32_t limb;
-    bn_divmod1000(&val, &limb);
+  // whole groups of 9 digits, then the digits of the most significant group
+  do {
+    bn_divmod1000000000(&val, &limb);
+    digits += 9;
+  } while (!bn_is_zero(&val));
+  digits -= 9;
 
-    if (limb >= 100) {
-      digits = i + 3;
-    } else if (limb >= 10) {
-      digits = i + 2;
-    } else if (limb >= 1) {
-      digits = i + 1;
-    }
-  }
+  do {
+    digits++;
+    limb /= 10;
+  } while (limb > 0);
 
   return digits;
 }
@@ -834,6 +833,45 @@ void bn_inverse(bignum256 *x, const bignum256 *prime) {
 }
 #endif
 
+// Compute x[i] := x[i]^-1 (mod prime) for i = 0..count-1 with Montgomery's
+// trick: a single bn_inverse plus 3 * (count - 1) multiplications.
+// scratch must have room for count numbers and is cleared on return.
+// the inputs must be partly reduced and must not be 0 mod prime.
+// the results are smaller than prime
+void bn_inverse_batch(bignum256 *x, bignum256 *scratch, size_t count,
+                      const bignum256 *prime) {
+  bignum256 inv, t;
+  size_t i;
+
+  if (count == 0) return;
+
+  // scratch[i] = x[0] * ... * x[i]
+  scratch[0] = x[0];
+  for (i = 1; i < count; i++) {
+    scratch[i] = scratch[i - 1];
+    bn_multiply(&x[i], &scratch[i], prime);
+  }
+
+  inv = scratch[count - 1];
+  bn_mod(&inv, prime);
+  bn_inverse(&inv, prime);
+
+  // invariant: inv = (x[0] * ... * x[i])^-1
+  for (i = count - 1; i > 0; i--) {
+    t = inv;
+    bn_multiply(&scratch[i - 1], &t, prime);
+    bn_multiply(&x[i], &inv, prime);
+    bn_mod(&t, prime);
+    x[i] = t;
+  }
+  bn_mod(&inv, prime);
+  x[0] = inv;
+
+  memzero(&inv, sizeof(inv));
+  memzero(&t, sizeof(t));
+  memzero(scratch, count * sizeof(bignum256));
+}
+
 void bn_normalize(bignum256 *a) { bn_addi(a, 0); }
 
 // add two numbers a = a + b
@@ -945,6 +983,46 @@ void bn_divmod1000(bignum256 *a, uint32_t *r) {
   *r = rem;
 }
 
+// a / 10^9 = a (+r)
+void bn_divmod1000000000(bignum256 *a, uint32_t *r) {
+  // 32-bit targets have no 64-bit divide (it is a libgcc call), so each
+  // limb is a 2-by-1 word division by the reciprocal of the normalized
+  // divisor, see Moller and Granlund, "Improved division by invariant
+  // integers". Only 32x32->64 multiplications are needed.
+  //   d = 10^9 << 2, the top bit set
+  //   v = floor((2^64 - 1) / d) - 2^32
+  const uint32_t d = 4000000000u;
+  const uint32_t v = 316718722u;
+  int i;
+  uint32_t rem, u0, q, tmp;
+  uint64_t p;
+  rem = a->val[8] % 1000000000;
+  a->val[8] /= 1000000000;
+  for (i = 7; i >= 0; i--) {
+    // invariants:
+    //   rem = old(a) >> 30(i+1) % 10^9
+    //   a[i+1..8] = old(a[i+1..8])/10^9
+    //   a[0..i]   = old(a[0..i])
+    // (rem * 2^30 + a[i]) / 10^9 == (rem * 2^32 + a[i] * 4) / d, and
+    // rem < 10^9 so the quotient fits a limb
+    u0 = a->val[i] << 2;
+    p = (uint64_t)v * rem + (((uint64_t)rem << 32) | u0);
+    q = (uint32_t)(p >> 32) + 1;
+    tmp = u0 - q * d;
+    if (tmp > (uint32_t)p) {
+      q--;
+      tmp += d;
+    }
+    if (tmp >= d) {
+      q++;
+      tmp -= d;
+    }
+    a->val[i] = q;
+    rem = tmp >> 2;
+  }
+  *r = rem;
+}
+
 size_t bn_format(const bignum256 *amnt, const char *prefix, const char *suffix,
                  unsigned int decimals, int exponent, bool trailing, char *out,
                  size_t outlen) {
@@ -1004,31 +1082,28 @@ size_t bn_format(const bignum256 *amnt, const char *prefix, const char *suffix,
     BN_FORMAT_PUSH(0);
   }
 
-  unsigned int digits = bn_digitcount(&val);
-  for (unsigned int i = 0; i < digits / 3; i++) {
-    uint32_t limb;
-    bn_divmod1000(&val, &limb);
-
-    BN_FORMAT_PUSH(limb % 10);
-    limb /= 10;
-    BN_FORMAT_PUSH(limb % 10);
-    limb /= 10;
-    BN_FORMAT_PUSH(limb % 10);
-  }
+  // split the number into groups of 9 digits, least significant first;
+  // 10^81 > 2^256, so 9 groups are always enough
+  uint32_t groups[9];
+  unsigned int group_count = 0;
+  do {
+    bn_divmod1000000000(&val, &groups[group_count++]);
+  } while (!bn_is_zero(&val));
 
-  if (digits % 3 != 0) {
-    uint32_t limb;
-    bn_divmod1000(&val, &limb);
+  for (unsigned int i = 0; i < group_count; i++) {
+    uint32_t limb = groups[i];
 
-    switch (digits % 3) {
-      case 2:
+    if (i + 1 < group_count) {
+      for (unsigned int j = 0; j < 9; j++) {
         BN_FORMAT_PUSH(limb % 10);
         limb /= 10;
-        //-fallthrough
-
-      case 1:
+      }
+    } else {
+      // the most significant group is printed without leading zeros
+      do {
         BN_FORMAT_PUSH(limb % 10);
-        break;
+        limb /= 10;
+      } while (limb > 0);
     }
   }
 
@@ -1046,6 +1121,133 @@ size_t bn_format(const bignum256 *amnt, const char *prefix, const char *suffix,
   return prefixlen + len - 1;
 }
 
+// inserts separator between groups of three digits of the integer part of
+// the number that bn_format has written to out
+static size_t bn_format_group(char *out, size_t outlen, size_t len,
+                              size_t prefixlen, size_t suffixlen,
+                              char separator) {
+  char *number = &out[prefixlen];
+  size_t numberlen = len - prefixlen - suffixlen;
+  size_t intlen = 0;
+
+  while (intlen < numberlen && number[intlen] != '.') {
+    intlen++;
+  }
+
+  size_t separators = intlen > 0 ? (intlen - 1) / 3 : 0;
+  if (separators == 0) {
+    return len;
+  }
+  if (len + separators >= outlen) {
+    memzero(out, outlen);
+    return 0;
+  }
+
+  // move the fraction, suffix and trailing 0 out of the way
+  memmove(&number[intlen + separators], &number[intlen],
+          len - prefixlen - intlen + 1);
+
+  // spread the integer digits, starting from the least significant one
+  char *src = &number[intlen], *dst = &number[intlen + separators];
+  for (size_t i = 0; i < intlen; i++) {
+    if (i > 0 && i % 3 == 0) {
+      *--dst = separator;
+    }
+    *--dst = *--src;
+  }
+
+  return len + separators;
+}
+
+#if USE_BN_FORMAT_CACHE
+static int bn_format_cache_index = 0;
+
+static struct {
+  bool set;
+  bignum256 amnt;
+  unsigned int decimals;
+  int exponent;
+  bool trailing;
+  char separator;
+  char prefix[BN_FORMAT_CACHE_AFFIX_LEN];
+  char suffix[BN_FORMAT_CACHE_AFFIX_LEN];
+  size_t len;
+  char out[BN_FORMAT_CACHE_OUT_LEN];
+} bn_format_cache[BN_FORMAT_CACHE_SIZE];
+
+static bool bn_format_cache_affix(char *dst, const char *src) {
+  size_t len = src ? strlen(src) : 0;
+  if (len >= BN_FORMAT_CACHE_AFFIX_LEN) {
+    return false;
+  }
+  memset(dst, 0, BN_FORMAT_CACHE_AFFIX_LEN);
+  if (len) {
+    memcpy(dst, src, len);
+  }
+  return true;
+}
+#endif
+
+// same as bn_format, but the integer part is split into groups of three
+// digits by separator (no grouping if separator is 0).
+// with USE_BN_FORMAT_CACHE the last BN_FORMAT_CACHE_SIZE results are kept,
+// so screens that redraw the same amounts do not convert them again.
+size_t bn_format_amount(const bignum256 *amnt, const char *prefix,
+                        const char *suffix, unsigned int decimals,
+                        int exponent, bool trailing, char separator, char *out,
+                        size_t outlen) {
+#if USE_BN_FORMAT_CACHE
+  char key_prefix[BN_FORMAT_CACHE_AFFIX_LEN];
+  char key_suffix[BN_FORMAT_CACHE_AFFIX_LEN];
+  bool cacheable = bn_format_cache_affix(key_prefix, prefix) &&
+                   bn_format_cache_affix(key_suffix, suffix);
+
+  if (cacheable) {
+    for (int i = 0; i < BN_FORMAT_CACHE_SIZE; i++) {
+      if (bn_format_cache[i].set && bn_format_cache[i].len < outlen &&
+          bn_format_cache[i].decimals == decimals &&
+          bn_format_cache[i].exponent == exponent &&
+          bn_format_cache[i].trailing == trailing &&
+          bn_format_cache[i].separator == separator &&
+          bn_is_equal(&bn_format_cache[i].amnt, amnt) &&
+          memcmp(bn_format_cache[i].prefix, key_prefix,
+                 BN_FORMAT_CACHE_AFFIX_LEN) == 0 &&
+          memcmp(bn_format_cache[i].suffix, key_suffix,
+                 BN_FORMAT_CACHE_AFFIX_LEN) == 0) {
+        memcpy(out, bn_format_cache[i].out, bn_format_cache[i].len + 1);
+        return bn_format_cache[i].len;
+      }
+    }
+  }
+#endif
+
+  size_t len = bn_format(amnt, prefix, suffix, decimals, exponent, trailing,
+                         out, outlen);
+  if (len > 0 && separator != 0) {
+    len = bn_format_group(out, outlen, len, prefix ? strlen(prefix) : 0,
+                          suffix ? strlen(suffix) : 0, separator);
+  }
+
+#if USE_BN_FORMAT_CACHE
+  if (cacheable && len > 0 && len < BN_FORMAT_CACHE_OUT_LEN) {
+    int i = bn_format_cache_index;
+    bn_format_cache[i].set = true;
+    memcpy(&bn_format_cache[i].amnt, amnt, sizeof(bignum256));
+    bn_format_cache[i].decimals = decimals;
+    bn_format_cache[i].exponent = exponent;
+    bn_format_cache[i].trailing = trailing;
+    bn_format_cache[i].separator = separator;
+    memcpy(bn_format_cache[i].prefix, key_prefix, BN_FORMAT_CACHE_AFFIX_LEN);
+    memcpy(bn_format_cache[i].suffix, key_suffix, BN_FORMAT_CACHE_AFFIX_LEN);
+    bn_format_cache[i].len = len;
+    memcpy(bn_format_cache[i].out, out, len + 1);
+    bn_format_cache_index = (i + 1) % BN_FORMAT_CACHE_SIZE;
+  }
+#endif
+
+  return len;
+}
+
 #if USE_BN_PRINT
 void bn_print(const bignum256 *a) {
   printf("%04x", a->val[8] & 0x0000FFFF);
@@ -126,6 +126,9 @@ void bn_sqrt(bignum256 *x, const bignum256 *prime);
 
 void bn_inverse(bignum256 *x, const bignum256 *prime);
 
+void bn_inverse_batch(bignum256 *x, bignum256 *scratch, size_t count,
+                      const bignum256 *prime);
+
 void bn_normalize(bignum256 *a);
 
 void bn_add(bignum256 *a, const bignum256 *b);
@@ -145,10 +148,17 @@ void bn_divmod58(bignum256 *a, uint32_t *r);
 
 void bn_divmod1000(bignum256 *a, uint32_t *r);
 
+void bn_divmod1000000000(bignum256 *a, uint32_t *r);
+
 size_t bn_format(const bignum256 *amnt, const char *prefix, const char *suffix,
                  unsigned int decimals, int exponent, bool trailing, char *out,
                  size_t outlen);
 
+size_t bn_format_amount(const bignum256 *amnt, const char *prefix,
+                        const char *suffix, unsigned int decimals,
+                        int exponent, bool trailing, char separator, char *out,
+                        size_t outlen);
+
 static inline size_t bn_format_uint64(uint64_t amount, const char *prefix,
                                       const char *suffix, unsigned int decimals,
                                       int exponent, bool trailing, char *out,
@@ -458,6 +458,96 @@ int hdnode_public_ckd_cp(const ecdsa_curve *curve, const curve_point *parent,
   }
 }
 
+// children[j] = public child first + j of parent for j = 0..count-1, with
+// the chain codes in child_chain_codes (count * 32 bytes) unless it is NULL.
+// Gives the same keys as calling hdnode_public_ckd_cp for every index, but
+// the HMAC pads are hashed once and the EC work of up to
+// ECDSA_MULTIPLY_BATCH_SIZE children is done by scalar_multiply_add_batch.
+// Returns 0 if the range reaches the hardened indexes.
+int hdnode_public_ckd_cp_batch(const ecdsa_curve *curve,
+                               const curve_point *parent,
+                               const uint8_t *parent_chain_code,
+                               uint32_t first, size_t count,
+                               curve_point *children,
+                               uint8_t *child_chain_codes) {
+  uint8_t data[1 + 32 + 4];
+  uint64_t odig[8], idig[8], g[16];
+  SHA512_CTX ctx;
+  bignum256 c[ECDSA_MULTIPLY_BATCH_SIZE];
+  uint32_t invalid;
+
+  if ((first & 0x80000000) || count > 0x80000000 - first) {
+    return 0;
+  }
+
+  data[0] = 0x02 | (parent->y.val[0] & 0x01);
+  bn_write_be(&parent->x, data + 1);
+  hmac_sha512_prepare(parent_chain_code, 32, odig, idig);
+  memzero(g, sizeof(g));
+  g[8] = 0x8000000000000000;
+  g[15] = (SHA512_BLOCK_LENGTH + SHA512_DIGEST_LENGTH) * 8;
+
+  for (size_t start = 0; start < count; start += ECDSA_MULTIPLY_BATCH_SIZE) {
+    size_t n = count - start;
+    if (n > ECDSA_MULTIPLY_BATCH_SIZE) {
+      n = ECDSA_MULTIPLY_BATCH_SIZE;
+    }
+
+    invalid = 0;
+    for (size_t j = 0; j < n; j++) {
+      // I = HMAC-SHA512(chain code, data) from the precomputed pads
+      write_be(data + 33, first + (uint32_t)(start + j));
+      memcpy(ctx.state, idig, sizeof(idig));
+      ctx.bitcount[0] = SHA512_BLOCK_LENGTH * 8;
+      ctx.bitcount[1] = 0;
+      sha512_Update(&ctx, data, sizeof(data));
+      sha512_Final(&ctx, (uint8_t *)g);
+#if BYTE_ORDER == LITTLE_ENDIAN
+      for (int k = 0; k < 8; k++) {
+        REVERSE64(g[k], g[k]);
+      }
+#endif
+      sha512_Transform(odig, g, g);
+#if BYTE_ORDER == LITTLE_ENDIAN
+      for (int k = 0; k < 8; k++) {
+        REVERSE64(g[k], g[k]);
+      }
+#endif
+      bn_read_be((const uint8_t *)g, &c[j]);
+      if (!bn_is_less(&c[j], &curve->order)) {
+        bn_zero(&c[j]);
+        invalid |= 1u << j;
+      }
+      if (child_chain_codes) {
+        memcpy(child_chain_codes + 32 * (start + j), (const uint8_t *)g + 32,
+               32);
+      }
+    }
+
+    scalar_multiply_add_batch(curve, c, n, parent, children + start);
+
+    // c >= order or an infinite child: the next key in the chain is used,
+    // which hdnode_public_ckd_cp implements (probability below 2^-127)
+    for (size_t j = 0; j < n; j++) {
+      if ((invalid & (1u << j)) || point_is_infinity(&children[start + j])) {
+        hdnode_public_ckd_cp(curve, parent, parent_chain_code,
+                             first + (uint32_t)(start + j),
+                             &children[start + j],
+                             child_chain_codes
+                                 ? child_chain_codes + 32 * (start + j)
+                                 : NULL);
+      }
+    }
+  }
+
+  // Wipe all stack data.
+  memzero(odig, sizeof(odig));
+  memzero(idig, sizeof(idig));
+  memzero(g, sizeof(g));
+  memzero(c, sizeof(c));
+  return 1;
+}
+
 int hdnode_public_ckd(HDNode *inout, uint32_t i) {
   curve_point parent, child;
 
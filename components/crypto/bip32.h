@@ -80,6 +80,13 @@ int hdnode_public_ckd_cp(const ecdsa_curve *curve, const curve_point *parent,
                          const uint8_t *parent_chain_code, uint32_t i,
                          curve_point *child, uint8_t *child_chain_code);
 
+int hdnode_public_ckd_cp_batch(const ecdsa_curve *curve,
+                               const curve_point *parent,
+                               const uint8_t *parent_chain_code,
+                               uint32_t first, size_t count,
+                               curve_point *children,
+                               uint8_t *child_chain_codes);
+
 int hdnode_public_ckd(HDNode *inout, uint32_t i);
 
 void hdnode_public_ckd_address_optimized(const curve_point *pub,
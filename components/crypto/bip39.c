@@ -183,6 +183,15 @@ void mnemonic_to_seed(const char *mnemonic, const char *passphrase,
                       uint8_t seed[512 / 8],
                       void (*progress_callback)(uint32_t current,
                                                 uint32_t total)) {
+  mnemonic_to_seed_cancellable(mnemonic, passphrase, seed, progress_callback,
+                               NULL);
+}
+
+int mnemonic_to_seed_cancellable(const char *mnemonic, const char *passphrase,
+                                 uint8_t seed[512 / 8],
+                                 void (*progress_callback)(uint32_t current,
+                                                           uint32_t total),
+                                 bool (*cancel_callback)(void)) {
   int mnemoniclen = strlen(mnemonic);
   int passphraselen = strnlen(passphrase, 256);
 #if USE_BIP39_CACHE
@@ -194,7 +203,7 @@ void mnemonic_to_seed(const char *mnemonic, const char *passphrase,
       if (strcmp(bip39_cache[i].passphrase, passphrase) != 0) continue;
       // found the correct entry
       memcpy(seed, bip39_cache[i].seed, 512 / 8);
-      return;
+      return 1;
     }
   }
 #endif
@@ -213,6 +222,12 @@ void mnemonic_to_seed(const char *mnemonic, const char *passphrase,
       progress_callback((i + 1) * BIP39_PBKDF2_ROUNDS / 16,
                         BIP39_PBKDF2_ROUNDS);
     }
+    if (cancel_callback && cancel_callback()) {
+      memzero(&pctx, sizeof(pctx));
+      memzero(salt, sizeof(salt));
+      memzero(seed, 512 / 8);
+      return 0;
+    }
   }
   pbkdf2_hmac_sha512_Final(&pctx, seed);
   memzero(salt, sizeof(salt));
@@ -226,6 +241,7 @@ void mnemonic_to_seed(const char *mnemonic, const char *passphrase,
     bip39_cache_index = (bip39_cache_index + 1) % BIP39_CACHE_SIZE;
   }
 #endif
+  return 1;
 }
 
 const char *const *mnemonic_wordlist(void) { return wordlist; }
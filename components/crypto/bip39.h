@@ -24,6 +24,7 @@
 #ifndef __BIP39_H__
 #define __BIP39_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define BIP39_PBKDF2_ROUNDS 2048
@@ -42,6 +43,15 @@ void mnemonic_to_seed(const char *mnemonic, const char *passphrase,
                       void (*progress_callback)(uint32_t current,
                                                 uint32_t total));
 
+// same as mnemonic_to_seed, but cancel_callback (if not NULL) is polled
+// after every progress step; returns 0 and clears seed when it returned
+// true, 1 otherwise
+int mnemonic_to_seed_cancellable(const char *mnemonic, const char *passphrase,
+                                 uint8_t seed[512 / 8],
+                                 void (*progress_callback)(uint32_t current,
+                                                           uint32_t total),
+                                 bool (*cancel_callback)(void));
+
 const char *const *mnemonic_wordlist(void);
 
 #endif
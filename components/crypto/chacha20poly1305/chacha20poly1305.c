@@ -1,9 +1,10 @@
 // Implementations of the XChaCha20 + Poly1305 and ChaCha20 + Poly1305
-// AEAD constructions with a goal of simplicity and correctness rather
-// than performance.
+// AEAD constructions. Encryption and authentication are fused per batch
+// of blocks; see chacha20poly1305_crypt.
 
 #include "chacha20poly1305.h"
 #include "ecrypt-portable.h"
+#include "memzero.h"
 
 void hchacha20(ECRYPT_ctx *x,u8 *c);
 
@@ -35,18 +36,103 @@ void xchacha20poly1305_init(chacha20poly1305_ctx *ctx, const uint8_t key[32], co
     poly1305_init(&ctx->poly1305, block0);
 }
 
+// Fused encrypt-then-MAC kernel. The message is processed in batches of
+// CHACHA20POLY1305_BATCH_BLOCKS blocks so that each batch of ciphertext is
+// fed to Poly1305 while it is still in cache. When decrypting, the MAC is
+// updated before the batch is decrypted so in == out is allowed.
+static void chacha20poly1305_crypt(chacha20poly1305_ctx *ctx, const uint8_t *in, uint8_t *out, size_t n, int encrypt) {
+    while (n > 0) {
+        size_t chunk = n < CHACHA20POLY1305_BATCH_BYTES ? n : CHACHA20POLY1305_BATCH_BYTES;
+        if (!encrypt)
+            poly1305_update(&ctx->poly1305, in, chunk);
+        ECRYPT_encrypt_bytes(&ctx->chacha20, in, out, chunk);
+        if (encrypt)
+            poly1305_update(&ctx->poly1305, out, chunk);
+        in += chunk;
+        out += chunk;
+        n -= chunk;
+    }
+}
+
 // Encrypt n bytes of plaintext where n must be evenly divisible by the
 // Chacha20 blocksize of 64, except for the final n bytes of plaintext.
 void chacha20poly1305_encrypt(chacha20poly1305_ctx *ctx, const uint8_t *in, uint8_t *out, size_t n) {
-    ECRYPT_encrypt_bytes(&ctx->chacha20, in, out, n);
-    poly1305_update(&ctx->poly1305, out, n);
+    chacha20poly1305_crypt(ctx, in, out, n, 1);
 }
 
 // Decrypt n bytes of ciphertext where n must be evenly divisible by the
 // Chacha20 blocksize of 64, except for the final n bytes of ciphertext.
 void chacha20poly1305_decrypt(chacha20poly1305_ctx *ctx, const uint8_t *in, uint8_t *out, size_t n) {
-    poly1305_update(&ctx->poly1305, in, n);
-    ECRYPT_encrypt_bytes(&ctx->chacha20, in, out, n);
+    chacha20poly1305_crypt(ctx, in, out, n, 0);
+}
+
+// Scatter/gather variant of the fused kernel. The fragments form one
+// contiguous message of arbitrary fragment sizes. Keystream left over at
+// the end of a fragment is carried into the next one, so block-aligned
+// runs inside a fragment still take the batched path. The Chacha20 block
+// counter advances exactly as if the fragments had been concatenated.
+static void chacha20poly1305_crypt_iov(chacha20poly1305_ctx *ctx, const chacha20poly1305_iovec *iov, size_t iovcnt, int encrypt) {
+    uint8_t keystream[CHACHA20POLY1305_BATCH_BYTES];
+    size_t ks_pos = 0, ks_len = 0;
+    size_t remaining = 0;
+    size_t i, j;
+
+    for (i = 0; i < iovcnt; i++)
+        remaining += iov[i].len;
+
+    for (i = 0; i < iovcnt; i++) {
+        const uint8_t *in = iov[i].in;
+        uint8_t *out = iov[i].out;
+        size_t n = iov[i].len;
+
+        while (n > 0) {
+            size_t take;
+
+            // Stream is block aligned: run whole blocks through the
+            // batched kernel directly on the fragment.
+            if (ks_pos == ks_len && n >= 64) {
+                take = n & ~(size_t)63;
+                chacha20poly1305_crypt(ctx, in, out, take, encrypt);
+            } else {
+                if (ks_pos == ks_len) {
+                    size_t blocks = (remaining + 63) / 64;
+                    if (blocks > CHACHA20POLY1305_BATCH_BLOCKS)
+                        blocks = CHACHA20POLY1305_BATCH_BLOCKS;
+                    ks_len = blocks * 64;
+                    ks_pos = 0;
+                    ECRYPT_keystream_bytes(&ctx->chacha20, keystream, ks_len);
+                }
+                take = ks_len - ks_pos;
+                if (take > n)
+                    take = n;
+                if (!encrypt)
+                    poly1305_update(&ctx->poly1305, in, take);
+                for (j = 0; j < take; j++)
+                    out[j] = in[j] ^ keystream[ks_pos + j];
+                if (encrypt)
+                    poly1305_update(&ctx->poly1305, out, take);
+                ks_pos += take;
+            }
+            in += take;
+            out += take;
+            n -= take;
+            remaining -= take;
+        }
+    }
+
+    memzero(keystream, sizeof(keystream));
+}
+
+// Encrypt a message given as a list of fragments. The same length rule as
+// chacha20poly1305_encrypt applies to the total length of each call.
+void chacha20poly1305_encrypt_iov(chacha20poly1305_ctx *ctx, const chacha20poly1305_iovec *iov, size_t iovcnt) {
+    chacha20poly1305_crypt_iov(ctx, iov, iovcnt, 1);
+}
+
+// Decrypt a message given as a list of fragments. The same length rule as
+// chacha20poly1305_decrypt applies to the total length of each call.
+void chacha20poly1305_decrypt_iov(chacha20poly1305_ctx *ctx, const chacha20poly1305_iovec *iov, size_t iovcnt) {
+    chacha20poly1305_crypt_iov(ctx, iov, iovcnt, 0);
 }
 
 // Include authenticated data in the Poly1305 MAC.
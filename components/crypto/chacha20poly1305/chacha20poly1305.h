@@ -10,9 +10,24 @@ typedef struct {
     poly1305_context poly1305;
 } chacha20poly1305_ctx;
 
+// Number of Chacha20 blocks encrypted and authenticated per iteration of
+// the fused encrypt-then-MAC kernel.
+#define CHACHA20POLY1305_BATCH_BLOCKS 4
+#define CHACHA20POLY1305_BATCH_BYTES  (64 * CHACHA20POLY1305_BATCH_BLOCKS)
+
+// One fragment of a scatter/gather message. in and out may be equal for
+// in-place operation.
+typedef struct {
+    const uint8_t *in;
+    uint8_t       *out;
+    size_t         len;
+} chacha20poly1305_iovec;
+
 void xchacha20poly1305_init(chacha20poly1305_ctx *ctx, const uint8_t key[32], const uint8_t nonce[24]);
 void chacha20poly1305_encrypt(chacha20poly1305_ctx *ctx, const uint8_t *in, uint8_t *out, size_t n);
 void chacha20poly1305_decrypt(chacha20poly1305_ctx *ctx, const uint8_t *in, uint8_t *out, size_t n);
+void chacha20poly1305_encrypt_iov(chacha20poly1305_ctx *ctx, const chacha20poly1305_iovec *iov, size_t iovcnt);
+void chacha20poly1305_decrypt_iov(chacha20poly1305_ctx *ctx, const chacha20poly1305_iovec *iov, size_t iovcnt);
 void chacha20poly1305_auth(chacha20poly1305_ctx *ctx, const uint8_t *in, size_t n);
 void chacha20poly1305_finish(chacha20poly1305_ctx *ctx, uint8_t mac[16]);
 
@@ -210,10 +210,11 @@ void curve_to_jacobian(const curve_point *p, jacobian_curve_point *jp,
   bn_multiply(&p->y, &jp->y, prime);
 }
 
-void jacobian_to_curve(const jacobian_curve_point *jp, curve_point *p,
-                       const bignum256 *prime) {
-  p->y = jp->z;
-  bn_inverse(&p->y, prime);
+// same as jacobian_to_curve, but with z^-1 already computed by the caller
+static void jacobian_to_curve_zinv(const jacobian_curve_point *jp,
+                                   const bignum256 *zinv, curve_point *p,
+                                   const bignum256 *prime) {
+  p->y = *zinv;
   // p->y = z^-1
   p->x = p->y;
   bn_multiply(&p->x, &p->x, prime);
@@ -228,6 +229,14 @@ void jacobian_to_curve(const jacobian_curve_point *jp, curve_point *p,
   bn_mod(&p->y, prime);
 }
 
+void jacobian_to_curve(const jacobian_curve_point *jp, curve_point *p,
+                       const bignum256 *prime) {
+  bignum256 zinv = jp->z;
+  bn_inverse(&zinv, prime);
+  jacobian_to_curve_zinv(jp, &zinv, p, prime);
+  memzero(&zinv, sizeof(zinv));
+}
+
 void point_jacobian_add(const curve_point *p1, jacobian_curve_point *p2,
                         const ecdsa_curve *curve) {
   bignum256 r, h, r2;
@@ -415,9 +424,48 @@ void point_jacobian_double(jacobian_curve_point *p, const ecdsa_curve *curve) {
   bn_fast_mod(&p->y, prime);
 }
 
-// res = k * p
-void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
-                    const curve_point *p, curve_point *res) {
+// pmult[i] = (2*i+1) * p
+static void point_multiply_table(const ecdsa_curve *curve, const curve_point *p,
+                                 curve_point pmult[8]) {
+  int i;
+  // We compute p, 3*p, ..., 15*p and store it in the table pmult.
+  // store p^2 temporarily in pmult[7]
+  pmult[7] = *p;
+  point_double(curve, &pmult[7]);
+  pmult[0] = *p;
+  if (point_is_infinity(p)) {
+    for (i = 1; i < 8; i++) {
+      pmult[i] = pmult[7];
+    }
+    return;
+  }
+  // compute 3*p, etc by repeatedly adding p^2 in jacobian coordinates and
+  // convert them with one inversion. None of them is infinity or needs a
+  // doubling, as p has a large order on the supported curves.
+  jacobian_curve_point jp[7];
+  bignum256 zinv[7], scratch[7];
+  curve_to_jacobian(p, &jp[0], &curve->prime);
+  point_jacobian_add(&pmult[7], &jp[0], curve);
+  for (i = 1; i < 7; i++) {
+    jp[i] = jp[i - 1];
+    point_jacobian_add(&pmult[7], &jp[i], curve);
+  }
+  for (i = 0; i < 7; i++) {
+    zinv[i] = jp[i].z;
+  }
+  bn_inverse_batch(zinv, scratch, 7, &curve->prime);
+  for (i = 0; i < 7; i++) {
+    jacobian_to_curve_zinv(&jp[i], &zinv[i], &pmult[i + 1], &curve->prime);
+  }
+  memzero(jp, sizeof(jp));
+  memzero(zinv, sizeof(zinv));
+}
+
+// jres = k * p in jacobian coordinates, pmult as set by point_multiply_table
+// returns 0 if k is zero (jres is not set), 1 otherwise
+static int point_multiply_jacobian(const ecdsa_curve *curve, const bignum256 *k,
+                                   const curve_point pmult[8],
+                                   jacobian_curve_point *jres) {
   // this algorithm is loosely based on
   //  Katsuyuki Okeya and Tsuyoshi Takagi, The Width-w NAF Method Provides
   //  Small Memory and Fast Elliptic Scalar Multiplications Secure against
@@ -431,8 +479,6 @@ void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
   int ashift;
   uint32_t is_even = (k->val[0] & 1) - 1;
   uint32_t bits, sign, nsign;
-  static CONFIDENTIAL jacobian_curve_point jres;
-  curve_point pmult[8];
   const bignum256 *prime = &curve->prime;
 
   // is_even = 0xffffffff if k is even, 0 otherwise.
@@ -453,8 +499,7 @@ void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
 
   // special case 0*p:  just return zero. We don't care about constant time.
   if (!is_non_zero) {
-    point_set_infinity(res);
-    return;
+    return 0;
   }
 
   // Now a = k + 2^256 (mod curve->order) and a is odd.
@@ -468,18 +513,8 @@ void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
   // Since k = a - 2^256 (mod curve->order), we can compute
   //   k*p = sum_{i=0..63} a[i] 16^i * p
   //
-  // We compute |a[i]| * p in advance for all possible
+  // |a[i]| * p was computed in advance for all possible
   // values of |a[i]| * p.  pmult[i] = (2*i+1) * p
-  // We compute p, 3*p, ..., 15*p and store it in the table pmult.
-  // store p^2 temporarily in pmult[7]
-  pmult[7] = *p;
-  point_double(curve, &pmult[7]);
-  // compute 3*p, etc by repeatedly adding p^2.
-  pmult[0] = *p;
-  for (i = 1; i < 8; i++) {
-    pmult[i] = pmult[7];
-    point_add(curve, &pmult[i - 1], &pmult[i]);
-  }
 
   // now compute  res = sum_{i=0..63} a[i] * 16^i * p step by step,
   // starting with i = 63.
@@ -495,16 +530,16 @@ void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
   sign = (bits >> 4) - 1;
   bits ^= sign;
   bits &= 15;
-  curve_to_jacobian(&pmult[bits >> 1], &jres, prime);
+  curve_to_jacobian(&pmult[bits >> 1], jres, prime);
   for (i = 62; i >= 0; i--) {
     // sign = sign(a[i+1])  (0xffffffff for negative, 0 for positive)
     // invariant jres = (-1)^sign sum_{j=i+1..63} (a[j] * 16^{j-i-1} * p)
     // abits >> (ashift - 4) = lowbits(a >> (i*4))
 
-    point_jacobian_double(&jres, curve);
-    point_jacobian_double(&jres, curve);
-    point_jacobian_double(&jres, curve);
-    point_jacobian_double(&jres, curve);
+    point_jacobian_double(jres, curve);
+    point_jacobian_double(jres, curve);
+    point_jacobian_double(jres, curve);
+    point_jacobian_double(jres, curve);
 
     // get lowest 5 bits of a >> (i*4).
     ashift -= 4;
@@ -525,31 +560,46 @@ void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
 
     // negate last result to make signs of this round and the
     // last round equal.
-    conditional_negate(sign ^ nsign, &jres.z, prime);
+    conditional_negate(sign ^ nsign, &jres->z, prime);
 
     // add odd factor
-    point_jacobian_add(&pmult[bits >> 1], &jres, curve);
+    point_jacobian_add(&pmult[bits >> 1], jres, curve);
     sign = nsign;
   }
-  conditional_negate(sign, &jres.z, prime);
-  jacobian_to_curve(&jres, res, prime);
+  conditional_negate(sign, &jres->z, prime);
   memzero(&a, sizeof(a));
+  return 1;
+}
+
+// res = k * p
+void point_multiply(const ecdsa_curve *curve, const bignum256 *k,
+                    const curve_point *p, curve_point *res) {
+  static CONFIDENTIAL jacobian_curve_point jres;
+  curve_point pmult[8];
+
+  point_multiply_table(curve, p, pmult);
+  if (point_multiply_jacobian(curve, k, pmult, &jres)) {
+    jacobian_to_curve(&jres, res, &curve->prime);
+  } else {
+    point_set_infinity(res);
+  }
   memzero(&jres, sizeof(jres));
 }
 
 #if USE_PRECOMPUTED_CP
 
-// res = k * G
+// jres = k * G in jacobian coordinates
 // k must be a normalized number with 0 <= k < curve->order
-void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
-                     curve_point *res) {
+// returns 0 if k is zero (jres is not set), 1 otherwise
+static int scalar_multiply_jacobian(const ecdsa_curve *curve,
+                                    const bignum256 *k,
+                                    jacobian_curve_point *jres) {
   assert(bn_is_less(k, &curve->order));
 
   int i, j;
   static CONFIDENTIAL bignum256 a;
   uint32_t is_even = (k->val[0] & 1) - 1;
   uint32_t lowbits;
-  static CONFIDENTIAL jacobian_curve_point jres;
   const bignum256 *prime = &curve->prime;
 
   // is_even = 0xffffffff if k is even, 0 otherwise.
@@ -570,8 +620,7 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
 
   // special case 0*G:  just return zero. We don't care about constant time.
   if (!is_non_zero) {
-    point_set_infinity(res);
-    return;
+    return 0;
   }
 
   // Now a = k + 2^256 (mod curve->order) and a is odd.
@@ -597,7 +646,7 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
   lowbits = a.val[0] & ((1 << 5) - 1);
   lowbits ^= (lowbits >> 4) - 1;
   lowbits &= 15;
-  curve_to_jacobian(&curve->cp[0][lowbits >> 1], &jres, prime);
+  curve_to_jacobian(&curve->cp[0][lowbits >> 1], jres, prime);
   for (i = 1; i < 64; i++) {
     // invariant res = sign(a[i-1]) sum_{j=0..i-1} (a[j] * 16^j * G)
 
@@ -614,14 +663,27 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
     lowbits &= 15;
     // negate last result to make signs of this round and the
     // last round equal.
-    conditional_negate((lowbits & 1) - 1, &jres.y, prime);
+    conditional_negate((lowbits & 1) - 1, &jres->y, prime);
 
     // add odd factor
-    point_jacobian_add(&curve->cp[i][lowbits >> 1], &jres, curve);
+    point_jacobian_add(&curve->cp[i][lowbits >> 1], jres, curve);
   }
-  conditional_negate(((a.val[0] >> 4) & 1) - 1, &jres.y, prime);
-  jacobian_to_curve(&jres, res, prime);
+  conditional_negate(((a.val[0] >> 4) & 1) - 1, &jres->y, prime);
   memzero(&a, sizeof(a));
+  return 1;
+}
+
+// res = k * G
+// k must be a normalized number with 0 <= k < curve->order
+void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
+                     curve_point *res) {
+  static CONFIDENTIAL jacobian_curve_point jres;
+
+  if (scalar_multiply_jacobian(curve, k, &jres)) {
+    jacobian_to_curve(&jres, res, &curve->prime);
+  } else {
+    point_set_infinity(res);
+  }
   memzero(&jres, sizeof(jres));
 }
 
@@ -634,6 +696,67 @@ void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
 
 #endif
 
+// res[i] = k[i] * G + p for i = 0..count-1
+// k[i] must be normalized numbers with 0 <= k[i] < curve->order
+// gives the same points as scalar_multiply followed by point_add, but the
+// table of odd multiples of G is built once per call and the results of up
+// to ECDSA_MULTIPLY_BATCH_SIZE scalars are converted to affine coordinates
+// with one bn_inverse_batch. Meant for deriving many public keys.
+void scalar_multiply_add_batch(const ecdsa_curve *curve, const bignum256 *k,
+                               size_t count, const curve_point *p,
+                               curve_point *res) {
+  jacobian_curve_point jres[ECDSA_MULTIPLY_BATCH_SIZE];
+  bignum256 zinv[ECDSA_MULTIPLY_BATCH_SIZE], scratch[ECDSA_MULTIPLY_BATCH_SIZE];
+  uint32_t infinity;
+  const bignum256 *prime = &curve->prime;
+#if !USE_PRECOMPUTED_CP
+  curve_point pmult[8];
+  point_multiply_table(curve, &curve->G, pmult);
+#endif
+
+  for (size_t start = 0; start < count; start += ECDSA_MULTIPLY_BATCH_SIZE) {
+    size_t n = count - start;
+    if (n > ECDSA_MULTIPLY_BATCH_SIZE) {
+      n = ECDSA_MULTIPLY_BATCH_SIZE;
+    }
+
+    infinity = 0;
+    for (size_t i = 0; i < n; i++) {
+#if USE_PRECOMPUTED_CP
+      int ok = scalar_multiply_jacobian(curve, &k[start + i], &jres[i]);
+#else
+      int ok = point_multiply_jacobian(curve, &k[start + i], pmult, &jres[i]);
+#endif
+      if (ok) {
+        point_jacobian_add(p, &jres[i], curve);
+      } else {
+        curve_to_jacobian(p, &jres[i], prime);
+      }
+      // z is 0 mod prime iff k[i] * G = -p; bn_inverse_batch needs
+      // non-zero inputs, so invert 1 instead and drop the result.
+      zinv[i] = jres[i].z;
+      bn_mod(&zinv[i], prime);
+      if (bn_is_zero(&zinv[i])) {
+        bn_one(&zinv[i]);
+        infinity |= 1u << i;
+      }
+    }
+
+    bn_inverse_batch(zinv, scratch, n, prime);
+
+    for (size_t i = 0; i < n; i++) {
+      if (infinity & (1u << i)) {
+        point_set_infinity(&res[start + i]);
+      } else {
+        jacobian_to_curve_zinv(&jres[i], &zinv[i], &res[start + i], prime);
+      }
+    }
+  }
+
+  memzero(jres, sizeof(jres));
+  memzero(zinv, sizeof(zinv));
+}
+
 int ecdh_multiply(const ecdsa_curve *curve, const uint8_t *priv_key,
                   const uint8_t *pub_key, uint8_t *session_key) {
   curve_point point;
@@ -766,6 +889,127 @@ int ecdsa_sign_digest(const ecdsa_curve *curve, const uint8_t *priv_key,
   return -1;
 }
 
+// signs count digests with the same private key
+// digests is count * 32 bytes, sigs is count * 64 bytes and pby is either
+// NULL or count bytes; the output is the same as calling ecdsa_sign_digest
+// for every digest, and with USE_RFC6979 every signature stays deterministic.
+// The private key is read once and the table of odd multiples of G is built
+// once per call. The Jacobian z and the k inversions of up to
+// ECDSA_SIGN_BATCH_SIZE signatures are done together with bn_inverse_batch.
+// Signatures rejected after the first k (r or s zero, not canonical) are
+// rare and are redone by ecdsa_sign_digest.
+int ecdsa_sign_digest_batch(const ecdsa_curve *curve, const uint8_t *priv_key,
+                            const uint8_t *digests, size_t count, uint8_t *sigs,
+                            uint8_t *pby,
+                            int (*is_canonical)(uint8_t by, uint8_t sig[64])) {
+  bignum256 priv;
+  bignum256 k[ECDSA_SIGN_BATCH_SIZE], randk[ECDSA_SIGN_BATCH_SIZE];
+  bignum256 zinv[ECDSA_SIGN_BATCH_SIZE], scratch[ECDSA_SIGN_BATCH_SIZE];
+  jacobian_curve_point jR[ECDSA_SIGN_BATCH_SIZE];
+  curve_point R;
+  bignum256 *s = &R.y;
+  uint8_t by;
+  int res = 0;
+#if !USE_PRECOMPUTED_CP
+  curve_point pmult[8];
+  point_multiply_table(curve, &curve->G, pmult);
+#endif
+#if USE_RFC6979
+  rfc6979_state rng;
+#endif
+
+  bn_read_be(priv_key, &priv);
+
+  for (size_t start = 0; start < count && res == 0;
+       start += ECDSA_SIGN_BATCH_SIZE) {
+    size_t n = count - start;
+    if (n > ECDSA_SIGN_BATCH_SIZE) {
+      n = ECDSA_SIGN_BATCH_SIZE;
+    }
+
+    // k_i * G in jacobian coordinates
+    for (size_t i = 0; i < n; i++) {
+#if USE_RFC6979
+      init_rfc6979(priv_key, digests + 32 * (start + i), &rng);
+      do {
+        generate_k_rfc6979(&k[i], &rng);
+      } while (bn_is_zero(&k[i]) || !bn_is_less(&k[i], &curve->order));
+#else
+      generate_k_random(&k[i], &curve->order);
+#endif
+#if USE_PRECOMPUTED_CP
+      scalar_multiply_jacobian(curve, &k[i], &jR[i]);
+#else
+      point_multiply_jacobian(curve, &k[i], pmult, &jR[i]);
+#endif
+      zinv[i] = jR[i].z;
+
+      // randomize operations to counter side-channel attacks
+      generate_k_random(&randk[i], &curve->order);
+      bn_multiply(&randk[i], &k[i], &curve->order);  // k*rand
+    }
+
+    bn_inverse_batch(zinv, scratch, n, &curve->prime);
+    bn_inverse_batch(k, scratch, n, &curve->order);  // (k*rand)^-1
+
+    for (size_t i = 0; i < n && res == 0; i++) {
+      uint8_t *sig = sigs + 64 * (start + i);
+      int ok = 0;
+
+      jacobian_to_curve_zinv(&jR[i], &zinv[i], &R, &curve->prime);
+      by = R.y.val[0] & 1;
+      // r = (rx mod n)
+      if (!bn_is_less(&R.x, &curve->order)) {
+        bn_subtract(&R.x, &curve->order, &R.x);
+        by |= 2;
+      }
+
+      if (!bn_is_zero(&R.x)) {
+        *s = priv;
+        bn_multiply(&R.x, s, &curve->order);  // R.x*priv
+        bn_read_be(digests + 32 * (start + i), &zinv[i]);
+        bn_add(s, &zinv[i]);                   // R.x*priv + z
+        bn_multiply(&k[i], s, &curve->order);  // (k*rand)^-1 (R.x*priv + z)
+        bn_multiply(&randk[i], s, &curve->order);  // k^-1 (R.x*priv + z)
+        bn_mod(s, &curve->order);
+
+        if (!bn_is_zero(s)) {
+          // if S > order/2 => S = -S
+          if (bn_is_less(&curve->order_half, s)) {
+            bn_subtract(&curve->order, s, s);
+            by ^= 1;
+          }
+          bn_write_be(&R.x, sig);
+          bn_write_be(s, sig + 32);
+          ok = !is_canonical || is_canonical(by, sig);
+        }
+      }
+
+      if (ok) {
+        if (pby) {
+          pby[start + i] = by;
+        }
+      } else {
+        // the first k was rejected, let the single path retry
+        res = ecdsa_sign_digest(curve, priv_key, digests + 32 * (start + i),
+                                sig, pby ? pby + start + i : NULL,
+                                is_canonical);
+      }
+    }
+  }
+
+  memzero(&priv, sizeof(priv));
+  memzero(k, sizeof(k));
+  memzero(randk, sizeof(randk));
+  memzero(zinv, sizeof(zinv));
+  memzero(jR, sizeof(jR));
+  memzero(&R, sizeof(R));
+#if USE_RFC6979
+  memzero(&rng, sizeof(rng));
+#endif
+  return res;
+}
+
 void ecdsa_get_public_key33(const ecdsa_curve *curve, const uint8_t *priv_key,
                             uint8_t *pub_key) {
   curve_point R;
@@ -73,6 +73,9 @@ int point_is_equal(const curve_point *p, const curve_point *q);
 int point_is_negative_of(const curve_point *p, const curve_point *q);
 void scalar_multiply(const ecdsa_curve *curve, const bignum256 *k,
                      curve_point *res);
+void scalar_multiply_add_batch(const ecdsa_curve *curve, const bignum256 *k,
+                               size_t count, const curve_point *p,
+                               curve_point *res);
 int ecdh_multiply(const ecdsa_curve *curve, const uint8_t *priv_key,
                   const uint8_t *pub_key, uint8_t *session_key);
 void compress_coords(const curve_point *cp, uint8_t *compressed);
@@ -88,6 +91,10 @@ int ecdsa_sign(const ecdsa_curve *curve, HasherType hasher_sign,
 int ecdsa_sign_digest(const ecdsa_curve *curve, const uint8_t *priv_key,
                       const uint8_t *digest, uint8_t *sig, uint8_t *pby,
                       int (*is_canonical)(uint8_t by, uint8_t sig[64]));
+int ecdsa_sign_digest_batch(const ecdsa_curve *curve, const uint8_t *priv_key,
+                            const uint8_t *digests, size_t count, uint8_t *sigs,
+                            uint8_t *pby,
+                            int (*is_canonical)(uint8_t by, uint8_t sig[64]));
 void ecdsa_get_public_key33(const ecdsa_curve *curve, const uint8_t *priv_key,
                             uint8_t *pub_key);
 void ecdsa_get_public_key65(const ecdsa_curve *curve, const uint8_t *priv_key,
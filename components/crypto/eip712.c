@@ -0,0 +1,577 @@
+#include "eip712.h"
+
+#include <string.h>
+
+#include "memzero.h"
+
+#define EIP712_MAX_TYPES 32
+
+typedef enum {
+  EIP712_UINT,
+  EIP712_INT,
+  EIP712_BOOL,
+  EIP712_ADDRESS,
+  EIP712_FIXED_BYTES,
+  EIP712_DYNAMIC,
+  EIP712_STRUCT,
+  EIP712_ARRAY,
+  EIP712_INVALID,
+} eip712_kind;
+
+static int find_struct(const eip712_types *types, const char *name,
+                       size_t len) {
+  for (size_t i = 0; i < types->count; i++) {
+    const char *s = types->structs[i].name;
+    if (strlen(s) == len && memcmp(s, name, len) == 0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+// reads the decimal number in type[0..len), 0 if there is none
+static uint32_t parse_size(const char *type, size_t len) {
+  uint32_t n = 0;
+  if (len == 0 || len > 4) {
+    return 0;
+  }
+  for (size_t i = 0; i < len; i++) {
+    if (type[i] < '0' || type[i] > '9') {
+      return 0;
+    }
+    n = n * 10 + (uint32_t)(type[i] - '0');
+  }
+  return n;
+}
+
+// classifies type[0..len); param is the size in bytes of integers and
+// bytesN, the struct index, or the length of an array (0 if dynamic)
+static eip712_kind parse_type(const eip712_types *types, const char *type,
+                              size_t len, uint32_t *param) {
+  uint32_t n;
+
+  if (len > 0 && type[len - 1] == ']') {
+    size_t open = len - 1;
+    while (open > 0 && type[open] != '[') {
+      open--;
+    }
+    if (type[open] != '[' || open == 0) {
+      return EIP712_INVALID;
+    }
+    n = parse_size(type + open + 1, len - open - 2);
+    if (n == 0 && len - open - 2 != 0) {
+      return EIP712_INVALID;
+    }
+    *param = n;
+    return EIP712_ARRAY;
+  }
+  if ((len == 6 && memcmp(type, "string", 6) == 0) ||
+      (len == 5 && memcmp(type, "bytes", 5) == 0)) {
+    return EIP712_DYNAMIC;
+  }
+  if (len == 4 && memcmp(type, "bool", 4) == 0) {
+    return EIP712_BOOL;
+  }
+  if (len == 7 && memcmp(type, "address", 7) == 0) {
+    return EIP712_ADDRESS;
+  }
+  if (len > 5 && memcmp(type, "bytes", 5) == 0) {
+    n = parse_size(type + 5, len - 5);
+    if (n < 1 || n > 32) {
+      return EIP712_INVALID;
+    }
+    *param = n;
+    return EIP712_FIXED_BYTES;
+  }
+  if (len > 4 && memcmp(type, "uint", 4) == 0) {
+    n = parse_size(type + 4, len - 4);
+  } else if (len > 3 && memcmp(type, "int", 3) == 0) {
+    n = parse_size(type + 3, len - 3);
+  } else {
+    int index = find_struct(types, type, len);
+    if (index < 0) {
+      return EIP712_INVALID;
+    }
+    *param = (uint32_t)index;
+    return EIP712_STRUCT;
+  }
+  if (n < 8 || n > 256 || n % 8 != 0) {
+    return EIP712_INVALID;
+  }
+  *param = n / 8;
+  return type[0] == 'u' ? EIP712_UINT : EIP712_INT;
+}
+
+// length of type without its array suffixes
+static size_t base_type_len(const char *type) {
+  const char *bracket = strchr(type, '[');
+  return bracket ? (size_t)(bracket - type) : strlen(type);
+}
+
+// encodeType goes to buf while it fits, or to sha when that is set
+typedef struct {
+  char *buf;
+  size_t cap;
+  size_t len;
+  SHA3_CTX *sha;
+} type_writer;
+
+static void type_put(type_writer *w, const char *s, size_t n) {
+  if (w->sha) {
+    keccak_Update(w->sha, (const uint8_t *)s, n);
+  } else if (w->len + n <= w->cap) {
+    memcpy(w->buf + w->len, s, n);
+  }
+  w->len += n;
+}
+
+static void encode_struct(type_writer *w, const eip712_struct *s) {
+  type_put(w, s->name, strlen(s->name));
+  type_put(w, "(", 1);
+  for (size_t i = 0; i < s->member_count; i++) {
+    if (i > 0) {
+      type_put(w, ",", 1);
+    }
+    type_put(w, s->members[i].type, strlen(s->members[i].type));
+    type_put(w, " ", 1);
+    type_put(w, s->members[i].name, strlen(s->members[i].name));
+  }
+  type_put(w, ")", 1);
+}
+
+// the struct itself followed by the structs it refers to, sorted by name
+static void encode_type(type_writer *w, const eip712_types *types,
+                        size_t index) {
+  uint32_t deps = 1u << index, seen = 0;
+
+  while (deps != seen) {
+    for (size_t i = 0; i < types->count; i++) {
+      if ((deps & ~seen) & (1u << i)) {
+        const eip712_struct *s = &types->structs[i];
+        seen |= 1u << i;
+        for (size_t m = 0; m < s->member_count; m++) {
+          const char *type = s->members[m].type;
+          int j = find_struct(types, type, base_type_len(type));
+          if (j >= 0) {
+            deps |= 1u << j;
+          }
+        }
+      }
+    }
+  }
+
+  encode_struct(w, &types->structs[index]);
+  deps &= ~(1u << index);
+  while (deps) {
+    size_t first = 0;
+    for (size_t i = 0; i < types->count; i++) {
+      if ((deps & (1u << i)) &&
+          (!(deps & (1u << first)) ||
+           strcmp(types->structs[i].name, types->structs[first].name) < 0)) {
+        first = i;
+      }
+    }
+    encode_struct(w, &types->structs[first]);
+    deps &= ~(1u << first);
+  }
+}
+
+#if USE_EIP712_CACHE
+static int type_cache_index = 0;
+
+static struct {
+  bool set;
+  size_t len;
+  char encoded[EIP712_TYPE_CACHE_LEN];
+  uint8_t hash[32];
+} type_cache[EIP712_TYPE_CACHE_SIZE];
+#endif
+
+int eip712_type_hash(const eip712_types *types, size_t index,
+                     uint8_t hash[32]) {
+  SHA3_CTX sha;
+
+  if (types->count > EIP712_MAX_TYPES || index >= types->count) {
+    return 0;
+  }
+#if USE_EIP712_CACHE
+  char encoded[EIP712_TYPE_CACHE_LEN];
+  type_writer key = {.buf = encoded, .cap = sizeof(encoded)};
+
+  // building the string is much cheaper than hashing it
+  encode_type(&key, types, index);
+  if (key.len <= sizeof(encoded)) {
+    for (int i = 0; i < EIP712_TYPE_CACHE_SIZE; i++) {
+      if (type_cache[i].set && type_cache[i].len == key.len &&
+          memcmp(type_cache[i].encoded, encoded, key.len) == 0) {
+        memcpy(hash, type_cache[i].hash, 32);
+        return 1;
+      }
+    }
+    keccak_256((const uint8_t *)encoded, key.len, hash);
+    int i = type_cache_index;
+    type_cache[i].set = true;
+    type_cache[i].len = key.len;
+    memcpy(type_cache[i].encoded, encoded, key.len);
+    memcpy(type_cache[i].hash, hash, 32);
+    type_cache_index = (i + 1) % EIP712_TYPE_CACHE_SIZE;
+    return 1;
+  }
+#endif
+  type_writer w = {.sha = &sha};
+  keccak_256_Init(&sha);
+  encode_type(&w, types, index);
+  keccak_Final(&sha, hash);
+  return 1;
+}
+
+#if USE_EIP712_CACHE
+static int domain_cache_index = 0;
+
+static struct {
+  bool set;
+  uint8_t fields;
+  char name[EIP712_DOMAIN_CACHE_STR_LEN];
+  char version[EIP712_DOMAIN_CACHE_STR_LEN];
+  uint8_t chain_id[32];
+  uint8_t verifying_contract[20];
+  uint8_t salt[32];
+  uint8_t separator[32];
+} domain_cache[EIP712_DOMAIN_CACHE_SIZE];
+
+static bool domain_cache_str(char *dst, const char *src) {
+  size_t len = src ? strlen(src) : 0;
+  if (len >= EIP712_DOMAIN_CACHE_STR_LEN) {
+    return false;
+  }
+  memset(dst, 0, EIP712_DOMAIN_CACHE_STR_LEN);
+  if (len) {
+    memcpy(dst, src, len);
+  }
+  return true;
+}
+#endif
+
+int eip712_domain_separator(const eip712_domain *domain,
+                            uint8_t separator[32]) {
+  static const eip712_member fields[] = {
+      {"name", "string"},
+      {"version", "string"},
+      {"chainId", "uint256"},
+      {"verifyingContract", "address"},
+      {"salt", "bytes32"},
+  };
+  const void *values[] = {domain->name, domain->version, domain->chain_id,
+                          domain->verifying_contract, domain->salt};
+  eip712_member members[5];
+  eip712_struct s = {.name = "EIP712Domain", .members = members};
+  eip712_types types = {.structs = &s, .count = 1};
+  uint8_t fields_set = 0;
+  uint8_t word[32];
+  SHA3_CTX sha;
+
+  for (size_t i = 0; i < 5; i++) {
+    if (values[i]) {
+      members[s.member_count++] = fields[i];
+      fields_set |= 1 << i;
+    }
+  }
+
+#if USE_EIP712_CACHE
+  // keyed by chain and contract first, the other fields must match too
+  uint8_t chain_id[32] = {0}, contract[20] = {0}, salt[32] = {0};
+  char name[EIP712_DOMAIN_CACHE_STR_LEN], version[EIP712_DOMAIN_CACHE_STR_LEN];
+  bool cacheable = domain_cache_str(name, domain->name) &&
+                   domain_cache_str(version, domain->version);
+
+  if (domain->chain_id) {
+    memcpy(chain_id, domain->chain_id, 32);
+  }
+  if (domain->verifying_contract) {
+    memcpy(contract, domain->verifying_contract, 20);
+  }
+  if (domain->salt) {
+    memcpy(salt, domain->salt, 32);
+  }
+  for (int i = 0; cacheable && i < EIP712_DOMAIN_CACHE_SIZE; i++) {
+    if (domain_cache[i].set && domain_cache[i].fields == fields_set &&
+        memcmp(domain_cache[i].chain_id, chain_id, 32) == 0 &&
+        memcmp(domain_cache[i].verifying_contract, contract, 20) == 0 &&
+        memcmp(domain_cache[i].salt, salt, 32) == 0 &&
+        memcmp(domain_cache[i].name, name, sizeof(name)) == 0 &&
+        memcmp(domain_cache[i].version, version, sizeof(version)) == 0) {
+      memcpy(separator, domain_cache[i].separator, 32);
+      return 1;
+    }
+  }
+#endif
+
+  eip712_type_hash(&types, 0, word);
+  keccak_256_Init(&sha);
+  keccak_Update(&sha, word, 32);
+  if (domain->name) {
+    keccak_256((const uint8_t *)domain->name, strlen(domain->name), word);
+    keccak_Update(&sha, word, 32);
+  }
+  if (domain->version) {
+    keccak_256((const uint8_t *)domain->version, strlen(domain->version), word);
+    keccak_Update(&sha, word, 32);
+  }
+  if (domain->chain_id) {
+    keccak_Update(&sha, domain->chain_id, 32);
+  }
+  if (domain->verifying_contract) {
+    memzero(word, 12);
+    memcpy(word + 12, domain->verifying_contract, 20);
+    keccak_Update(&sha, word, 32);
+  }
+  if (domain->salt) {
+    keccak_Update(&sha, domain->salt, 32);
+  }
+  keccak_Final(&sha, separator);
+
+#if USE_EIP712_CACHE
+  if (cacheable) {
+    int i = domain_cache_index;
+    domain_cache[i].set = true;
+    domain_cache[i].fields = fields_set;
+    memcpy(domain_cache[i].name, name, sizeof(name));
+    memcpy(domain_cache[i].version, version, sizeof(version));
+    memcpy(domain_cache[i].chain_id, chain_id, 32);
+    memcpy(domain_cache[i].verifying_contract, contract, 20);
+    memcpy(domain_cache[i].salt, salt, 32);
+    memcpy(domain_cache[i].separator, separator, 32);
+    domain_cache_index = (i + 1) % EIP712_DOMAIN_CACHE_SIZE;
+  }
+#endif
+  return 1;
+}
+
+void eip712_digest(const uint8_t separator[32], const uint8_t message_hash[32],
+                   uint8_t digest[32]) {
+  SHA3_CTX sha;
+  keccak_256_Init(&sha);
+  keccak_Update(&sha, (const uint8_t *)"\x19\x01", 2);
+  keccak_Update(&sha, separator, 32);
+  keccak_Update(&sha, message_hash, 32);
+  keccak_Final(&sha, digest);
+}
+
+static int hash_fail(EIP712_CTX *ctx) {
+  ctx->error = true;
+  return 0;
+}
+
+static int push_struct(EIP712_CTX *ctx, int index) {
+  uint8_t type_hash[32];
+  const eip712_struct *s = &ctx->types->structs[index];
+
+  if (ctx->depth == EIP712_MAX_DEPTH ||
+      !eip712_type_hash(ctx->types, (size_t)index, type_hash)) {
+    return hash_fail(ctx);
+  }
+  eip712_frame *f = &ctx->frames[ctx->depth++];
+  keccak_256_Init(&f->sha);
+  keccak_Update(&f->sha, type_hash, 32);
+  f->type = s->name;
+  f->type_len = strlen(s->name);
+  f->struct_index = index;
+  f->next = 0;
+  f->count = (uint32_t)s->member_count;
+  return 1;
+}
+
+// pops the frames that are complete into their parents and opens the
+// structs that come next, until a value from the caller is needed
+static int advance(EIP712_CTX *ctx) {
+  while (ctx->depth > 0) {
+    eip712_frame *f = &ctx->frames[ctx->depth - 1];
+
+    if (f->next == f->count) {
+      uint8_t hash[32];
+      keccak_Final(&f->sha, hash);
+      ctx->depth--;
+      if (ctx->depth == 0) {
+        memcpy(ctx->hash, hash, 32);
+        ctx->done = true;
+        return 1;
+      }
+      f = &ctx->frames[ctx->depth - 1];
+      keccak_Update(&f->sha, hash, 32);
+      f->next++;
+      continue;
+    }
+
+    size_t len;
+    uint32_t param;
+    const char *type = eip712_hash_expected(ctx, &len, NULL);
+    if (parse_type(ctx->types, type, len, &param) != EIP712_STRUCT) {
+      return 1;
+    }
+    if (!push_struct(ctx, (int)param)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int eip712_hash_begin(EIP712_CTX *ctx, const eip712_types *types,
+                      const char *primary_type) {
+  memzero(ctx, sizeof(EIP712_CTX));
+  ctx->types = types;
+  int index = find_struct(types, primary_type, strlen(primary_type));
+  if (index < 0 || types->count > EIP712_MAX_TYPES) {
+    return hash_fail(ctx);
+  }
+  return push_struct(ctx, index) && advance(ctx);
+}
+
+const char *eip712_hash_expected(const EIP712_CTX *ctx, size_t *type_len,
+                                 const char **member_name) {
+  if (ctx->error || ctx->done || ctx->depth == 0) {
+    return NULL;
+  }
+  const eip712_frame *f = &ctx->frames[ctx->depth - 1];
+  if (f->struct_index < 0) {
+    if (member_name) {
+      *member_name = NULL;
+    }
+    *type_len = f->type_len;
+    return f->type;
+  }
+  const eip712_member *m = &ctx->types->structs[f->struct_index].members[f->next];
+  if (member_name) {
+    *member_name = m->name;
+  }
+  *type_len = strlen(m->type);
+  return m->type;
+}
+
+static eip712_kind expected_kind(const EIP712_CTX *ctx, uint32_t *param) {
+  size_t len;
+  const char *type = eip712_hash_expected(ctx, &len, NULL);
+  if (!type || ctx->dynamic_open) {
+    return EIP712_INVALID;
+  }
+  return parse_type(ctx->types, type, len, param);
+}
+
+static int put_word(EIP712_CTX *ctx, const uint8_t word[32]) {
+  eip712_frame *f = &ctx->frames[ctx->depth - 1];
+  keccak_Update(&f->sha, word, 32);
+  f->next++;
+  return advance(ctx);
+}
+
+int eip712_hash_atomic(EIP712_CTX *ctx, const uint8_t *value, size_t len) {
+  uint8_t word[32];
+  uint32_t size = 32;
+  eip712_kind kind = expected_kind(ctx, &size);
+  uint8_t fill = 0;
+
+  if (len > 32) {
+    return hash_fail(ctx);
+  }
+  switch (kind) {
+    case EIP712_INT:
+      fill = (len > 0 && (value[0] & 0x80)) ? 0xff : 0;
+      // fall through
+    case EIP712_UINT:
+    case EIP712_BOOL:
+    case EIP712_ADDRESS:
+      if (kind == EIP712_BOOL) {
+        size = 1;
+      } else if (kind == EIP712_ADDRESS) {
+        if (len != 20) {
+          return hash_fail(ctx);
+        }
+        size = 20;
+      }
+      memset(word, fill, 32 - len);
+      memcpy(word + 32 - len, value, len);
+      // the value must fit size bytes
+      for (uint32_t i = 0; i < 32 - size; i++) {
+        if (word[i] != fill) {
+          return hash_fail(ctx);
+        }
+      }
+      if (kind == EIP712_INT && (word[32 - size] & 0x80) != (fill & 0x80)) {
+        return hash_fail(ctx);
+      }
+      if (kind == EIP712_BOOL && word[31] > 1) {
+        return hash_fail(ctx);
+      }
+      break;
+    case EIP712_FIXED_BYTES:
+      if (len != size) {
+        return hash_fail(ctx);
+      }
+      memcpy(word, value, len);
+      memzero(word + len, 32 - len);
+      break;
+    default:
+      return hash_fail(ctx);
+  }
+  return put_word(ctx, word);
+}
+
+int eip712_hash_dynamic_update(EIP712_CTX *ctx, const uint8_t *data,
+                               size_t len) {
+  uint32_t param;
+
+  if (ctx->error) {
+    return 0;
+  }
+  if (!ctx->dynamic_open) {
+    if (expected_kind(ctx, &param) != EIP712_DYNAMIC) {
+      return hash_fail(ctx);
+    }
+    keccak_256_Init(&ctx->dynamic);
+    ctx->dynamic_open = true;
+  }
+  keccak_Update(&ctx->dynamic, data, len);
+  return 1;
+}
+
+int eip712_hash_dynamic_end(EIP712_CTX *ctx) {
+  uint8_t word[32];
+
+  if (!ctx->dynamic_open && !eip712_hash_dynamic_update(ctx, NULL, 0)) {
+    return 0;
+  }
+  keccak_Final(&ctx->dynamic, word);
+  ctx->dynamic_open = false;
+  return put_word(ctx, word);
+}
+
+int eip712_hash_array_begin(EIP712_CTX *ctx, uint32_t length) {
+  uint32_t fixed;
+  size_t len;
+  const char *type = eip712_hash_expected(ctx, &len, NULL);
+
+  if (expected_kind(ctx, &fixed) != EIP712_ARRAY ||
+      (fixed != 0 && fixed != length) || ctx->depth == EIP712_MAX_DEPTH) {
+    return hash_fail(ctx);
+  }
+  eip712_frame *f = &ctx->frames[ctx->depth++];
+  keccak_256_Init(&f->sha);
+  f->type = type;
+  f->type_len = len;
+  while (f->type[f->type_len - 1] != '[') {
+    f->type_len--;
+  }
+  f->type_len--;
+  f->struct_index = -1;
+  f->next = 0;
+  f->count = length;
+  return advance(ctx);
+}
+
+int eip712_hash_end(EIP712_CTX *ctx, uint8_t hash[32]) {
+  if (ctx->error || !ctx->done) {
+    return 0;
+  }
+  memcpy(hash, ctx->hash, 32);
+  memzero(ctx, sizeof(EIP712_CTX));
+  return 1;
+}
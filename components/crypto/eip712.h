@@ -0,0 +1,107 @@
+#ifndef __EIP712_H__
+#define __EIP712_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "options.h"
+#include "sha3.h"
+
+// EIP-712 typed structured data hashing.
+//
+// The message is hashed while it streams in: the caller walks the JSON (or
+// whatever encoding the host uses) depth first and passes one value at a
+// time. Every struct and array that is open keeps a SHA3_CTX on a stack of
+// EIP712_MAX_DEPTH frames, so the RAM used does not depend on the size of
+// the message. Struct type hashes and domain separators are cached (see
+// USE_EIP712_CACHE) so repeated requests from the same dApp skip them.
+
+typedef struct {
+  const char *name;
+  const char *type;  // e.g. "uint256", "bytes32", "Person", "Person[]"
+} eip712_member;
+
+typedef struct {
+  const char *name;
+  const eip712_member *members;
+  size_t member_count;
+} eip712_struct;
+
+// all struct types a message refers to, at most 32
+typedef struct {
+  const eip712_struct *structs;
+  size_t count;
+} eip712_types;
+
+typedef struct {
+  SHA3_CTX sha;
+  const char *type;  // struct name or array element type
+  size_t type_len;
+  int struct_index;  // -1 for arrays
+  uint32_t next;     // next member or element
+  uint32_t count;
+} eip712_frame;
+
+typedef struct {
+  const eip712_types *types;
+  eip712_frame frames[EIP712_MAX_DEPTH];
+  int depth;
+  SHA3_CTX dynamic;  // string or bytes value being hashed
+  bool dynamic_open;
+  bool done;
+  bool error;
+  uint8_t hash[32];
+} EIP712_CTX;
+
+// Fields of an EIP712Domain; NULL fields are not part of the domain.
+typedef struct {
+  const char *name;
+  const char *version;
+  const uint8_t *chain_id;            // 32 bytes, big endian
+  const uint8_t *verifying_contract;  // 20 bytes
+  const uint8_t *salt;                // 32 bytes
+} eip712_domain;
+
+// keccak256(encodeType(types->structs[index]))
+int eip712_type_hash(const eip712_types *types, size_t index,
+                     uint8_t hash[32]);
+
+// hashStruct(domain)
+int eip712_domain_separator(const eip712_domain *domain,
+                            uint8_t separator[32]);
+
+// keccak256("\x19\x01" || separator || message_hash), the digest to sign
+void eip712_digest(const uint8_t separator[32], const uint8_t message_hash[32],
+                   uint8_t digest[32]);
+
+// Starts hashStruct of a primary_type message. The values then follow in
+// member order, depth first: eip712_hash_atomic for (u)intN, bool, address
+// and bytesN, eip712_hash_dynamic_update/_end for string and bytes, and
+// eip712_hash_array_begin before the elements of an array. Members of
+// struct type need no call; their own members follow directly.
+// All functions return 1 on success and 0 on a value that does not match
+// the type expected next, after which the context only returns 0.
+int eip712_hash_begin(EIP712_CTX *ctx, const eip712_types *types,
+                      const char *primary_type);
+
+// Type and name of the value expected next, NULL when the message is
+// complete. The type is not NUL terminated.
+const char *eip712_hash_expected(const EIP712_CTX *ctx, size_t *type_len,
+                                 const char **member_name);
+
+// Big endian value with at most 32 bytes; signed integers in two's
+// complement are sign extended from the first byte. Addresses are 20 bytes
+// and bytesN exactly N.
+int eip712_hash_atomic(EIP712_CTX *ctx, const uint8_t *value, size_t len);
+
+int eip712_hash_dynamic_update(EIP712_CTX *ctx, const uint8_t *data,
+                               size_t len);
+int eip712_hash_dynamic_end(EIP712_CTX *ctx);
+
+// length must match the type for fixed size arrays (T[n])
+int eip712_hash_array_begin(EIP712_CTX *ctx, uint32_t length);
+
+int eip712_hash_end(EIP712_CTX *ctx, uint8_t hash[32]);
+
+#endif
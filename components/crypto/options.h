@@ -43,6 +43,17 @@
 #define USE_RFC6979 1
 #endif
 
+// number of signatures ecdsa_sign_digest_batch works on at once
+#ifndef ECDSA_SIGN_BATCH_SIZE
+#define ECDSA_SIGN_BATCH_SIZE 8
+#endif
+
+// number of points scalar_multiply_add_batch converts to affine at once
+// (at most 32)
+#ifndef ECDSA_MULTIPLY_BATCH_SIZE
+#define ECDSA_MULTIPLY_BATCH_SIZE 16
+#endif
+
 // implement BIP32 caching
 #ifndef USE_BIP32_CACHE
 #define USE_BIP32_CACHE 1
@@ -61,11 +72,34 @@
 #define BIP39_CACHE_SIZE 4
 #endif
 
+// cache the strings formatted by bn_format_amount
+#ifndef USE_BN_FORMAT_CACHE
+#define USE_BN_FORMAT_CACHE 1
+#define BN_FORMAT_CACHE_SIZE 8
+#define BN_FORMAT_CACHE_AFFIX_LEN 12
+#define BN_FORMAT_CACHE_OUT_LEN 112
+#endif
+
 // support Ethereum operations
 #ifndef USE_ETHEREUM
 #define USE_ETHEREUM 1
 #endif
 
+// cache EIP-712 struct type hashes (keyed by their encodeType string, up to
+// EIP712_TYPE_CACHE_LEN bytes) and domain separators
+#ifndef USE_EIP712_CACHE
+#define USE_EIP712_CACHE 1
+#define EIP712_TYPE_CACHE_SIZE 8
+#define EIP712_TYPE_CACHE_LEN 256
+#define EIP712_DOMAIN_CACHE_SIZE 4
+#define EIP712_DOMAIN_CACHE_STR_LEN 32
+#endif
+
+// nesting of structs and arrays the EIP-712 hasher keeps open at once
+#ifndef EIP712_MAX_DEPTH
+#define EIP712_MAX_DEPTH 8
+#endif
+
 // support Graphene operations (STEEM, BitShares)
 #ifndef USE_GRAPHENE
 #define USE_GRAPHENE 0
@@ -92,6 +126,9 @@
 #endif
 
 // add way how to mark confidential data
+// every function-local scratch buffer is static CONFIDENTIAL, so host tools
+// calling the library from several threads build with
+// -DCONFIDENTIAL=__thread and -DUSE_BIP32_CACHE=0
 #ifndef CONFIDENTIAL
 #define CONFIDENTIAL
 #endif
@@ -22,8 +22,184 @@
  */
 
 #include "rand.h"
+#include "options.h"
 
-#ifndef RAND_PLATFORM_INDEPENDENT
+#if RAND_ENTROPY_POOL
+
+#include <string.h>
+
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "hmac_drbg.h"
+#include "memzero.h"
+
+// Entropy pool backed by HMAC-DRBG (NIST SP 800-90A).
+//
+// The DRBG is seeded from esp_fill_random() and, once a source is registered
+// with random_set_entropy_source(), from the secure element as well. Output
+// is generated RAND_POOL_SIZE bytes at a time and handed out from pool_buf,
+// so random_buffer() and random32() cost a memcpy in the common case.
+//
+// The external source is only ever queried from random_pool_service(), which
+// the application calls from an idle context. The hot path (signing nonces,
+// mnemonic generation) never waits on an I2C transaction; if the service is
+// starved it falls back to reseeding from the on-chip RNG alone.
+//
+// Note that esp_fill_random() is only a true RNG while RF or the bootloader
+// entropy source is enabled, which is why the secure element is mixed in.
+
+static HMAC_DRBG_CTX pool_drbg;
+static uint8_t pool_buf[RAND_POOL_SIZE];
+static size_t pool_pos = RAND_POOL_SIZE;
+static size_t pool_generated = 0;
+static int pool_seeded = 0;
+static int pool_source_mixed = 0;
+static int pool_source_failed = 0;
+static TickType_t pool_source_retry_at = 0;
+static random_entropy_source_t pool_source = NULL;
+
+static StaticSemaphore_t pool_lock_buf;
+static SemaphoreHandle_t pool_lock = NULL;
+static portMUX_TYPE pool_lock_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void pool_lock_take(void) {
+  if (pool_lock == NULL) {
+    portENTER_CRITICAL(&pool_lock_mux);
+    if (pool_lock == NULL) {
+      pool_lock = xSemaphoreCreateMutexStatic(&pool_lock_buf);
+    }
+    portEXIT_CRITICAL(&pool_lock_mux);
+  }
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+}
+
+static void pool_lock_give(void) { xSemaphoreGive(pool_lock); }
+
+// Caller holds the lock.
+static void pool_reseed(const uint8_t *extra, size_t extra_len,
+                        const uint8_t *addin, size_t addin_len) {
+  uint8_t entropy[SHA256_DIGEST_LENGTH + RAND_POOL_SOURCE_BYTES];
+  size_t len = SHA256_DIGEST_LENGTH;
+
+  esp_fill_random(entropy, SHA256_DIGEST_LENGTH);
+  if (extra_len > RAND_POOL_SOURCE_BYTES) {
+    extra_len = RAND_POOL_SOURCE_BYTES;
+  }
+  if (extra_len > 0) {
+    memcpy(entropy + len, extra, extra_len);
+    len += extra_len;
+  }
+
+  if (!pool_seeded) {
+    hmac_drbg_init(&pool_drbg, entropy, len, addin, addin_len);
+    pool_seeded = 1;
+  } else {
+    hmac_drbg_reseed(&pool_drbg, entropy, len, addin, addin_len);
+  }
+  pool_generated = 0;
+
+  // Drop output that was generated from the previous state.
+  memzero(pool_buf, sizeof(pool_buf));
+  pool_pos = RAND_POOL_SIZE;
+  memzero(entropy, sizeof(entropy));
+}
+
+// Caller holds the lock.
+static void pool_refill(void) {
+  if (!pool_seeded || pool_generated >= RAND_POOL_RESEED_LIMIT) {
+    pool_reseed(NULL, 0, NULL, 0);
+  }
+  hmac_drbg_generate(&pool_drbg, pool_buf, RAND_POOL_SIZE);
+  pool_generated += RAND_POOL_SIZE;
+  pool_pos = 0;
+}
+
+void random_set_entropy_source(random_entropy_source_t source) {
+  pool_lock_take();
+  pool_source = source;
+  pool_source_mixed = 0;
+  pool_source_failed = 0;
+  pool_lock_give();
+}
+
+void random_pool_service(void) {
+  uint8_t extra[RAND_POOL_SOURCE_BYTES];
+  size_t extra_len = 0;
+  random_entropy_source_t source = NULL;
+
+  pool_lock_take();
+  int reseed_due = !pool_seeded || pool_generated >= RAND_POOL_RESEED_INTERVAL;
+  int source_due =
+      pool_source != NULL && !pool_source_mixed &&
+      (!pool_source_failed ||
+       (int32_t)(xTaskGetTickCount() - pool_source_retry_at) >= 0);
+  if (!reseed_due && !source_due) {
+    pool_lock_give();
+    return;
+  }
+  source = source_due ? pool_source : NULL;
+  pool_lock_give();
+
+  // Query the secure element without holding the lock so that callers of
+  // random_buffer() are not blocked behind the I2C transfer.
+  if (source != NULL && source(extra, sizeof(extra)) == 0) {
+    extra_len = sizeof(extra);
+  }
+
+  pool_lock_take();
+  if (source != NULL && source == pool_source) {
+    // A failed read is retried after RAND_POOL_SOURCE_RETRY_MS, not on every
+    // call, and reseeds nothing unless a reseed was due anyway.
+    pool_source_mixed = extra_len > 0;
+    pool_source_failed = extra_len == 0;
+    pool_source_retry_at =
+        xTaskGetTickCount() + pdMS_TO_TICKS(RAND_POOL_SOURCE_RETRY_MS);
+  }
+  if (reseed_due || extra_len > 0) {
+    pool_reseed(extra, extra_len, NULL, 0);
+    pool_refill();
+  }
+  pool_lock_give();
+
+  memzero(extra, sizeof(extra));
+}
+
+void random_reseed(const uint32_t value) {
+  pool_lock_take();
+  pool_reseed(NULL, 0, (const uint8_t *)&value, sizeof(value));
+  pool_lock_give();
+}
+
+void __attribute__((weak)) random_buffer(uint8_t *buf, size_t len) {
+  pool_lock_take();
+  while (len > 0) {
+    if (pool_pos == RAND_POOL_SIZE) {
+      pool_refill();
+    }
+    size_t n = RAND_POOL_SIZE - pool_pos;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(buf, pool_buf + pool_pos, n);
+    // Never hand out the same bytes twice.
+    memzero(pool_buf + pool_pos, n);
+    pool_pos += n;
+    buf += n;
+    len -= n;
+  }
+  pool_lock_give();
+}
+
+uint32_t random32(void) {
+  uint32_t r = 0;
+  random_buffer((uint8_t *)&r, sizeof(r));
+  return r;
+}
+
+#elif !defined(RAND_PLATFORM_INDEPENDENT)
 
 #pragma message( \
     "NOT SUITABLE FOR PRODUCTION USE! Replace random32() function with your own secure code.")
@@ -37,7 +213,8 @@
 // own secure code. There is also a possibility to replace the random_buffer()
 // function as it is defined as a weak symbol.
 
-static uint32_t seed = 0;
+// per thread when CONFIDENTIAL is __thread (see options.h)
+static CONFIDENTIAL uint32_t seed = 0;
 
 void random_reseed(const uint32_t value) { seed = value; }
 
@@ -48,12 +225,20 @@ uint32_t random32(void) {
   return seed;
 }
 
-#endif /* RAND_PLATFORM_INDEPENDENT */
+#endif /* RAND_ENTROPY_POOL */
 
 //
 // The following code is platform independent
 //
 
+#if !RAND_ENTROPY_POOL
+
+void random_set_entropy_source(random_entropy_source_t source) {
+  (void)source;
+}
+
+void random_pool_service(void) {}
+
 void __attribute__((weak)) random_buffer(uint8_t *buf, size_t len) {
   uint32_t r = 0;
   for (size_t i = 0; i < len; i++) {
@@ -64,6 +249,8 @@ void __attribute__((weak)) random_buffer(uint8_t *buf, size_t len) {
   }
 }
 
+#endif /* !RAND_ENTROPY_POOL */
+
 uint32_t random_uniform(uint32_t n) {
   uint32_t x, max = 0xFFFFFFFF - (0xFFFFFFFF % n);
   while ((x = random32()) >= max)
@@ -27,6 +27,49 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+// On the ESP32 the generator is an HMAC-DRBG entropy pool seeded from the
+// on-chip RNG and, when registered, an external source such as the ATECC.
+// Host builds keep the test-only LCG unless RAND_PLATFORM_INDEPENDENT is set.
+#ifndef RAND_ENTROPY_POOL
+#if defined(ESP_PLATFORM) && !defined(RAND_PLATFORM_INDEPENDENT)
+#define RAND_ENTROPY_POOL 1
+#else
+#define RAND_ENTROPY_POOL 0
+#endif
+#endif
+
+// Bytes generated per DRBG call and buffered for random_buffer()/random32().
+#ifndef RAND_POOL_SIZE
+#define RAND_POOL_SIZE 128
+#endif
+
+// Output after which random_pool_service() reseeds from all sources.
+#ifndef RAND_POOL_RESEED_INTERVAL
+#define RAND_POOL_RESEED_INTERVAL 4096
+#endif
+
+// Output after which the hot path reseeds from the on-chip RNG by itself,
+// in case random_pool_service() is not being called.
+#ifndef RAND_POOL_RESEED_LIMIT
+#define RAND_POOL_RESEED_LIMIT (16 * RAND_POOL_RESEED_INTERVAL)
+#endif
+
+// Bytes requested from the external entropy source per reseed.
+#ifndef RAND_POOL_SOURCE_BYTES
+#define RAND_POOL_SOURCE_BYTES 64
+#endif
+
+// Wait after a failed read of the external source before asking it again.
+#ifndef RAND_POOL_SOURCE_RETRY_MS
+#define RAND_POOL_SOURCE_RETRY_MS 60000
+#endif
+
+// External entropy source; fills buf with len bytes and returns 0 on success.
+typedef int (*random_entropy_source_t)(uint8_t *buf, size_t len);
+
+void random_set_entropy_source(random_entropy_source_t source);
+void random_pool_service(void);
+
 void random_reseed(const uint32_t value);
 uint32_t random32(void);
 void random_buffer(uint8_t *buf, size_t len);
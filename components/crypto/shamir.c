@@ -260,46 +260,35 @@ static void gf256_inv(uint32_t r[8], uint32_t x[8]) {
   memzero(z, sizeof(z));
 }
 
-bool shamir_interpolate(uint8_t *result, uint8_t result_index,
-                        const uint8_t *share_indices,
-                        const uint8_t **share_values, uint8_t share_count,
-                        size_t len) {
-  size_t i, j;
+bool shamir_interpolate_many(uint8_t **results, const uint8_t *result_indices,
+                             uint8_t result_count,
+                             const uint8_t *share_indices,
+                             const uint8_t **share_values, uint8_t share_count,
+                             size_t len) {
+  size_t i, j, k;
   uint32_t x[8];
   uint32_t xs[share_count][8];
   uint32_t ys[share_count][8];
-  uint32_t num[8] = {~0}; /* num is the numerator (=1) */
+  uint32_t prefix[share_count][8];
+  uint32_t suffix[8];
   uint32_t denom[8];
   uint32_t tmp[8];
-  uint32_t secret[8] = {0};
+  uint32_t secret[8];
   bool ret = true;
 
-  if (len > SHAMIR_MAX_LEN) return false;
+  if (len > SHAMIR_MAX_LEN || share_count == 0) return false;
 
   /* Collect the x and y values */
   for (i = 0; i < share_count; i++) {
     bitslice_setall(xs[i], share_indices[i]);
     bitslice(ys[i], share_values[i], len);
   }
-  bitslice_setall(x, result_index);
-
-  for (i = 0; i < share_count; i++) {
-    memcpy(tmp, x, sizeof(uint32_t[8]));
-    gf256_add(tmp, xs[i]);
-    gf256_mul(num, num, tmp);
-  }
 
-  /* Use Lagrange basis polynomials to calculate the secret coefficient */
+  /* Scale every y_i by its barycentric weight 1 / prod_{j != i} (x_i - x_j).
+   * The weights do not depend on the result index, so all the inversions
+   * are done here, once for all of the results. */
   for (i = 0; i < share_count; i++) {
-    /* The code below assumes that none of the share_indices are equal to
-     * result_index. We need to treat that as a special case. */
-    if (share_indices[i] != result_index) {
-      memcpy(denom, x, sizeof(denom));
-      gf256_add(denom, xs[i]);
-    } else {
-      bitslice_setall(denom, 1);
-      gf256_add(secret, ys[i]);
-    }
+    bitslice_setall(denom, 1);
     for (j = 0; j < share_count; j++) {
       if (i == j) continue;
       memcpy(tmp, xs[i], sizeof(uint32_t[8]));
@@ -312,22 +301,56 @@ bool shamir_interpolate(uint8_t *result, uint8_t result_index,
       ret = false;
       break;
     }
-    gf256_inv(tmp, denom);      /* inverted denominator */
-    gf256_mul(tmp, tmp, num);   /* basis polynomial */
-    gf256_mul(tmp, tmp, ys[i]); /* scaled coefficient */
-    gf256_add(secret, tmp);
+    gf256_inv(tmp, denom);
+    gf256_mul(ys[i], ys[i], tmp);
   }
 
-  if (ret == true) {
-    unbitslice(result, secret, len);
+  /* f(x) = sum_i y_i / prod_{j != i} (x_i - x_j) * prod_{j != i} (x - x_j)
+   * The second product is built from prefix and suffix products, so every
+   * result takes about 4 * share_count multiplications. If x equals one of
+   * the x_i, all the other terms vanish and the sum is y_i. */
+  for (k = 0; ret == true && k < result_count; k++) {
+    bitslice_setall(x, result_indices[k]);
+
+    /* prefix[i] = prod_{j < i} (x - x_j) */
+    bitslice_setall(prefix[0], 1);
+    for (i = 1; i < share_count; i++) {
+      memcpy(tmp, x, sizeof(uint32_t[8]));
+      gf256_add(tmp, xs[i - 1]);
+      gf256_mul(prefix[i], prefix[i - 1], tmp);
+    }
+
+    /* suffix = prod_{j > i} (x - x_j) */
+    bitslice_setall(suffix, 1);
+    memset(secret, 0, sizeof(secret));
+    for (i = share_count; i-- > 0;) {
+      gf256_mul(tmp, prefix[i], suffix);
+      gf256_mul(tmp, tmp, ys[i]);
+      gf256_add(secret, tmp);
+
+      memcpy(tmp, x, sizeof(uint32_t[8]));
+      gf256_add(tmp, xs[i]);
+      gf256_mul(suffix, suffix, tmp);
+    }
+
+    unbitslice(results[k], secret, len);
   }
 
   memzero(x, sizeof(x));
   memzero(xs, sizeof(xs));
   memzero(ys, sizeof(ys));
-  memzero(num, sizeof(num));
+  memzero(prefix, sizeof(prefix));
+  memzero(suffix, sizeof(suffix));
   memzero(denom, sizeof(denom));
   memzero(tmp, sizeof(tmp));
   memzero(secret, sizeof(secret));
   return ret;
 }
+
+bool shamir_interpolate(uint8_t *result, uint8_t result_index,
+                        const uint8_t *share_indices,
+                        const uint8_t **share_values, uint8_t share_count,
+                        size_t len) {
+  return shamir_interpolate_many(&result, &result_index, 1, share_indices,
+                                 share_values, share_count, len);
+}
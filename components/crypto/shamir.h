@@ -67,4 +67,21 @@ bool shamir_interpolate(uint8_t *result, uint8_t result_index,
                         const uint8_t **share_values, uint8_t share_count,
                         size_t len);
 
+/*
+ * Same as shamir_interpolate, but computes f(x) for result_count x coordinates
+ * at once. The shares are bitsliced and the Lagrange denominators are inverted
+ * only once, which makes this much cheaper than calling shamir_interpolate in
+ * a loop, e.g. when generating all the shares of a split.
+ * results: Array of result_count pointers to arrays of length len.
+ * result_indices: The x coordinates of the results.
+ * result_count: The number of results.
+ *
+ * Nothing is written to `results` on failure.
+ */
+bool shamir_interpolate_many(uint8_t **results, const uint8_t *result_indices,
+                             uint8_t result_count,
+                             const uint8_t *share_indices,
+                             const uint8_t **share_values, uint8_t share_count,
+                             size_t len);
+
 #endif /* __SHAMIR_H__ */
@@ -25,8 +25,16 @@
 #include "slip39.h"
 #include <stdio.h>
 #include <string.h>
+#include "hmac.h"
+#include "memzero.h"
+#include "rand.h"
+#include "shamir.h"
 #include "slip39_wordlist.h"
 
+#define SLIP39_DIGEST_LENGTH 4
+#define SLIP39_DIGEST_INDEX 254
+#define SLIP39_SECRET_INDEX 255
+
 /**
  * Returns word on position `index`.
  */
@@ -134,3 +142,112 @@ uint16_t find(uint16_t prefix, bool find_index) {
 
   return bitmap;
 }
+
+/**
+ * Splits `secret` of length `len` into `share_count` shares, any `threshold`
+ * of which recover it, as specified by SLIP-0039. Share `i` (x coordinate `i`)
+ * is written to `shares + i * len`.
+ *
+ * The first `threshold - 2` shares are random. Together with the digest share
+ * and the secret itself they determine the polynomial, and all remaining
+ * shares are evaluated from it in a single shamir_interpolate_many call.
+ */
+bool slip39_split_secret(uint8_t threshold, uint8_t share_count,
+                         const uint8_t* secret, size_t len, uint8_t* shares) {
+  uint8_t digest_share[SHAMIR_MAX_LEN];
+  uint8_t digest[32];
+  const uint8_t* base_values[SLIP39_MAX_SHARE_COUNT];
+  uint8_t base_indices[SLIP39_MAX_SHARE_COUNT];
+  uint8_t* results[SLIP39_MAX_SHARE_COUNT];
+  uint8_t result_indices[SLIP39_MAX_SHARE_COUNT];
+  uint8_t random_count = 0;
+  uint8_t i = 0;
+  bool ret = false;
+
+  if (threshold == 0 || threshold > share_count ||
+      share_count > SLIP39_MAX_SHARE_COUNT || len < 16 || len % 2 != 0 ||
+      len > SHAMIR_MAX_LEN) {
+    return false;
+  }
+
+  if (threshold == 1) {
+    for (i = 0; i < share_count; i++) {
+      memcpy(shares + i * len, secret, len);
+    }
+    return true;
+  }
+
+  random_count = threshold - 2;
+  for (i = 0; i < random_count; i++) {
+    random_buffer(shares + i * len, len);
+    base_indices[i] = i;
+    base_values[i] = shares + i * len;
+  }
+
+  // digest share = HMAC-SHA256(key=R, msg=secret)[:4] || R
+  random_buffer(digest_share + SLIP39_DIGEST_LENGTH,
+                len - SLIP39_DIGEST_LENGTH);
+  trezor_hmac_sha256(digest_share + SLIP39_DIGEST_LENGTH,
+                     len - SLIP39_DIGEST_LENGTH, secret, len, digest);
+  memcpy(digest_share, digest, SLIP39_DIGEST_LENGTH);
+
+  base_indices[random_count] = SLIP39_DIGEST_INDEX;
+  base_values[random_count] = digest_share;
+  base_indices[random_count + 1] = SLIP39_SECRET_INDEX;
+  base_values[random_count + 1] = secret;
+
+  for (i = random_count; i < share_count; i++) {
+    result_indices[i - random_count] = i;
+    results[i - random_count] = shares + i * len;
+  }
+
+  ret = shamir_interpolate_many(results, result_indices,
+                                share_count - random_count, base_indices,
+                                base_values, threshold, len);
+
+  memzero(digest_share, sizeof(digest_share));
+  memzero(digest, sizeof(digest));
+  return ret;
+}
+
+/**
+ * Two-level SLIP-0039 split: `secret` is split into `group_count` group
+ * shares with `group_threshold`, and group share `g` is split again into
+ * `member_counts[g]` member shares with `member_thresholds[g]`.
+ * Member `m` of group `g` is written to
+ * `shares + (g * SLIP39_MAX_SHARE_COUNT + m) * len`.
+ * `secret` is expected to be the already encrypted master secret.
+ */
+bool slip39_split_groups(uint8_t group_threshold, uint8_t group_count,
+                         const uint8_t* member_thresholds,
+                         const uint8_t* member_counts, const uint8_t* secret,
+                         size_t len, uint8_t* shares) {
+  uint8_t group_shares[SLIP39_MAX_SHARE_COUNT * SHAMIR_MAX_LEN];
+  uint8_t g = 0;
+  bool ret = true;
+
+  if (group_count > SLIP39_MAX_SHARE_COUNT) {
+    return false;
+  }
+  // a single member share would make the remaining members redundant
+  for (g = 0; g < group_count; g++) {
+    if (member_thresholds[g] == 1 && member_counts[g] != 1) {
+      return false;
+    }
+  }
+
+  if (!slip39_split_secret(group_threshold, group_count, secret, len,
+                           group_shares)) {
+    memzero(group_shares, sizeof(group_shares));
+    return false;
+  }
+
+  for (g = 0; g < group_count && ret; g++) {
+    ret = slip39_split_secret(member_thresholds[g], member_counts[g],
+                              group_shares + g * len, len,
+                              shares + g * SLIP39_MAX_SHARE_COUNT * len);
+  }
+
+  memzero(group_shares, sizeof(group_shares));
+  return ret;
+}
@@ -23,8 +23,11 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#define SLIP39_MAX_SHARE_COUNT 16
+
 const char* get_word(uint16_t index);
 
 bool word_index(uint16_t* index, const char* word, uint8_t word_length);
@@ -34,3 +37,11 @@ uint16_t compute_mask(uint16_t prefix);
 const char* button_sequence_to_word(uint16_t prefix);
 
 uint16_t find(uint16_t prefix, bool find_index);
+
+bool slip39_split_secret(uint8_t threshold, uint8_t share_count,
+                         const uint8_t* secret, size_t len, uint8_t* shares);
+
+bool slip39_split_groups(uint8_t group_threshold, uint8_t group_count,
+                         const uint8_t* member_thresholds,
+                         const uint8_t* member_counts, const uint8_t* secret,
+                         size_t len, uint8_t* shares);
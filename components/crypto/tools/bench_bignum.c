@@ -0,0 +1,106 @@
+/**
+ * Times bn_divmod1000000000 and bn_format on a 2^255 wei amount and
+ * checks the division against a plain 64-bit divide.
+ *
+ *   make bench
+ *   ./build/bench_bignum [rounds]
+ *
+ * bn_divmod1000000000 divides by a reciprocal with 32x32->64 multiplies so
+ * it needs no 64-bit divide on 32-bit targets (__udivdi3 in libgcc on
+ * Xtensa). On a 64-bit host the reference divide is a single native
+ * instruction and beats the reciprocal, so run it on the target to see the
+ * gain; on the host it checks the result and tracks bn_format regressions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bignum.h"
+
+static double seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void divmod1000000000_u64(bignum256 *a, uint32_t *r) {
+  uint32_t rem = a->val[8] % 1000000000;
+  a->val[8] /= 1000000000;
+  for (int i = 7; i >= 0; i--) {
+    uint64_t tmp = ((uint64_t)rem << 30) | a->val[i];
+    a->val[i] = (uint32_t)(tmp / 1000000000);
+    rem = (uint32_t)(tmp % 1000000000);
+  }
+  *r = rem;
+}
+
+static bool check(uint32_t rounds) {
+  srand(1);
+  for (uint32_t n = 0; n < rounds; n++) {
+    bignum256 a, b;
+    uint32_t r1, r2;
+    for (int i = 0; i < 9; i++) {
+      a.val[i] = (((uint32_t)rand() << 16) ^ (uint32_t)rand()) & 0x3FFFFFFF;
+    }
+    a.val[8] &= 0xFFFF;
+    b = a;
+    bn_divmod1000000000(&a, &r1);
+    divmod1000000000_u64(&b, &r2);
+    if (r1 != r2 || memcmp(&a, &b, sizeof(a)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 1000000;
+  bignum256 amount, a;
+  uint32_t r, sink = 0;
+  uint8_t be[32];
+  char out[128];
+  double t0, t1, t2, t3;
+
+  if (rounds == 0) {
+    fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+    return 2;
+  }
+  if (!check(rounds)) {
+    fprintf(stderr, "bn_divmod1000000000 does not match the 64-bit divide\n");
+    return 1;
+  }
+
+  memset(be, 0, sizeof(be));
+  be[0] = 0x80;
+  bn_read_be(be, &amount);
+
+  t0 = seconds();
+  for (uint32_t n = 0; n < rounds; n++) {
+    a = amount;
+    a.val[0] ^= n & 0xFF;
+    bn_divmod1000000000(&a, &r);
+    sink += r;
+  }
+  t1 = seconds();
+  for (uint32_t n = 0; n < rounds; n++) {
+    a = amount;
+    a.val[0] ^= n & 0xFF;
+    divmod1000000000_u64(&a, &r);
+    sink += r;
+  }
+  t2 = seconds();
+  for (uint32_t n = 0; n < rounds; n++) {
+    a = amount;
+    a.val[0] ^= n & 0xFF;
+    sink += bn_format(&a, NULL, " ETH", 18, 0, false, out, sizeof(out));
+  }
+  t3 = seconds();
+
+  printf("%s\n", out);
+  printf("bn_divmod1000000000  %7.1f ns\n", (t1 - t0) / rounds * 1e9);
+  printf("64-bit divide        %7.1f ns\n", (t2 - t1) / rounds * 1e9);
+  printf("bn_format            %7.1f ns\n", (t3 - t2) / rounds * 1e9);
+  return sink == 0xFFFFFFFF;
+}
@@ -0,0 +1,101 @@
+/**
+ * Times Shamir share evaluation and the SLIP-0039 split on random data.
+ *
+ *   make bench
+ *   ./build/bench_shamir [rounds]
+ *
+ * From 16 shares of 32 bytes it evaluates 16 other points once per call
+ * with shamir_interpolate and in one shamir_interpolate_many pass, and
+ * checks that both agree. It then times a 16-of-16 slip39_split_secret
+ * and checks that its shares recover the secret. Prints microseconds per
+ * operation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rand.h"
+#include "shamir.h"
+#include "slip39.h"
+
+#define COUNT 16
+#define LEN 32
+
+static double seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  uint32_t rounds = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+  uint8_t values[COUNT][LEN], single[COUNT][LEN], many[COUNT][LEN];
+  uint8_t indices[COUNT], result_indices[COUNT];
+  const uint8_t *share_values[COUNT];
+  uint8_t *results[COUNT];
+  uint8_t secret[LEN], shares[COUNT * LEN], recovered[LEN];
+  double t0, t1, t2, t3;
+
+  if (rounds == 0) {
+    fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+    return 2;
+  }
+
+  random_buffer(&values[0][0], sizeof(values));
+  random_buffer(secret, sizeof(secret));
+  for (int i = 0; i < COUNT; i++) {
+    indices[i] = i;
+    result_indices[i] = COUNT + i;
+    share_values[i] = values[i];
+    results[i] = many[i];
+  }
+
+  t0 = seconds();
+  for (uint32_t n = 0; n < rounds; n++) {
+    for (int i = 0; i < COUNT; i++) {
+      if (!shamir_interpolate(single[i], result_indices[i], indices,
+                              share_values, COUNT, LEN)) {
+        fprintf(stderr, "shamir_interpolate failed\n");
+        return 1;
+      }
+    }
+  }
+  t1 = seconds();
+  for (uint32_t n = 0; n < rounds; n++) {
+    if (!shamir_interpolate_many(results, result_indices, COUNT, indices,
+                                 share_values, COUNT, LEN)) {
+      fprintf(stderr, "shamir_interpolate_many failed\n");
+      return 1;
+    }
+  }
+  t2 = seconds();
+  if (memcmp(single, many, sizeof(many)) != 0) {
+    fprintf(stderr, "shamir_interpolate_many differs from shamir_interpolate\n");
+    return 1;
+  }
+
+  for (uint32_t n = 0; n < rounds; n++) {
+    if (!slip39_split_secret(COUNT, COUNT, secret, LEN, shares)) {
+      fprintf(stderr, "slip39_split_secret failed\n");
+      return 1;
+    }
+  }
+  t3 = seconds();
+  for (int i = 0; i < COUNT; i++) {
+    share_values[i] = shares + i * LEN;
+  }
+  if (!shamir_interpolate(recovered, 255, indices, share_values, COUNT, LEN) ||
+      memcmp(recovered, secret, LEN) != 0) {
+    fprintf(stderr, "split shares do not recover the secret\n");
+    return 1;
+  }
+
+  printf("%d shares of %d bytes, %d points\n", COUNT, LEN, COUNT);
+  printf("  shamir_interpolate x%d   %8.1f us\n", COUNT,
+         (t1 - t0) / rounds * 1e6);
+  printf("  shamir_interpolate_many  %8.1f us\n", (t2 - t1) / rounds * 1e6);
+  printf("  slip39_split_secret      %8.1f us\n", (t3 - t2) / rounds * 1e6);
+  return 0;
+}
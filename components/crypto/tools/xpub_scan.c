@@ -0,0 +1,228 @@
+/**
+ * Watch-only account scanner, see xpub_scan.h.
+ *
+ * Workers take chunks of the index range from a shared counter, derive
+ * them with hdnode_public_ckd_cp_batch into their own buffers and then
+ * wait for their turn to hand the chunk to the sink, so the output stays in
+ * index order while at most one chunk per thread is held in memory.
+ */
+
+#include "xpub_scan.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "base58.h"
+#include "bignum.h"
+#include "bip32.h"
+#include "curves.h"
+#include "memzero.h"
+#include "secp256k1.h"
+#include "sha3.h"
+
+int xpub_scan_import(const char *xpub, const uint32_t *path, size_t path_len,
+                     xpub_scan_account *account) {
+  uint8_t data[78];
+  HDNode node;
+
+  if (base58_decode_check(xpub, HASHER_SHA2D, data, sizeof(data)) !=
+      sizeof(data)) {
+    return -1;
+  }
+  if (data[45] == 0) {
+    memzero(data, sizeof(data));
+    return -2;
+  }
+  if (hdnode_deserialize(xpub, read_be(data), 0, SECP256K1_NAME, &node,
+                         NULL) != 0) {
+    return -1;
+  }
+  for (size_t i = 0; i < path_len; i++) {
+    if (path[i] & 0x80000000) {
+      return -3;
+    }
+    if (!hdnode_public_ckd(&node, path[i])) {
+      return -1;
+    }
+  }
+  if (!ecdsa_read_pubkey(&secp256k1, node.public_key, &account->public_key)) {
+    return -1;
+  }
+  memcpy(account->chain_code, node.chain_code, 32);
+  return 0;
+}
+
+static void fill_entry(const curve_point *pub, uint32_t index,
+                       xpub_scan_entry *entry) {
+  uint8_t xy[64];
+  uint8_t hash[32];
+
+  entry->index = index;
+  compress_coords(pub, entry->public_key);
+  bn_write_be(&pub->x, xy);
+  bn_write_be(&pub->y, xy + 32);
+  keccak_256(xy, sizeof(xy), hash);
+  memcpy(entry->address, hash + 12, 20);
+}
+
+int xpub_scan_derive(const xpub_scan_account *account, uint32_t first,
+                     size_t count, xpub_scan_entry *entries) {
+  curve_point children[ECDSA_MULTIPLY_BATCH_SIZE];
+
+  for (size_t start = 0; start < count; start += ECDSA_MULTIPLY_BATCH_SIZE) {
+    size_t n = count - start;
+    if (n > ECDSA_MULTIPLY_BATCH_SIZE) {
+      n = ECDSA_MULTIPLY_BATCH_SIZE;
+    }
+    uint32_t index = first + (uint32_t)start;
+    if (!hdnode_public_ckd_cp_batch(&secp256k1, &account->public_key,
+                                    account->chain_code, index, n, children,
+                                    NULL)) {
+      return 0;
+    }
+    for (size_t j = 0; j < n; j++) {
+      fill_entry(&children[j], index + (uint32_t)j, &entries[start + j]);
+    }
+  }
+  return 1;
+}
+
+int xpub_scan_derive_reference(const xpub_scan_account *account,
+                               uint32_t index, xpub_scan_entry *entry) {
+  HDNode node;
+  uint8_t uncompressed[65];
+  uint8_t hash[32];
+
+  memzero(&node, sizeof(node));
+  node.curve = get_curve_by_name(SECP256K1_NAME);
+  compress_coords(&account->public_key, node.public_key);
+  memcpy(node.chain_code, account->chain_code, 32);
+  if (!hdnode_public_ckd(&node, index) ||
+      !ecdsa_uncompress_pubkey(&secp256k1, node.public_key, uncompressed)) {
+    return 0;
+  }
+  entry->index = index;
+  memcpy(entry->public_key, node.public_key, 33);
+  keccak_256(uncompressed + 1, 64, hash);
+  memcpy(entry->address, hash + 12, 20);
+  return 1;
+}
+
+typedef struct {
+  const xpub_scan_account *account;
+  uint32_t first;
+  uint64_t count;
+  size_t chunk;
+  xpub_scan_sink sink;
+  void *ctx;
+
+  pthread_mutex_t lock;
+  pthread_cond_t turn;
+  uint64_t next_job;   // next chunk to derive
+  uint64_t next_emit;  // next chunk to pass to the sink
+  bool stopped;
+  bool failed;
+  double cpu_seconds;
+} scan_pool;
+
+static double seconds(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *scan_worker(void *arg) {
+  scan_pool *pool = arg;
+  xpub_scan_entry *entries = malloc(pool->chunk * sizeof(xpub_scan_entry));
+  uint64_t jobs = (pool->count + pool->chunk - 1) / pool->chunk;
+
+  pthread_mutex_lock(&pool->lock);
+  while (entries && !pool->stopped && pool->next_job < jobs) {
+    uint64_t job = pool->next_job++;
+    pthread_mutex_unlock(&pool->lock);
+
+    uint64_t start = job * pool->chunk;
+    size_t n = pool->count - start < pool->chunk ? pool->count - start
+                                                 : pool->chunk;
+    xpub_scan_derive(pool->account, pool->first + (uint32_t)start, n,
+                     entries);
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stopped && pool->next_emit != job) {
+      pthread_cond_wait(&pool->turn, &pool->lock);
+    }
+    if (pool->stopped) {
+      break;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    bool more = pool->sink(pool->ctx, entries, n);
+    pthread_mutex_lock(&pool->lock);
+
+    pool->next_emit++;
+    pool->stopped = !more;
+    pthread_cond_broadcast(&pool->turn);
+  }
+  if (!entries) {
+    pool->stopped = pool->failed = true;
+    pthread_cond_broadcast(&pool->turn);
+  }
+  pool->cpu_seconds += seconds(CLOCK_THREAD_CPUTIME_ID);
+  pthread_mutex_unlock(&pool->lock);
+
+  free(entries);
+  return NULL;
+}
+
+int xpub_scan_run(const xpub_scan_account *account, uint32_t first,
+                  uint64_t count, unsigned threads, size_t chunk,
+                  xpub_scan_sink sink, void *ctx, xpub_scan_stats *stats) {
+  scan_pool pool = {
+      .account = account,
+      .first = first,
+      .count = count,
+      .chunk = chunk,
+      .sink = sink,
+      .ctx = ctx,
+      .lock = PTHREAD_MUTEX_INITIALIZER,
+      .turn = PTHREAD_COND_INITIALIZER,
+  };
+  pthread_t *tids;
+  unsigned started = 0;
+  double wall = seconds(CLOCK_MONOTONIC);
+
+  if ((first & 0x80000000) || count > 0x80000000 - (uint64_t)first ||
+      threads == 0 || chunk == 0) {
+    return -1;
+  }
+  tids = calloc(threads, sizeof(pthread_t));
+  if (!tids) {
+    return -1;
+  }
+  while (started < threads &&
+         pthread_create(&tids[started], NULL, scan_worker, &pool) == 0) {
+    started++;
+  }
+  if (started < threads) {
+    pthread_mutex_lock(&pool.lock);
+    pool.stopped = pool.failed = true;
+    pthread_cond_broadcast(&pool.turn);
+    pthread_mutex_unlock(&pool.lock);
+  }
+  for (unsigned i = 0; i < started; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  free(tids);
+
+  if (stats) {
+    stats->addresses = pool.next_emit * chunk < count ? pool.next_emit * chunk
+                                                      : count;
+    stats->wall_seconds = seconds(CLOCK_MONOTONIC) - wall;
+    stats->cpu_seconds = pool.cpu_seconds;
+  }
+  if (pool.failed) {
+    return -1;
+  }
+  return pool.stopped ? 1 : 0;
+}
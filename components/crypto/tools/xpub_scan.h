@@ -0,0 +1,65 @@
+/**
+ * Watch-only account scanner: derives the Ethereum addresses of a range of
+ * non-hardened children of an extended public key on a pool of threads.
+ *
+ * Host only. The crypto sources must be built with -DCONFIDENTIAL=__thread
+ * and -DUSE_BIP32_CACHE=0 so that every thread has its own scratch buffers
+ * (see options.h and the Makefile in this directory).
+ */
+
+#ifndef __XPUB_SCAN_H__
+#define __XPUB_SCAN_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ecdsa.h"
+
+typedef struct {
+  curve_point public_key;
+  uint8_t chain_code[32];
+} xpub_scan_account;
+
+typedef struct {
+  uint32_t index;
+  uint8_t public_key[33];
+  uint8_t address[20];
+} xpub_scan_entry;
+
+typedef struct {
+  uint64_t addresses;
+  double wall_seconds;
+  double cpu_seconds;  // summed over the worker threads
+} xpub_scan_stats;
+
+// Called with consecutive entries in index order, by one thread at a time.
+// Returning false stops the scan.
+typedef bool (*xpub_scan_sink)(void *ctx, const xpub_scan_entry *entries,
+                               size_t count);
+
+// Parses a base58 extended public key of any version and derives the
+// non-hardened path below it (e.g. {0} for the receive branch).
+// Returns 0, or -1 for a malformed key, -2 for a private key and -3 for a
+// hardened index in path.
+int xpub_scan_import(const char *xpub, const uint32_t *path, size_t path_len,
+                     xpub_scan_account *account);
+
+// Entries for indexes first..first+count-1 on the calling thread.
+int xpub_scan_derive(const xpub_scan_account *account, uint32_t first,
+                     size_t count, xpub_scan_entry *entries);
+
+// The same entry the firmware derives: hdnode_public_ckd on an HDNode
+// followed by keccak of the uncompressed key. Slow; for cross-checking.
+int xpub_scan_derive_reference(const xpub_scan_account *account,
+                               uint32_t index, xpub_scan_entry *entry);
+
+// Derives count entries from first on threads workers, chunk indexes per
+// job, and passes them to sink in index order. Returns 0 when the range
+// was scanned, 1 when sink stopped it and -1 on a bad range or when a
+// thread or its buffer could not be set up. stats may be NULL.
+int xpub_scan_run(const xpub_scan_account *account, uint32_t first,
+                  uint64_t count, unsigned threads, size_t chunk,
+                  xpub_scan_sink sink, void *ctx, xpub_scan_stats *stats);
+
+#endif
@@ -0,0 +1,230 @@
+#include "crypto_worker.h"
+#include <string.h>
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "bip39.h"
+#include "memzero.h"
+#include "trace.h"
+
+static const char *TAG = "crypto_worker";
+
+typedef struct {
+    uint32_t id;
+    crypto_job_t job;
+} crypto_request_t;
+
+static QueueHandle_t requests;
+static QueueHandle_t results;
+static uint32_t next_id = 1;
+
+// Id of the job on the worker and its progress. Written by the worker,
+// read by the UI core; a torn current/total pair only misdraws one frame.
+static volatile uint32_t running_id;
+static volatile uint32_t progress_current;
+static volatile uint32_t progress_total;
+static void (*running_progress)(uint32_t current, uint32_t total);
+
+// Recently cancelled ids: enough for every queued job plus the running one.
+static portMUX_TYPE cancel_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t cancelled[CRYPTO_WORKER_QUEUE_LEN + 1];
+static uint8_t cancelled_next;
+
+static bool is_cancelled(uint32_t id)
+{
+    bool found = false;
+
+    portENTER_CRITICAL(&cancel_mux);
+    for (int i = 0; i < CRYPTO_WORKER_QUEUE_LEN + 1; i++) {
+        if (cancelled[i] == id) {
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&cancel_mux);
+    return found;
+}
+
+static void report_progress(uint32_t current, uint32_t total)
+{
+    progress_current = current;
+    progress_total = total;
+    if (running_progress) {
+        running_progress(current, total);
+    }
+}
+
+static bool running_cancelled(void)
+{
+    return is_cancelled(running_id);
+}
+
+static crypto_job_status_t run_derive(const crypto_job_t *job)
+{
+    HDNode *node = job->derive.node;
+    uint32_t total = job->derive.path_len + 1;
+
+    if (!hdnode_from_seed(job->derive.seed, job->derive.seed_len, job->derive.curve, node)) {
+        return CRYPTO_JOB_FAILED;
+    }
+    report_progress(1, total);
+    for (size_t i = 0; i < job->derive.path_len; i++) {
+        if (running_cancelled()) {
+            memzero(node, sizeof(*node));
+            return CRYPTO_JOB_CANCELLED;
+        }
+        TRACE_BEGIN(trace_start);
+        int ok = hdnode_private_ckd(node, job->derive.path[i]);
+        TRACE_END(trace_start, TRACE_HDNODE_CKD, job->derive.path[i], node->depth, ok, 0);
+        if (!ok) {
+            memzero(node, sizeof(*node));
+            return CRYPTO_JOB_FAILED;
+        }
+        report_progress(i + 2, total);
+    }
+    hdnode_fill_public_key(node);
+    return CRYPTO_JOB_OK;
+}
+
+static crypto_job_status_t run_job(const crypto_job_t *job)
+{
+    TRACE_BEGIN(trace_start);
+    int ret;
+
+    switch (job->type) {
+        case CRYPTO_JOB_SEED:
+            ret = mnemonic_to_seed_cancellable(job->seed.mnemonic, job->seed.passphrase,
+                                               job->seed.seed, report_progress,
+                                               running_cancelled);
+            TRACE_END(trace_start, TRACE_MNEMONIC_TO_SEED, ret, 0, 0, 0);
+            return ret ? CRYPTO_JOB_OK : CRYPTO_JOB_CANCELLED;
+        case CRYPTO_JOB_DERIVE:
+            return run_derive(job);
+        case CRYPTO_JOB_SIGN:
+            ret = ecdsa_sign_digest(job->sign.curve, job->sign.priv_key, job->sign.digest,
+                                    job->sign.sig, job->sign.pby, NULL);
+            TRACE_END(trace_start, TRACE_ECDSA_SIGN, ret, 0, 0, 0);
+            return ret == 0 ? CRYPTO_JOB_OK : CRYPTO_JOB_FAILED;
+        case CRYPTO_JOB_VERIFY:
+            ret = ecdsa_verify_digest(job->verify.curve, job->verify.pub_key, job->verify.sig,
+                                      job->verify.digest);
+            TRACE_END(trace_start, TRACE_ECDSA_VERIFY, ret, 0, 0, 0);
+            return ret == 0 ? CRYPTO_JOB_OK : CRYPTO_JOB_FAILED;
+        default:
+            return CRYPTO_JOB_FAILED;
+    }
+}
+
+static void crypto_worker_task(void *arg)
+{
+    (void)arg;
+    crypto_request_t req;
+
+    while (1) {
+        xQueueReceive(requests, &req, portMAX_DELAY);
+
+        crypto_result_t result = { .id = req.id, .type = req.job.type };
+        int64_t start = esp_timer_get_time();
+
+        running_progress = req.job.progress_callback;
+        running_id = req.id;
+        if (is_cancelled(req.id)) {
+            result.status = CRYPTO_JOB_CANCELLED;
+        } else {
+            result.status = run_job(&req.job);
+        }
+        running_id = 0;
+        running_progress = NULL;
+        progress_current = 0;
+        progress_total = 0;
+        memzero(&req, sizeof(req));
+
+        result.elapsed_us = (uint32_t)(esp_timer_get_time() - start);
+        if (xQueueSend(results, &result, 0) != pdPASS) {
+            ESP_LOGW(TAG, "result of job %lu dropped, nobody polls", (unsigned long)result.id);
+        }
+    }
+}
+
+// Undoes a partial crypto_worker_start() so the next call starts over.
+static void delete_queues(void)
+{
+    if (requests != NULL) {
+        vQueueDelete(requests);
+        requests = NULL;
+    }
+    if (results != NULL) {
+        vQueueDelete(results);
+        results = NULL;
+    }
+}
+
+esp_err_t crypto_worker_start(void)
+{
+    if (requests != NULL) {
+        return ESP_OK;
+    }
+
+    requests = xQueueCreate(CRYPTO_WORKER_QUEUE_LEN, sizeof(crypto_request_t));
+    results = xQueueCreate(CRYPTO_WORKER_QUEUE_LEN + 1, sizeof(crypto_result_t));
+    if (requests == NULL || results == NULL) {
+        ESP_LOGE(TAG, "crypto worker: out of memory");
+        delete_queues();
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreatePinnedToCore(crypto_worker_task, "crypto_worker", CRYPTO_WORKER_STACK, NULL,
+                                CRYPTO_WORKER_PRIORITY, NULL, CRYPTO_WORKER_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "crypto worker: task creation failed");
+        delete_queues();
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t crypto_worker_submit(const crypto_job_t *job, uint32_t *id, TickType_t timeout)
+{
+    if (requests == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    crypto_request_t req = { .job = *job };
+    portENTER_CRITICAL(&cancel_mux);
+    req.id = next_id++;
+    if (next_id == 0) {
+        next_id = 1;
+    }
+    portEXIT_CRITICAL(&cancel_mux);
+
+    esp_err_t err = xQueueSend(requests, &req, timeout) == pdPASS ? ESP_OK : ESP_ERR_TIMEOUT;
+    if (err == ESP_OK && id != NULL) {
+        *id = req.id;
+    }
+    memzero(&req, sizeof(req));
+    return err;
+}
+
+bool crypto_worker_poll(crypto_result_t *result, TickType_t timeout)
+{
+    if (results == NULL) {
+        return false;
+    }
+    return xQueueReceive(results, result, timeout) == pdPASS;
+}
+
+void crypto_worker_cancel(uint32_t id)
+{
+    if (id == 0) {
+        return;
+    }
+    portENTER_CRITICAL(&cancel_mux);
+    cancelled[cancelled_next] = id;
+    cancelled_next = (cancelled_next + 1) % (CRYPTO_WORKER_QUEUE_LEN + 1);
+    portEXIT_CRITICAL(&cancel_mux);
+}
+
+void crypto_worker_progress(uint32_t *current, uint32_t *total)
+{
+    *current = progress_current;
+    *total = progress_total;
+}
@@ -0,0 +1,135 @@
+#ifndef CRYPTO_WORKER_H
+#define CRYPTO_WORKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "bip32.h"
+#include "ecdsa.h"
+
+#ifndef CRYPTO_WORKER_CORE
+#define CRYPTO_WORKER_CORE 1  // APP_CPU; UI and Wi-Fi stay on PRO_CPU
+#endif
+
+#ifndef CRYPTO_WORKER_PRIORITY
+#define CRYPTO_WORKER_PRIORITY (tskIDLE_PRIORITY + 3)
+#endif
+
+#ifndef CRYPTO_WORKER_STACK
+#define CRYPTO_WORKER_STACK 8192
+#endif
+
+#ifndef CRYPTO_WORKER_QUEUE_LEN
+#define CRYPTO_WORKER_QUEUE_LEN 4
+#endif
+
+typedef enum {
+    CRYPTO_JOB_SEED,    // mnemonic_to_seed()
+    CRYPTO_JOB_DERIVE,  // hdnode_from_seed() + hdnode_private_ckd() along a path
+    CRYPTO_JOB_SIGN,    // ecdsa_sign_digest()
+    CRYPTO_JOB_VERIFY,  // ecdsa_verify_digest()
+} crypto_job_type_t;
+
+typedef enum {
+    CRYPTO_JOB_OK,
+    CRYPTO_JOB_FAILED,     // the crypto call reported an error or invalid signature
+    CRYPTO_JOB_CANCELLED,  // crypto_worker_cancel() was called for this job
+} crypto_job_status_t;
+
+/**
+ * @brief One request for the crypto worker.
+ *
+ * All pointers refer to caller memory, which must stay valid until the
+ * result for the job has been received.
+ */
+typedef struct {
+    crypto_job_type_t type;
+    union {
+        struct {
+            const char *mnemonic;
+            const char *passphrase;
+            uint8_t *seed;  // 64 bytes out
+        } seed;
+        struct {
+            const uint8_t *seed;
+            int seed_len;
+            const char *curve;  // e.g. SECP256K1_NAME
+            const uint32_t *path;
+            size_t path_len;
+            HDNode *node;  // out, with public key filled in
+        } derive;
+        struct {
+            const ecdsa_curve *curve;
+            const uint8_t *priv_key;
+            const uint8_t *digest;
+            uint8_t *sig;  // 64 bytes out
+            uint8_t *pby;  // recovery byte out, may be NULL
+        } sign;
+        struct {
+            const ecdsa_curve *curve;
+            const uint8_t *pub_key;
+            const uint8_t *sig;
+            const uint8_t *digest;
+        } verify;
+    };
+    // Called on the worker core from mnemonic_to_seed() and after each
+    // derivation step. May be NULL.
+    void (*progress_callback)(uint32_t current, uint32_t total);
+} crypto_job_t;
+
+typedef struct {
+    uint32_t id;
+    crypto_job_type_t type;
+    crypto_job_status_t status;
+    uint32_t elapsed_us;
+} crypto_result_t;
+
+/**
+ * @brief Start the worker task pinned to CRYPTO_WORKER_CORE.
+ *
+ * @return ESP_OK or ESP_ERR_NO_MEM.
+ */
+esp_err_t crypto_worker_start(void);
+
+/**
+ * @brief Queue a job for the worker.
+ *
+ * @param job Request, copied into the queue.
+ * @param id Output: id reported back in the job's crypto_result_t.
+ * @param timeout How long to wait for a free queue slot.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE before crypto_worker_start() or
+ *         ESP_ERR_TIMEOUT when the queue stayed full.
+ */
+esp_err_t crypto_worker_submit(const crypto_job_t *job, uint32_t *id, TickType_t timeout);
+
+/**
+ * @brief Fetch the next finished job.
+ *
+ * @param result Output.
+ * @param timeout 0 to poll from a UI loop.
+ * @return true if a result was received.
+ */
+bool crypto_worker_poll(crypto_result_t *result, TickType_t timeout);
+
+/**
+ * @brief Cancel a queued or running job.
+ *
+ * A running seed job stops at its next progress step, a derivation at
+ * its next path element; sign and verify are too short to interrupt and
+ * only cancel while queued. The job still produces a result.
+ *
+ * @param id Job id from crypto_worker_submit().
+ */
+void crypto_worker_cancel(uint32_t id);
+
+/**
+ * @brief Progress of the running job, for drawing from the UI core.
+ *
+ * @param current Output, 0 when idle.
+ * @param total Output, 0 when idle.
+ */
+void crypto_worker_progress(uint32_t *current, uint32_t *total);
+
+#endif // CRYPTO_WORKER_H
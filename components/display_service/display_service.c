@@ -0,0 +1,262 @@
+#include "display_service.h"
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "trace.h"
+
+#define DISPLAY_IDLE_BIT BIT0
+
+static const char *TAG = "display";
+
+// Three frames: "pending" is the last submitted frame, "work" is the frame
+// the flush task is putting on the bus, "sent" is what the display shows.
+// The app keeps drawing into the u8g2 buffer itself.
+static u8g2_t *disp;
+static uint8_t *pending;
+static uint8_t *work;
+static uint8_t *sent;
+static size_t frame_size;
+static uint8_t tile_w;
+static uint8_t tile_h;
+static bool has_pending;
+static bool force_full = true;
+static int power_save_req = -1;  // -1: none, else the u8x8 power save value
+static display_stats_t stats;
+
+static SemaphoreHandle_t lock;
+static EventGroupHandle_t events;
+static TaskHandle_t flush_task;
+
+/**
+ * @brief Write the tiles of "work" that differ from "sent".
+ *
+ * Changed tiles are sent as one u8x8_DrawTile() call per run, so an
+ * unchanged frame costs no I2C traffic and a moving caret costs a few
+ * tiles instead of the whole 512 byte frame.
+ *
+ * @return Number of tiles written.
+ */
+static uint32_t flush_diff(bool full)
+{
+    u8x8_t *u8x8 = u8g2_GetU8x8(disp);
+    uint32_t tiles = 0;
+
+    for (uint8_t row = 0; row < tile_h; row++) {
+        size_t offset = (size_t)row * tile_w * 8;
+        uint8_t x = 0;
+
+        while (x < tile_w) {
+            if (!full && memcmp(work + offset + x * 8, sent + offset + x * 8, 8) == 0) {
+                x++;
+                continue;
+            }
+            uint8_t start = x;
+            while (x < tile_w &&
+                   (full || memcmp(work + offset + x * 8, sent + offset + x * 8, 8) != 0)) {
+                x++;
+            }
+            u8x8_DrawTile(u8x8, start, row, x - start, work + offset + start * 8);
+            tiles += x - start;
+        }
+    }
+    if (tiles > 0) {
+        u8x8_RefreshDisplay(u8x8);
+    }
+    return tiles;
+}
+
+static void display_flush_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (1) {
+            xSemaphoreTake(lock, portMAX_DELAY);
+            if (!has_pending) {
+                // After the frames, so a panel coming out of power save
+                // shows the new frame and not the one it went to sleep with.
+                int power_save = power_save_req;
+                power_save_req = -1;
+                if (power_save < 0) {
+                    xEventGroupSetBits(events, DISPLAY_IDLE_BIT);
+                }
+                xSemaphoreGive(lock);
+                if (power_save < 0) {
+                    break;
+                }
+                u8x8_SetPowerSave(u8g2_GetU8x8(disp), (uint8_t)power_save);
+                continue;
+            }
+            uint8_t *tmp = work;
+            work = pending;
+            pending = tmp;
+            has_pending = false;
+            bool full = force_full;
+            force_full = false;
+            xSemaphoreGive(lock);
+
+            TRACE_BEGIN(trace_start);
+            int64_t start = esp_timer_get_time();
+            uint32_t tiles = flush_diff(full);
+            uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+            TRACE_END(trace_start, TRACE_DISPLAY_FLUSH, tiles, 0, 0, 0);
+
+            tmp = sent;
+            sent = work;
+            work = tmp;
+
+            xSemaphoreTake(lock, portMAX_DELAY);
+            if (tiles > 0) {
+                stats.frames_flushed++;
+                stats.tiles_sent += tiles;
+                stats.last_flush_us = elapsed;
+                if (elapsed > stats.max_flush_us) {
+                    stats.max_flush_us = elapsed;
+                }
+            } else {
+                stats.frames_unchanged++;
+            }
+            xSemaphoreGive(lock);
+        }
+    }
+}
+
+// Undo a partial display_service_start(), so that a later call starts over
+// and display_service_submit() keeps drawing directly.
+static void display_service_cleanup(void)
+{
+    if (events != NULL) {
+        vEventGroupDelete(events);
+        events = NULL;
+    }
+    if (lock != NULL) {
+        vSemaphoreDelete(lock);
+        lock = NULL;
+    }
+    free(pending);
+    pending = NULL;
+    work = NULL;
+    sent = NULL;
+    frame_size = 0;
+    disp = NULL;
+    has_pending = false;
+    force_full = true;
+    flush_task = NULL;
+}
+
+esp_err_t display_service_start(u8g2_t *u8g2)
+{
+    if (flush_task != NULL) {
+        return ESP_OK;
+    }
+    if (u8g2_GetBufferTileHeight(u8g2) != u8g2_GetU8x8(u8g2)->display_info->tile_height) {
+        ESP_LOGE(TAG, "display service needs a full frame buffer");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    disp = u8g2;
+    tile_w = u8g2_GetBufferTileWidth(u8g2);
+    tile_h = u8g2_GetBufferTileHeight(u8g2);
+    frame_size = (size_t)tile_w * tile_h * 8;
+
+    pending = calloc(3, frame_size);
+    if (pending == NULL) {
+        display_service_cleanup();
+        return ESP_ERR_NO_MEM;
+    }
+    work = pending + frame_size;
+    sent = work + frame_size;
+
+    lock = xSemaphoreCreateMutex();
+    events = xEventGroupCreate();
+    if (lock == NULL || events == NULL) {
+        ESP_LOGE(TAG, "display service: out of memory");
+        display_service_cleanup();
+        return ESP_ERR_NO_MEM;
+    }
+    xEventGroupSetBits(events, DISPLAY_IDLE_BIT);
+
+    if (xTaskCreate(display_flush_task, "display_flush", DISPLAY_SERVICE_TASK_STACK,
+                    NULL, DISPLAY_SERVICE_TASK_PRIORITY, &flush_task) != pdPASS) {
+        ESP_LOGE(TAG, "display service: task creation failed");
+        display_service_cleanup();
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "display service started (%u byte frames)", (unsigned)frame_size);
+    return ESP_OK;
+}
+
+void display_service_submit(u8g2_t *u8g2)
+{
+    if (flush_task == NULL) {
+        TRACE_BEGIN(trace_start);
+        u8g2_SendBuffer(u8g2);
+        TRACE_END(trace_start, TRACE_DISPLAY_FLUSH,
+                  u8g2_GetBufferTileWidth(u8g2) * u8g2_GetBufferTileHeight(u8g2), 0, 0, 0);
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    memcpy(pending, u8g2_GetBufferPtr(u8g2), frame_size);
+    if (has_pending) {
+        stats.frames_dropped++;
+    }
+    has_pending = true;
+    stats.frames_submitted++;
+    xEventGroupClearBits(events, DISPLAY_IDLE_BIT);
+    xSemaphoreGive(lock);
+
+    xTaskNotifyGive(flush_task);
+}
+
+bool display_service_wait_idle(TickType_t timeout)
+{
+    if (flush_task == NULL) {
+        return true;
+    }
+    EventBits_t bits = xEventGroupWaitBits(events, DISPLAY_IDLE_BIT, pdFALSE, pdTRUE, timeout);
+    return (bits & DISPLAY_IDLE_BIT) != 0;
+}
+
+void display_service_invalidate(void)
+{
+    if (flush_task == NULL) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    force_full = true;
+    xSemaphoreGive(lock);
+}
+
+void display_service_set_power_save(u8g2_t *u8g2, bool on)
+{
+    if (flush_task == NULL) {
+        u8g2_SetPowerSave(u8g2, on ? 1 : 0);
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    power_save_req = on ? 1 : 0;
+    xEventGroupClearBits(events, DISPLAY_IDLE_BIT);
+    xSemaphoreGive(lock);
+
+    xTaskNotifyGive(flush_task);
+    display_service_wait_idle(portMAX_DELAY);
+}
+
+void display_service_get_stats(display_stats_t *out)
+{
+    if (flush_task == NULL) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(lock);
+}
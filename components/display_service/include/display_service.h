@@ -0,0 +1,85 @@
+#ifndef DISPLAY_SERVICE_H
+#define DISPLAY_SERVICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "u8g2.h"
+
+#ifndef DISPLAY_SERVICE_TASK_PRIORITY
+#define DISPLAY_SERVICE_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#endif
+
+#ifndef DISPLAY_SERVICE_TASK_STACK
+#define DISPLAY_SERVICE_TASK_STACK 3072
+#endif
+
+typedef struct {
+    uint32_t frames_submitted;  // display_service_submit() calls
+    uint32_t frames_flushed;    // frames that reached the display
+    uint32_t frames_dropped;    // frames replaced by a newer one before flushing
+    uint32_t frames_unchanged;  // frames equal to the last one sent (no I2C traffic)
+    uint32_t tiles_sent;        // 8x8 tiles written over I2C in total
+    uint32_t last_flush_us;     // duration of the last flush
+    uint32_t max_flush_us;      // longest flush so far
+} display_stats_t;
+
+/**
+ * @brief Start the display flush task for a full-buffer u8g2 instance.
+ *
+ * After this call the display (u8x8 side of u8g2) belongs to the flush
+ * task; the app only draws into the u8g2 buffer and calls
+ * display_service_submit().
+ *
+ * @param u8g2 Pointer to an initialized, full-buffer U8g2 instance.
+ * @return ESP_OK, ESP_ERR_NO_MEM, or ESP_ERR_NOT_SUPPORTED for page buffers.
+ */
+esp_err_t display_service_start(u8g2_t *u8g2);
+
+/**
+ * @brief Hand the current u8g2 buffer to the flush task and return.
+ *
+ * The buffer is copied, so the caller may start drawing the next frame
+ * right away. A frame still waiting for the bus is replaced (counted as
+ * dropped). Before display_service_start() this is u8g2_SendBuffer().
+ *
+ * @param u8g2 Pointer to U8g2 instance.
+ */
+void display_service_submit(u8g2_t *u8g2);
+
+/**
+ * @brief Block until every submitted frame is on the display.
+ *
+ * @param timeout Maximum time to wait.
+ * @return true if the display is up to date.
+ */
+bool display_service_wait_idle(TickType_t timeout);
+
+/**
+ * @brief Force the next frame to be sent in full, e.g. after the display
+ *        controller lost its RAM content.
+ */
+void display_service_invalidate(void);
+
+/**
+ * @brief Put the display controller into or out of power save (display
+ *        off, RAM kept) and wait until it is done.
+ *
+ * Frames submitted before the call are flushed first, so submitting the
+ * next frame and then switching power save off never shows the frame the
+ * display went to sleep with.
+ *
+ * @param u8g2 Pointer to U8g2 instance.
+ * @param on true to switch the display off.
+ */
+void display_service_set_power_save(u8g2_t *u8g2, bool on);
+
+/**
+ * @brief Copy the frame counters.
+ *
+ * @param stats Output.
+ */
+void display_service_get_stats(display_stats_t *stats);
+
+#endif // DISPLAY_SERVICE_H
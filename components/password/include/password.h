@@ -15,16 +15,26 @@ void update_password(int selectedIndex, int pinIndex, int pinCode[4]);
 // Show PIN OK confirmation
 void show_password_confirmed();
 
-// Save the PIN to NVS
+// Save the PIN to the wallet state and commit it to flash
 void save_pin_to_nvs(const int pinCode[4]);
 
-// Check if a PIN exists in NVS
+// Check if a PIN exists in the wallet state (RAM, no flash read)
 bool is_password_set();
 
-// Verify the entered PIN
-bool verify_pin(const int pinCode[4]);
+typedef enum {
+    PIN_OK,
+    PIN_WRONG,
+    PIN_STORAGE_ERROR,  // the attempt could not be counted, PIN not checked
+} pin_result_t;
 
-// Full PIN input flow
+// Count an attempt in flash, then verify the entered PIN; the count is
+// cleared on a match
+pin_result_t verify_pin(const int pinCode[4]);
+
+// Show that the wallet state cannot be read or written
+void show_storage_error();
+
+// Full PIN input flow; false when the wallet state is locked
 bool handle_password_flow();
 
 #endif
@@ -1,20 +1,20 @@
 #include "password.h"
 #include "button_listener.h"
-#include "nvs.h"
+#include "display_service.h"
+#include "ui_fonts.h"
+#include "wallet_state.h"
 #include <string.h>
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 #define PIN_LENGTH     4
-#define NVS_NAMESPACE  "storage"
-#define NVS_KEY        "pin_code"
 
 extern u8g2_t u8g2;
 
 void update_password(int selectedIndex, int pinIndex, int pinCode[4]) {
     u8g2_ClearBuffer(&u8g2);
-    u8g2_SetFont(&u8g2, u8g2_font_6x10_tf);
+    u8g2_SetFont(&u8g2, ui_font_6x10);
 
     // Title
     u8g2_DrawStr(&u8g2, 30, 15, "Choose PIN");
@@ -34,55 +34,69 @@ void update_password(int selectedIndex, int pinIndex, int pinCode[4]) {
     }
     u8g2_DrawStr(&u8g2, 50, 62, stars);
 
-    u8g2_SendBuffer(&u8g2);
+    display_service_submit(&u8g2);
 }
 
 void show_password_confirmed() {
     u8g2_ClearBuffer(&u8g2);
-    u8g2_SetFont(&u8g2, u8g2_font_6x10_tf);
+    u8g2_SetFont(&u8g2, ui_font_6x10);
     u8g2_DrawStr(&u8g2, 40, 32, "PIN OK!");
-    u8g2_SendBuffer(&u8g2);
+    display_service_submit(&u8g2);
     vTaskDelay(pdMS_TO_TICKS(1500));
 }
 
 void save_pin_to_nvs(const int pinCode[4]) {
-    nvs_handle_t handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
-    if (err == ESP_OK) {
-        err = nvs_set_blob(handle, NVS_KEY, pinCode, PIN_LENGTH * sizeof(int));
-        if (err == ESP_OK) {
-            nvs_commit(handle);
-        }
-        nvs_close(handle);
+    uint8_t digits[PIN_LENGTH];
+    for (int i = 0; i < PIN_LENGTH; i++) {
+        digits[i] = (uint8_t)pinCode[i];
+    }
+    if (wallet_state_set(WALLET_REC_PIN, digits, sizeof(digits)) == ESP_OK) {
+        wallet_state_commit();
     }
+    memset(digits, 0, sizeof(digits));
 }
 
 bool is_password_set() {
-    nvs_handle_t handle;
-    size_t required_size = 0;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
-    if (err != ESP_OK) return false;
-
-    err = nvs_get_blob(handle, NVS_KEY, NULL, &required_size);
-    nvs_close(handle);
-    return (err == ESP_OK && required_size == PIN_LENGTH * sizeof(int));
+    uint8_t digits[PIN_LENGTH];
+    size_t size = sizeof(digits);
+    bool set = wallet_state_get(WALLET_REC_PIN, digits, &size) && size == PIN_LENGTH;
+    memset(digits, 0, sizeof(digits));
+    return set;
 }
 
-bool verify_pin(const int pinCode[4]) {
-    int storedPin[PIN_LENGTH];
+pin_result_t verify_pin(const int pinCode[4]) {
+    uint8_t storedPin[PIN_LENGTH];
     size_t size = sizeof(storedPin);
+    bool match = false;
+
+    // Count the attempt before comparing: cutting power once a wrong PIN
+    // shows must not undo it. Without a stored count there is no attempt.
+    uint32_t fails = wallet_state_counter(WALLET_COUNTER_PIN_FAILS);
+    if (fails == UINT32_MAX ||
+        wallet_state_counter_set(WALLET_COUNTER_PIN_FAILS, fails + 1) != ESP_OK) {
+        return PIN_STORAGE_ERROR;
+    }
 
-    nvs_handle_t handle;
-    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
-    if (err != ESP_OK) return false;
-
-    err = nvs_get_blob(handle, NVS_KEY, storedPin, &size);
-    nvs_close(handle);
+    if (wallet_state_get(WALLET_REC_PIN, storedPin, &size) && size == PIN_LENGTH) {
+        match = true;
+        for (int i = 0; i < PIN_LENGTH; i++) {
+            match &= storedPin[i] == pinCode[i];
+        }
+    }
+    memset(storedPin, 0, sizeof(storedPin));
 
-    if (err != ESP_OK || size != sizeof(storedPin)) {
-        return false;
+    if (match) {
+        // If this write fails the count only stays one too high.
+        wallet_state_counter_set(WALLET_COUNTER_PIN_FAILS, 0);
     }
-    return memcmp(storedPin, pinCode, sizeof(storedPin)) == 0;
+    return match ? PIN_OK : PIN_WRONG;
+}
+
+void show_storage_error() {
+    u8g2_ClearBuffer(&u8g2);
+    u8g2_SetFont(&u8g2, ui_font_6x10);
+    u8g2_DrawStr(&u8g2, 20, 32, "Storage error");
+    display_service_submit(&u8g2);
 }
 
 bool handle_password_flow() {
@@ -90,6 +104,12 @@ bool handle_password_flow() {
     int pinCode[PIN_LENGTH] = {0};
     int pinIndex = 0;
 
+    // The stored state could not be read; an empty one does not mean that
+    // no PIN was set, so never offer to choose one.
+    if (wallet_state_locked()) {
+        show_storage_error();
+        return false;
+    }
     update_password(selectedIndex, pinIndex, pinCode);
 
     while (true) {
@@ -121,13 +141,18 @@ bool handle_password_flow() {
                         show_password_confirmed();
                         return true;
                     } else {
-                        if (verify_pin(pinCode)) {
+                        pin_result_t res = verify_pin(pinCode);
+                        if (res == PIN_OK) {
                             show_password_confirmed();
                             return true;
                         } else {
-                            u8g2_ClearBuffer(&u8g2);
-                            u8g2_DrawStr(&u8g2, 30, 32, "Wrong PIN!");
-                            u8g2_SendBuffer(&u8g2);
+                            if (res == PIN_STORAGE_ERROR) {
+                                show_storage_error();
+                            } else {
+                                u8g2_ClearBuffer(&u8g2);
+                                u8g2_DrawStr(&u8g2, 30, 32, "Wrong PIN!");
+                                display_service_submit(&u8g2);
+                            }
                             vTaskDelay(pdMS_TO_TICKS(2000));
                             pinIndex = 0;
                             selectedIndex = 0;
@@ -0,0 +1,74 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "u8g2.h"
+
+// Idle time before the display and the ATECC are put to sleep and the
+// ESP32 enters light sleep. Any button wakes it; RAM and the unlocked
+// session survive.
+#ifndef POWER_LIGHT_SLEEP_AFTER_MS
+#define POWER_LIGHT_SLEEP_AFTER_MS 30000
+#endif
+
+// Time in light sleep before switching to deep sleep. Deep sleep locks
+// the wallet and only the RTC capable button wakes it.
+#ifndef POWER_DEEP_SLEEP_AFTER_MS
+#define POWER_DEEP_SLEEP_AFTER_MS (10 * 60 * 1000)
+#endif
+
+typedef struct {
+    uint32_t light_sleeps;      // light sleeps since boot
+    uint32_t last_light_us;     // time spent in the last light sleep
+    uint32_t last_wake_us;      // button wake to display on, last light sleep
+    uint32_t max_wake_us;       // longest button wake to display on
+    uint32_t deep_sleeps;       // deep sleeps since power on
+} power_stats_t;
+
+/**
+ * @brief Check whether this boot is a wake from power_manager deep sleep.
+ *
+ * Call first thing in app_main. On a resume the display controller is
+ * still initialized (in power save, RAM kept), so the caller can skip
+ * u8g2_InitDisplay() and the splash screen and go straight to the PIN
+ * screen; power_manager_display_on() then switches the display back on.
+ *
+ * @return true on a resume with a valid session in RTC memory.
+ */
+bool power_manager_resumed(void);
+
+/**
+ * @brief Set the display the power manager switches off and on, and the
+ *        button GPIOs that wake the device.
+ *
+ * Call after init_button_listener(). Adds a falling edge interrupt on each
+ * button (installing the GPIO ISR service if needed), so presses between
+ * two power_manager_idle() calls count as activity.
+ */
+esp_err_t power_manager_init(u8g2_t *u8g2);
+
+/**
+ * @brief Note user activity, restarting the idle timeout.
+ */
+void power_manager_touch(void);
+
+/**
+ * @brief Sleep if the device has been idle for POWER_LIGHT_SLEEP_AFTER_MS.
+ *
+ * Call from the main loop. Returns after a button woke the device from
+ * light sleep with the display back on; does not return when the device
+ * goes on to deep sleep.
+ */
+void power_manager_idle(void);
+
+/**
+ * @brief Switch the display out of power save after a resume, once the
+ *        first frame has been submitted.
+ */
+void power_manager_display_on(void);
+
+void power_manager_get_stats(power_stats_t *stats);
+
+#endif // POWER_MANAGER_H
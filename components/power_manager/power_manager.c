@@ -0,0 +1,236 @@
+#include "power_manager.h"
+#include <stddef.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "driver/rtc_io.h"
+#include "esp_sleep.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "esp_log.h"
+#include "button_listener.h"
+#include "display_service.h"
+#include "cryptoauthlib.h"
+
+#define SESSION_MAGIC 0x31534d50  // "PMS1"
+
+static const char *TAG = "power";
+
+// Kept in RTC slow memory across deep sleep (cleared on power on). It
+// holds no secrets: deep sleep locks the wallet, the session only records
+// that the display controller was initialized and left in power save.
+typedef struct {
+    uint32_t magic;
+    uint32_t deep_sleeps;
+    int64_t sleep_at_us;  // gettimeofday(), which keeps running in deep sleep
+    int32_t wake_gpio;
+    uint32_t crc;
+} rtc_session_t;
+
+static RTC_DATA_ATTR rtc_session_t session;
+
+#define BUTTON_COUNT 3
+
+static u8g2_t *disp;
+static gpio_num_t buttons[BUTTON_COUNT];
+static gpio_num_t wake_gpio = GPIO_NUM_NC;  // button that can wake from deep sleep
+static int64_t last_activity;
+static volatile bool button_edge;  // set by the button ISR, taken by power_manager_idle()
+static bool resume_checked;
+static bool resumed;
+static power_stats_t stats;
+
+static uint32_t session_crc(void)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)&session, offsetof(rtc_session_t, crc));
+}
+
+static int64_t wall_time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static bool any_button_pressed(void)
+{
+    return is_button_left_pressed() || is_button_right_pressed() || is_button_middle_pressed();
+}
+
+// A press between two power_manager_idle() calls would be missed by
+// polling alone; the edge keeps it until the next call.
+static void IRAM_ATTR button_isr(void *arg)
+{
+    (void)arg;
+    button_edge = true;
+}
+
+// Light sleep wakes on a low level, which as a running interrupt would
+// fire for as long as the button is held. The edge interrupt is swapped
+// out for the wakeup while sleeping and back in after.
+static void buttons_wakeup_enable(bool enable)
+{
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        gpio_num_t gpio = buttons[i];
+        if (enable) {
+            gpio_intr_disable(gpio);
+            gpio_wakeup_enable(gpio, GPIO_INTR_LOW_LEVEL);
+        } else {
+            gpio_wakeup_disable(gpio);
+            gpio_set_intr_type(gpio, GPIO_INTR_NEGEDGE);
+            gpio_intr_enable(gpio);
+        }
+    }
+}
+
+bool power_manager_resumed(void)
+{
+    if (resume_checked) {
+        return resumed;
+    }
+    resume_checked = true;
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0 &&
+        session.magic == SESSION_MAGIC && session.crc == session_crc()) {
+        resumed = true;
+        // Give the wake button back to the digital GPIO matrix.
+        rtc_gpio_deinit((gpio_num_t)session.wake_gpio);
+        ESP_LOGI(TAG, "resumed after %lld ms of deep sleep",
+                 (long long)((wall_time_us() - session.sleep_at_us) / 1000));
+    }
+    stats.deep_sleeps = session.deep_sleeps;
+    session.magic = 0;
+    return resumed;
+}
+
+esp_err_t power_manager_init(u8g2_t *u8g2)
+{
+    disp = u8g2;
+    buttons[0] = BUTTON_LEFT;
+    buttons[1] = BUTTON_RIGHT;
+    buttons[2] = BUTTON_MIDDLE;
+    power_manager_resumed();
+
+    // Already installed by another component is fine.
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return err;
+    }
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        gpio_num_t gpio = buttons[i];
+        err = gpio_set_intr_type(gpio, GPIO_INTR_NEGEDGE);
+        if (err == ESP_OK) {
+            err = gpio_isr_handler_add(gpio, button_isr, NULL);
+        }
+        if (err != ESP_OK) {
+            return err;
+        }
+        // Only RTC GPIOs can wake the chip from deep sleep (ext0).
+        if (wake_gpio == GPIO_NUM_NC && rtc_gpio_is_valid_gpio(gpio)) {
+            wake_gpio = gpio;
+        }
+    }
+    err = esp_sleep_enable_gpio_wakeup();
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (wake_gpio == GPIO_NUM_NC) {
+        ESP_LOGW(TAG, "no button on an RTC GPIO, deep sleep disabled");
+    }
+
+    power_manager_touch();
+    return ESP_OK;
+}
+
+void power_manager_touch(void)
+{
+    last_activity = esp_timer_get_time();
+}
+
+/**
+ * @brief Hand control to the ROM with the RTC session written. The wake
+ *        is a reset; app_main finds the session via power_manager_resumed().
+ */
+static void enter_deep_sleep(void)
+{
+    session.deep_sleeps++;
+    session.sleep_at_us = wall_time_us();
+    session.wake_gpio = wake_gpio;
+    session.magic = SESSION_MAGIC;
+    session.crc = session_crc();
+
+    // ext0 keeps the RTC peripherals powered, so the internal pull-up of
+    // the wake button stays on.
+    rtc_gpio_pullup_en(wake_gpio);
+    rtc_gpio_pulldown_dis(wake_gpio);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    esp_sleep_enable_ext0_wakeup(wake_gpio, 0);
+
+    ESP_LOGI(TAG, "deep sleep, wake on GPIO %d", wake_gpio);
+    esp_deep_sleep_start();
+}
+
+void power_manager_idle(void)
+{
+    if (disp == NULL) {
+        return;
+    }
+    if (button_edge || any_button_pressed()) {
+        button_edge = false;
+        power_manager_touch();
+        return;
+    }
+    if (esp_timer_get_time() - last_activity < (int64_t)POWER_LIGHT_SLEEP_AFTER_MS * 1000) {
+        return;
+    }
+
+    display_service_set_power_save(disp, true);
+    // Set once task_ateccInit() brought the ATECC up; the next command
+    // wakes it again.
+    if (atcab_get_device() != NULL && atcab_sleep() != ATCA_SUCCESS) {
+        ESP_LOGW(TAG, "ATECC did not go to sleep");
+    }
+    if (wake_gpio != GPIO_NUM_NC) {
+        esp_sleep_enable_timer_wakeup((uint64_t)POWER_DEEP_SLEEP_AFTER_MS * 1000);
+    }
+
+    ESP_LOGI(TAG, "light sleep");
+    buttons_wakeup_enable(true);
+    int64_t start = esp_timer_get_time();
+    esp_light_sleep_start();
+    int64_t wake = esp_timer_get_time();
+
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER) {
+        enter_deep_sleep();
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+    buttons_wakeup_enable(false);
+
+    display_service_set_power_save(disp, false);
+    button_edge = false;  // the wake press
+    uint32_t wake_us = (uint32_t)(esp_timer_get_time() - wake);
+
+    stats.light_sleeps++;
+    stats.last_light_us = (uint32_t)(wake - start);
+    stats.last_wake_us = wake_us;
+    if (wake_us > stats.max_wake_us) {
+        stats.max_wake_us = wake_us;
+    }
+    ESP_LOGI(TAG, "woke after %lu ms, display on in %lu us",
+             (unsigned long)(stats.last_light_us / 1000), (unsigned long)wake_us);
+    power_manager_touch();
+}
+
+void power_manager_display_on(void)
+{
+    if (disp != NULL) {
+        display_service_set_power_save(disp, false);
+    }
+}
+
+void power_manager_get_stats(power_stats_t *out)
+{
+    *out = stats;
+}
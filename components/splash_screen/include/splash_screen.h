@@ -1,18 +1,46 @@
 #ifndef SPLASH_SCREEN_H
 #define SPLASH_SCREEN_H
 
+#include <stdint.h>
 #include "u8g2.h"
 
-typedef void (*InitTask)();
+#ifndef SPLASH_MAX_TASKS
+#define SPLASH_MAX_TASKS 24  // one event group bit per task
+#endif
+
+#ifndef SPLASH_TASK_STACK
+#define SPLASH_TASK_STACK 4096
+#endif
+
+// Dependency bit for the init task at index i of the array.
+#define INIT_DEP(i) (1UL << (i))
+
+/**
+ * @brief One boot initialization step.
+ *
+ * Each task runs on its own FreeRTOS task, on whichever core is free, as
+ * soon as every task named in deps has finished. deps may only name
+ * earlier entries of the array.
+ */
+typedef struct {
+    const char *name;
+    void (*run)(void);
+    uint32_t deps;  // INIT_DEP(i) | INIT_DEP(j) ...
+} InitTask;
 
 /**
  * @brief Show splash screen with U8g2 driver.
  *
- * @param u8g2 Pointer to U8g2 instance.
- * @param tasks Array of init functions to run during splash.
- * @param taskCount Number of init tasks.
+ * Runs the init tasks concurrently, honoring their dependencies, advances
+ * the progress bar as each one completes, logs per-task timings and
+ * returns once all of them are done.
+ *
+ * @param u8g2 Pointer to U8g2 instance, or NULL to run the tasks without
+ *             drawing (resume from deep sleep).
+ * @param tasks Array of init tasks to run during splash.
+ * @param taskCount Number of init tasks (at most SPLASH_MAX_TASKS).
  */
-void show_splash_screen(u8g2_t *u8g2, InitTask tasks[], int taskCount);
+void show_splash_screen(u8g2_t *u8g2, const InitTask tasks[], int taskCount);
 
 
 /**
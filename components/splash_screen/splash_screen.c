@@ -1,6 +1,32 @@
 #include "splash_screen.h"
+#include "display_service.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "splash";
+
+typedef struct {
+    const InitTask *task;
+    int index;
+    uint32_t deps;
+} init_ctx_t;
+
+typedef struct {
+    int index;
+    int64_t start_us;  // since show_splash_screen() was entered
+    int64_t run_us;
+} init_report_t;
+
+// Created once and never deleted: a finishing init task may still be
+// inside xQueueSend() when the splash screen gets its report.
+static EventGroupHandle_t init_done;
+static QueueHandle_t init_reports;
+static init_ctx_t init_ctx[SPLASH_MAX_TASKS];
+static int64_t boot_start;
 
 
 static const uint8_t ethereum_logo[] = {
@@ -40,22 +66,85 @@ void draw_splash_progress(u8g2_t *u8g2, int progress_percent) {
     u8g2_DrawFrame(u8g2, 0, barY, barWidth, barHeight);
     u8g2_DrawBox(u8g2, 1, barY + 1, (barWidth - 2) * progress_percent / 100, barHeight - 2);
 
-    u8g2_SendBuffer(u8g2);
+    display_service_submit(u8g2);
+}
+
+static void report_progress(u8g2_t *u8g2, int progress_percent) {
+    if (u8g2 != NULL) {
+        draw_splash_progress(u8g2, progress_percent);
+    }
 }
 
 /**
- * @brief Show splash screen and sequentially run init tasks.
+ * @brief Wait for the dependencies of one init task, run it and report.
  */
-void show_splash_screen(u8g2_t *u8g2, InitTask tasks[], int task_count) {
-    draw_splash_progress(u8g2, 0);
-    vTaskDelay(pdMS_TO_TICKS(500));
+static void run_init_task(init_ctx_t *ctx) {
+    if (ctx->deps) {
+        xEventGroupWaitBits(init_done, ctx->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    init_report_t report = { .index = ctx->index };
+    int64_t start = esp_timer_get_time();
+    ctx->task->run();
+    report.start_us = start - boot_start;
+    report.run_us = esp_timer_get_time() - start;
+
+    xEventGroupSetBits(init_done, INIT_DEP(ctx->index));
+    xQueueSend(init_reports, &report, portMAX_DELAY);
+}
+
+static void init_task_entry(void *arg) {
+    run_init_task((init_ctx_t *)arg);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Show splash screen and run the init tasks concurrently.
+ */
+void show_splash_screen(u8g2_t *u8g2, const InitTask tasks[], int task_count) {
+    boot_start = esp_timer_get_time();
+    report_progress(u8g2, 0);
+
+    if (task_count > SPLASH_MAX_TASKS) {
+        ESP_LOGE(TAG, "%d init tasks, only %d supported", task_count, SPLASH_MAX_TASKS);
+        task_count = SPLASH_MAX_TASKS;
+    }
+    if (init_done == NULL) {
+        init_done = xEventGroupCreate();
+        init_reports = xQueueCreate(SPLASH_MAX_TASKS, sizeof(init_report_t));
+    }
+    if (init_done == NULL || init_reports == NULL) {
+        // No scheduler state: fall back to running the tasks in order.
+        for (int i = 0; i < task_count; ++i) {
+            tasks[i].run();
+            report_progress(u8g2, ((i + 1) * 100) / task_count);
+        }
+        return;
+    }
+    xEventGroupClearBits(init_done, INIT_DEP(SPLASH_MAX_TASKS) - 1);
 
     for (int i = 0; i < task_count; ++i) {
-        tasks[i]();
-        int progress = ((i + 1) * 100) / task_count;
-        draw_splash_progress(u8g2, progress);
-        vTaskDelay(pdMS_TO_TICKS(200));
+        init_ctx_t *ctx = &init_ctx[i];
+        ctx->task = &tasks[i];
+        ctx->index = i;
+        ctx->deps = tasks[i].deps & (INIT_DEP(i) - 1);
+        if (ctx->deps != tasks[i].deps) {
+            ESP_LOGE(TAG, "init task %s depends on a later task, ignored", tasks[i].name);
+        }
+        if (xTaskCreate(init_task_entry, tasks[i].name, SPLASH_TASK_STACK, ctx,
+                        uxTaskPriorityGet(NULL), NULL) != pdPASS) {
+            // Dependencies are earlier entries, so running inline is safe.
+            run_init_task(ctx);
+        }
     }
 
-    vTaskDelay(pdMS_TO_TICKS(500));
-}
\ No newline at end of file
+    for (int done = 1; done <= task_count; ++done) {
+        init_report_t report;
+        xQueueReceive(init_reports, &report, portMAX_DELAY);
+        ESP_LOGI(TAG, "init %s: started at %lld us, took %lld us",
+                 tasks[report.index].name, (long long)report.start_us, (long long)report.run_us);
+        report_progress(u8g2, (done * 100) / task_count);
+    }
+
+    ESP_LOGI(TAG, "init done in %lld us", (long long)(esp_timer_get_time() - boot_start));
+}
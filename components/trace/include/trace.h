@@ -0,0 +1,83 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+// Timing probes for the I2C bus, the ATECC, the display and the crypto
+// worker, recorded into a RAM ring buffer and dumped over the console in
+// the Chrome trace event format (load it in ui.perfetto.dev or
+// chrome://tracing).
+//
+// The probes compile to nothing unless CONFIG_TRACE_ENABLE is set
+// (menuconfig: Trace). When enabled a probe costs two esp_timer reads and
+// one 20 byte store under a spinlock.
+//
+// trace_dump() prints the JSON between two marker lines, to cut it out of
+// a serial log:
+//
+//   sed -n '/^=== TRACE BEGIN/,/^=== TRACE END/{//!p}' log.txt > trace.json
+
+/**
+ * @brief Traced operations. Arguments a (32 bit) and b, c, d (16 bit) are
+ *        named per event in trace.c.
+ */
+typedef enum {
+    TRACE_ATCA_COMMAND,     // calib_execute_command(): opcode, rx bytes, wait ms, polls
+    TRACE_I2C_SEND,         // hal_i2c_send(): address, bytes, status
+    TRACE_I2C_RECEIVE,      // hal_i2c_receive(): address, bytes, status
+    TRACE_DISPLAY_FLUSH,    // display frame to the SSD1306: tiles
+    TRACE_MNEMONIC_TO_SEED, // crypto worker: completed
+    TRACE_HDNODE_CKD,       // crypto worker, hdnode_private_ckd(): index, depth, ok
+    TRACE_ECDSA_SIGN,       // crypto worker, ecdsa_sign_digest(): result
+    TRACE_ECDSA_VERIFY,     // crypto worker, ecdsa_verify_digest(): result
+    TRACE_EVENT_COUNT,
+} trace_event_t;
+
+typedef struct {
+    uint32_t start_us;  // esp_timer_get_time(), wraps after 71 minutes
+    uint32_t dur_us;
+    uint32_t a;
+    uint16_t b;
+    uint16_t c;
+    uint16_t d;
+    uint8_t event;      // trace_event_t
+    uint8_t core;
+} trace_record_t;
+
+#if CONFIG_TRACE_ENABLE
+
+uint32_t trace_now(void);
+
+/**
+ * @brief Store one event that started at start_us and ends now.
+ *        Overwrites the oldest event when the buffer is full.
+ */
+void trace_record(trace_event_t event, uint32_t start_us, uint32_t a, uint16_t b,
+                  uint16_t c, uint16_t d);
+
+// TRACE_BEGIN(t) declares the start time t; TRACE_END(t, ...) records.
+#define TRACE_BEGIN(t) uint32_t t = trace_now()
+#define TRACE_END(t, event, a, b, c, d) \
+    trace_record((event), (t), (uint32_t)(a), (uint16_t)(b), (uint16_t)(c), (uint16_t)(d))
+
+#else
+
+#define TRACE_BEGIN(t)
+#define TRACE_END(t, event, a, b, c, d) \
+    do { (void)(a); (void)(b); (void)(c); (void)(d); } while (0)
+
+#endif
+
+/**
+ * @brief Print the buffered events, oldest first, as Chrome trace JSON
+ *        on stdout and empty the buffer. Recording pauses meanwhile.
+ */
+void trace_dump(void);
+
+/**
+ * @brief Drop all buffered events.
+ */
+void trace_clear(void);
+
+#endif // TRACE_H
@@ -0,0 +1,123 @@
+#include "trace.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+#if CONFIG_TRACE_ENABLE
+
+typedef struct {
+    const char *name;
+    const char *category;
+    const char *args[4];  // names of a, b, c, d; NULL if unused
+} trace_event_info_t;
+
+static const trace_event_info_t event_info[TRACE_EVENT_COUNT] = {
+    [TRACE_ATCA_COMMAND]     = { "atca_command", "atca", { "opcode", "rx_bytes", "wait_ms", "polls" } },
+    [TRACE_I2C_SEND]         = { "i2c_send", "i2c", { "address", "bytes", "status", NULL } },
+    [TRACE_I2C_RECEIVE]      = { "i2c_receive", "i2c", { "address", "bytes", "status", NULL } },
+    [TRACE_DISPLAY_FLUSH]    = { "display_flush", "display", { "tiles", NULL, NULL, NULL } },
+    [TRACE_MNEMONIC_TO_SEED] = { "mnemonic_to_seed", "crypto", { "ok", NULL, NULL, NULL } },
+    [TRACE_HDNODE_CKD]       = { "hdnode_private_ckd", "crypto", { "index", "depth", "ok", NULL } },
+    [TRACE_ECDSA_SIGN]       = { "ecdsa_sign_digest", "crypto", { "result", NULL, NULL, NULL } },
+    [TRACE_ECDSA_VERIFY]     = { "ecdsa_verify_digest", "crypto", { "result", NULL, NULL, NULL } },
+};
+
+static trace_record_t records[CONFIG_TRACE_BUFFER_EVENTS];
+static uint32_t head;   // events recorded in total
+static uint32_t tail;   // oldest event still in the buffer
+static uint32_t lost;   // events overwritten since the last dump
+static bool paused;
+static portMUX_TYPE trace_mux = portMUX_INITIALIZER_UNLOCKED;
+
+uint32_t trace_now(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+void trace_record(trace_event_t event, uint32_t start_us, uint32_t a, uint16_t b,
+                  uint16_t c, uint16_t d)
+{
+    uint32_t end_us = trace_now();
+
+    portENTER_CRITICAL(&trace_mux);
+    if (!paused) {
+        trace_record_t *rec = &records[head % CONFIG_TRACE_BUFFER_EVENTS];
+        rec->start_us = start_us;
+        rec->dur_us = end_us - start_us;
+        rec->a = a;
+        rec->b = b;
+        rec->c = c;
+        rec->d = d;
+        rec->event = (uint8_t)event;
+        rec->core = (uint8_t)xPortGetCoreID();
+        head++;
+        if (head - tail > CONFIG_TRACE_BUFFER_EVENTS) {
+            tail++;
+            lost++;
+        }
+    }
+    portEXIT_CRITICAL(&trace_mux);
+}
+
+void trace_dump(void)
+{
+    uint32_t first, last, dropped;
+
+    portENTER_CRITICAL(&trace_mux);
+    paused = true;
+    first = tail;
+    last = head;
+    dropped = lost;
+    portEXIT_CRITICAL(&trace_mux);
+
+    printf("=== TRACE BEGIN (%lu events, %lu lost) ===\n", (unsigned long)(last - first),
+           (unsigned long)dropped);
+    printf("{\"traceEvents\":[\n");
+    printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"PRO_CPU\"}},\n");
+    printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"APP_CPU\"}}");
+    for (uint32_t i = first; i != last; i++) {
+        const trace_record_t *rec = &records[i % CONFIG_TRACE_BUFFER_EVENTS];
+        if (rec->event >= TRACE_EVENT_COUNT) {
+            continue;
+        }
+        const trace_event_info_t *info = &event_info[rec->event];
+        const uint32_t values[4] = { rec->a, rec->b, rec->c, rec->d };
+
+        printf(",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+               "\"ts\":%lu,\"dur\":%lu,\"args\":{",
+               info->name, info->category, (unsigned)rec->core,
+               (unsigned long)rec->start_us, (unsigned long)rec->dur_us);
+        for (int arg = 0; arg < 4 && info->args[arg] != NULL; arg++) {
+            printf("%s\"%s\":%lu", arg ? "," : "", info->args[arg], (unsigned long)values[arg]);
+        }
+        printf("}}");
+    }
+    printf("\n]}\n=== TRACE END ===\n");
+
+    portENTER_CRITICAL(&trace_mux);
+    tail = head;
+    lost = 0;
+    paused = false;
+    portEXIT_CRITICAL(&trace_mux);
+}
+
+void trace_clear(void)
+{
+    portENTER_CRITICAL(&trace_mux);
+    tail = head;
+    portEXIT_CRITICAL(&trace_mux);
+}
+
+#else
+
+void trace_dump(void)
+{
+    printf("trace disabled (CONFIG_TRACE_ENABLE)\n");
+}
+
+void trace_clear(void)
+{
+}
+
+#endif
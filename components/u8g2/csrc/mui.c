@@ -410,6 +410,226 @@ static uint8_t mui_prepare_current_field(mui_t *ui)
   return 0;
 }
 
+/* === compiled forms === */
+
+static uint8_t mui_uif_is_cursor_selectable(mui_t *ui) MUI_NOINLINE;
+static uint8_t mui_uif_is_cursor_selectable(mui_t *ui)
+{
+  if ( muif_get_cflags(ui->uif) & MUIF_CFLAG_IS_CURSOR_SELECTABLE )
+  {
+    return 1;
+  }
+  return 0;
+}
+
+/* link the last selectable field of the form back to the first one */
+static void mui_close_cform_sel(mui_cform_t *cform, mui_cfield_t *cfield_list)
+{
+  if ( cform != NULL && cform->first_sel != MUI_CFIELD_NONE )
+  {
+    cfield_list[cform->last_sel].next_sel = cform->first_sel;
+    cfield_list[cform->first_sel].prev_sel = cform->last_sel;
+  }
+}
+
+/*
+  mui_Compile() will parse the complete FDS once and store all fields, which have a field function, into
+  cfield_list. Each form gets one entry in cform_list. If the tables are present, then mui_Draw(), the cursor 
+  movement and the form switch procedures will use the tables instead of parsing the FDS again.
+  
+  Call this function after mui_Init() and before the first mui_GotoForm(). Both lists are provided by the
+  caller and must remain valid as long as ui is in use.
+  
+  Returns 0 if the lists are too small. In this case the FDS will be parsed on each access (as without mui_Compile()).
+*/
+
+uint8_t mui_Compile(mui_t *ui, mui_cform_t *cform_list, uint16_t cform_cap, mui_cfield_t *cfield_list, uint16_t cfield_cap)
+{
+  fds_t *fds = ui->root_fds;
+  mui_cform_t *cform = NULL;
+  mui_cfield_t *cfield;
+  uint16_t cform_cnt = 0;
+  uint16_t cfield_cnt = 0;
+  uint8_t cmd;
+  
+  ui->cform_list = NULL;
+  ui->cfield_list = NULL;
+  ui->cform_cnt = 0;
+  ui->current_cform = NULL;
+  ui->cursor_cfield = NULL;
+
+  for( ;; )
+  {
+    cmd = mui_get_fds_char(fds);
+    if ( cmd == 0 )
+      break;
+    if ( cmd == 'U' )
+    {
+      if ( cform_cnt >= cform_cap )
+        return 0;
+      mui_close_cform_sel(cform, cfield_list);
+      cform = cform_list + cform_cnt++;
+      cform->fds = fds;
+      cform->form_id = mui_get_fds_char(fds+1);
+      cform->first_field = cfield_cnt;
+      cform->field_cnt = 0;
+      cform->first_sel = MUI_CFIELD_NONE;
+      cform->last_sel = MUI_CFIELD_NONE;
+      cform->sel_cnt = 0;
+      fds += mui_fds_get_cmd_size(ui, fds);
+      continue;
+    }
+    
+    ui->fds = fds;
+    if ( mui_prepare_current_field(ui) && cform != NULL )    /* side effect: calculate ui->len */
+    {
+      if ( cfield_cnt >= cfield_cap )
+        return 0;
+      cfield = cfield_list + cfield_cnt++;
+      cfield->fds = fds;
+      cfield->uif = ui->uif;
+      cfield->len = ui->len;
+      cfield->cmd = cmd;
+      cfield->id0 = ui->id0;
+      cfield->id1 = ui->id1;
+      cfield->x = ui->x;
+      cfield->y = ui->y;
+      cfield->arg = ui->arg;
+      cfield->text_offset = mui_fds_get_cmd_size_without_text(fds);
+      cfield->text_len = strlen(ui->text);
+      cfield->flags = 0;
+      if ( mui_fds_is_text(cmd) )
+        cfield->flags |= MUI_CFIELD_HAS_TEXT;
+      if ( ui->cmd != 'D' && ui->cmd != 'Z' && ui->cmd != 'S' )
+        cfield->flags |= MUI_CFIELD_HAS_XY;
+      if ( mui_uif_is_cursor_selectable(ui) )
+      {
+        /* chain the selectable fields, so that the cursor does not need to visit the other fields */
+        cfield->flags |= MUI_CFIELD_IS_SELECTABLE;
+        cfield->sel_pos = cform->sel_cnt++;
+        cfield->prev_sel = cform->last_sel;
+        if ( cform->first_sel == MUI_CFIELD_NONE )
+          cform->first_sel = cfield_cnt-1;
+        else
+          cfield_list[cform->last_sel].next_sel = cfield_cnt-1;
+        cform->last_sel = cfield_cnt-1;
+      }
+      cform->field_cnt++;
+    }
+    fds += ui->len;
+  }
+  mui_close_cform_sel(cform, cfield_list);
+  
+  ui->fds = NULL;
+  ui->cform_list = cform_list;
+  ui->cfield_list = cfield_list;
+  ui->cform_cnt = cform_cnt;
+  return 1;
+}
+
+/* return the compiled form for the "U" command at fds or NULL */
+static const mui_cform_t *mui_find_cform(mui_t *ui, fds_t *fds)
+{
+  uint16_t i;
+  for( i = 0; i < ui->cform_cnt; i++ )
+    if ( ui->cform_list[i].fds == fds )
+      return ui->cform_list+i;
+  return NULL;
+}
+
+/*
+  same as mui_prepare_current_field(), but takes all values from the compiled field
+*/
+static void mui_load_cfield(mui_t *ui, const mui_cfield_t *cfield) MUI_NOINLINE;
+static void mui_load_cfield(mui_t *ui, const mui_cfield_t *cfield)
+{
+  fds_t *t;
+  uint8_t i;
+  
+  ui->fds = cfield->fds;
+  ui->len = cfield->len;
+  ui->uif = cfield->uif;
+  ui->cmd = cfield->cmd & 0xdf;
+  ui->id0 = cfield->id0;
+  ui->id1 = cfield->id1;
+  ui->arg = cfield->arg;
+  if ( cfield->flags & MUI_CFIELD_HAS_XY )
+  {
+    ui->x = cfield->x;
+    ui->y = cfield->y;
+  }
+  
+  ui->dflags = 0;    
+  if ( ui->fds == ui->cursor_focus_fds )
+    ui->dflags |= MUIF_DFLAG_IS_CURSOR_FOCUS;
+  if ( ui->fds == ui->touch_focus_fds )
+    ui->dflags |= MUIF_DFLAG_IS_TOUCH_FOCUS;
+  
+  /* the text length is known, so the delimiter search is not required */
+  i = 0;
+  if ( cfield->flags & MUI_CFIELD_HAS_TEXT )
+  {
+    t = cfield->fds + cfield->text_offset;
+    ui->delimiter = mui_get_fds_char(t);
+    t++;
+    for( ; i < cfield->text_len; i++ )
+      ui->text[i] = mui_get_fds_char(t+i);
+  }
+  ui->text[i] = '\0';
+}
+
+/* 
+  return the compiled field for cursor_focus_fds within the current form or NULL 
+  cursor_cfield remembers the last result, so the form is only searched after the focus
+  was moved by the FDS based procedures (for example the initial focus of mui_EnterForm())
+*/
+static const mui_cfield_t *mui_get_cursor_cfield(mui_t *ui)
+{
+  const mui_cfield_t *cfield;
+  uint16_t n;
+  
+  if ( ui->cursor_focus_fds == NULL )
+    return NULL;
+  if ( ui->cursor_cfield != NULL && ui->cursor_cfield->fds == ui->cursor_focus_fds )
+    return ui->cursor_cfield;
+  cfield = ui->cfield_list + ui->current_cform->first_field;
+  for( n = ui->current_cform->field_cnt; n > 0; n--, cfield++ )
+  {
+    if ( cfield->fds == ui->cursor_focus_fds )
+    {
+      ui->cursor_cfield = cfield;
+      return cfield;
+    }
+  }
+  return NULL;
+}
+
+/* return the compiled field with the cursor focus, if it is selectable, or NULL */
+static const mui_cfield_t *mui_find_cursor_cfield(mui_t *ui)
+{
+  const mui_cfield_t *cfield = mui_get_cursor_cfield(ui);
+  if ( cfield == NULL || (cfield->flags & MUI_CFIELD_IS_SELECTABLE) == 0 )
+    return NULL;
+  return cfield;
+}
+
+/*
+  same as mui_inner_loop_over_form(), but for the compiled current form
+*/
+static void mui_inner_loop_over_cform(mui_t *ui, uint8_t (*task)(mui_t *ui)) MUI_NOINLINE;
+static void mui_inner_loop_over_cform(mui_t *ui, uint8_t (*task)(mui_t *ui))
+{
+  const mui_cfield_t *cfield = ui->cfield_list + ui->current_cform->first_field;
+  uint16_t n = ui->current_cform->field_cnt;
+  
+  for( ; n > 0; n--, cfield++ )
+  {
+    mui_load_cfield(ui, cfield);
+    if ( task(ui) )         /* call the task, which was provided as argument to this function */
+      break;
+  }
+}
+
 /* 
   assumes that ui->fds has been assigned correctly 
   and that ui->target_fds and ui->tmp_fds had been cleared if required
@@ -455,7 +675,10 @@ static void mui_loop_over_form(mui_t *ui, uint8_t (*task)(mui_t *ui))
   ui->target_fds = NULL;
   ui->tmp_fds = NULL;
   
-  mui_inner_loop_over_form(ui, task);  
+  if ( ui->current_cform != NULL )
+    mui_inner_loop_over_cform(ui, task);
+  else
+    mui_inner_loop_over_form(ui, task);  
 }
 
 /*
@@ -465,6 +688,15 @@ static fds_t *mui_find_form(mui_t *ui, uint8_t n)
 {
   fds_t *fds = ui->root_fds;
   uint8_t cmd;
+  uint16_t i;
+  
+  if ( ui->cform_list != NULL )
+  {
+    for( i = 0; i < ui->cform_cnt; i++ )
+      if ( ui->cform_list[i].form_id == n )
+        return ui->cform_list[i].fds;
+    return NULL;
+  }
   
   for( ;; )
   {
@@ -507,16 +739,6 @@ static uint8_t mui_task_form_end(mui_t *ui)
   return 0;     /* continue with the loop */
 }
 
-static uint8_t mui_uif_is_cursor_selectable(mui_t *ui) MUI_NOINLINE;
-static uint8_t mui_uif_is_cursor_selectable(mui_t *ui)
-{
-  if ( muif_get_cflags(ui->uif) & MUIF_CFLAG_IS_CURSOR_SELECTABLE )
-  {
-    return 1;
-  }
-  return 0;
-}
-
 static uint8_t mui_task_find_prev_cursor_uif(mui_t *ui)
 {
   //if ( muif_get_cflags(ui->uif) & MUIF_CFLAG_IS_CURSOR_SELECTABLE )
@@ -588,18 +810,6 @@ static uint8_t mui_task_get_current_cursor_focus_position(mui_t *ui)
   return 0;     /* continue with the loop */
 }
 
-static uint8_t mui_task_read_nth_selectable_field(mui_t *ui)
-{
-  //if ( muif_get_cflags(ui->uif) & MUIF_CFLAG_IS_CURSOR_SELECTABLE )
-  if ( mui_uif_is_cursor_selectable(ui) )
-  {
-    if ( ui->tmp8 == 0 )
-      return 1;         /* stop looping */
-    ui->tmp8--;
-  }
-  return 0;     /* continue with the loop */
-}
-
 static uint8_t mui_task_find_execute_on_select_field(mui_t *ui)
 {
   if ( muif_get_cflags(ui->uif) & MUIF_CFLAG_IS_EXECUTE_ON_SELECT )
@@ -616,8 +826,20 @@ static uint8_t mui_task_find_execute_on_select_field(mui_t *ui)
 static uint8_t mui_send_cursor_msg(mui_t *ui, uint8_t msg) MUI_NOINLINE;
 static uint8_t mui_send_cursor_msg(mui_t *ui, uint8_t msg)
 {
+  const mui_cfield_t *cfield;
+  
   if ( ui->cursor_focus_fds )
   {
+    if ( ui->current_cform != NULL )
+    {
+      cfield = mui_get_cursor_cfield(ui);
+      if ( cfield != NULL )
+      {
+        mui_load_cfield(ui, cfield);
+        return muif_get_cb(ui->uif)(ui, msg);
+      }
+      return 0;
+    }
     ui->fds = ui->cursor_focus_fds;
     if ( mui_prepare_current_field(ui) )
       return muif_get_cb(ui->uif)(ui, msg);
@@ -639,7 +861,15 @@ static uint8_t mui_send_cursor_msg(mui_t *ui, uint8_t msg)
 */
 uint8_t mui_GetCurrentCursorFocusPosition(mui_t *ui)
 {
+  const mui_cfield_t *cfield;
   //fds_t *fds = ui->fds;
+  if ( mui_IsFormActive(ui) && ui->current_cform != NULL )
+  {
+    cfield = mui_find_cursor_cfield(ui);
+    if ( cfield == NULL )
+      return ui->current_cform->sel_cnt;
+    return cfield->sel_pos;
+  }
   ui->tmp8 = 0;  
   mui_loop_over_form(ui, mui_task_get_current_cursor_focus_position);
   //ui->fds = fds;
@@ -652,8 +882,38 @@ void mui_Draw(mui_t *ui)
   mui_loop_over_form(ui, mui_task_draw);
 }
 
+/* same as mui_next_field() / mui_prev_field(), but follows the selectable field chain of the compiled form */
+static void mui_step_cfield(mui_t *ui, uint8_t is_next)
+{
+  const mui_cform_t *cform = ui->current_cform;
+  const mui_cfield_t *cfield = mui_find_cursor_cfield(ui);
+  uint16_t idx;
+  
+  if ( cfield != NULL )
+  {
+    /* the chain wraps around, which is the same as continuing with the first/last field */
+    idx = is_next ? cfield->next_sel : cfield->prev_sel;
+  }
+  else
+  {
+    idx = is_next ? cform->first_sel : cform->last_sel;
+  }
+  if ( idx == MUI_CFIELD_NONE )
+  {
+    ui->cursor_focus_fds = NULL;
+    return;
+  }
+  ui->cursor_cfield = ui->cfield_list + idx;
+  ui->cursor_focus_fds = ui->cursor_cfield->fds;
+}
+
 static void mui_next_field(mui_t *ui)
 {
+  if ( mui_IsFormActive(ui) && ui->current_cform != NULL )
+  {
+    mui_step_cfield(ui, 1);
+    return;
+  }
   mui_loop_over_form(ui, mui_task_find_next_cursor_uif);
   // ui->cursor_focus_position++;
   ui->cursor_focus_fds = ui->target_fds;      // NULL is ok  
@@ -749,6 +1009,7 @@ void mui_EnterForm(mui_t *ui, fds_t *fds, uint8_t initial_cursor_position)
   
   /* assign the form, which should be entered */
   ui->current_form_fds = fds;
+  ui->current_cform = mui_find_cform(ui, fds);
   
   /* inform all fields that we start a new form */
   MUI_DEBUG("mui_EnterForm: form_start, initial_cursor_position=%d\n", initial_cursor_position);
@@ -788,6 +1049,7 @@ void mui_LeaveForm(mui_t *ui)
   MUI_DEBUG("mui_LeaveForm: form_end\n");
   mui_loop_over_form(ui, mui_task_form_end);  
   ui->current_form_fds = NULL;
+  ui->current_cform = NULL;
 }
 
 /* 0: error, form not found */
@@ -949,6 +1211,11 @@ void mui_PrevField(mui_t *ui)
       return;
     mui_send_cursor_msg(ui, MUIF_MSG_CURSOR_LEAVE);
  
+    if ( mui_IsFormActive(ui) && ui->current_cform != NULL )
+    {
+      mui_step_cfield(ui, 0);
+      continue;         /* to the loop condition */
+    }
     mui_loop_over_form(ui, mui_task_find_prev_cursor_uif);
     ui->cursor_focus_fds = ui->target_fds;      // NULL is ok  
     if ( ui->target_fds == NULL )
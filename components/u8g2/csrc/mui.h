@@ -218,6 +218,47 @@ struct muif_struct
 
 
 
+/* compiled forms, see mui_Compile() */
+typedef struct mui_cfield_struct mui_cfield_t;
+typedef struct mui_cform_struct mui_cform_t;
+
+#define MUI_CFIELD_HAS_TEXT 0x01
+#define MUI_CFIELD_HAS_XY 0x02
+#define MUI_CFIELD_IS_SELECTABLE 0x04
+
+/* no selectable field, value of mui_cform_t first_sel/last_sel */
+#define MUI_CFIELD_NONE 0xffff
+
+struct mui_cfield_struct
+{
+  fds_t *fds;                   // start of the field command within the FDS
+  muif_t *uif;                  // field function for id0/id1
+  uint16_t len;                 // length of the command, including the text part
+  uint8_t cmd;                  // cmd as found in the FDS (upper or lower case)
+  uint8_t id0;
+  uint8_t id1;
+  uint8_t x;
+  uint8_t y;
+  uint8_t arg;
+  uint8_t text_offset;          // position of the text delimiter within the command
+  uint8_t text_len;             // number of chars copied into ui->text
+  uint8_t flags;                // MUI_CFIELD_HAS_TEXT, MUI_CFIELD_HAS_XY, MUI_CFIELD_IS_SELECTABLE
+  uint8_t sel_pos;              // position among the selectable fields of the form (selectable fields only)
+  uint16_t next_sel;            // field table index of the next/previous selectable field of the form,
+  uint16_t prev_sel;            // wraps around (selectable fields only)
+};
+
+struct mui_cform_struct
+{
+  fds_t *fds;                   // the "U" command of the form
+  uint16_t first_field;         // index of the first field in the field table
+  uint16_t field_cnt;           // number of fields with a field function
+  uint16_t first_sel;           // field table index of the first/last selectable field or MUI_CFIELD_NONE
+  uint16_t last_sel;
+  uint8_t sel_cnt;              // number of selectable fields
+  uint8_t form_id;
+};
+
 /* must be smaller than or equal to 255 */
 #ifndef MUI_MAX_TEXT_LEN
 #define MUI_MAX_TEXT_LEN 41
@@ -282,6 +323,13 @@ struct mui_struct
   uint8_t menu_form_last_added;
   uint8_t menu_form_id[MUI_MENU_CACHE_CNT];
   uint8_t menu_form_cursor_focus_position[MUI_MENU_CACHE_CNT];
+  
+  /* compiled forms, assigned by mui_Compile(), NULL if the FDS is parsed on each access */
+  const mui_cform_t *cform_list;
+  const mui_cfield_t *cfield_list;
+  uint16_t cform_cnt;
+  const mui_cform_t *current_cform;     // compiled current_form_fds, NULL if not available
+  const mui_cfield_t *cursor_cfield;    // compiled field of cursor_focus_fds, only valid if its fds matches cursor_focus_fds
 } ;
 
 #define mui_IsCursorFocus(mui) ((mui)->dflags & MUIF_DFLAG_IS_CURSOR_FOCUS)
@@ -578,6 +626,7 @@ uint8_t mui_fds_get_nth_token(mui_t *ui, uint8_t n) MUI_NOINLINE;
 uint8_t mui_fds_get_token_cnt(mui_t *ui) MUI_NOINLINE;
 
 void mui_Init(mui_t *ui, void *graphics_data, fds_t *fds, muif_t *muif_tlist, size_t muif_tcnt);
+uint8_t mui_Compile(mui_t *ui, mui_cform_t *cform_list, uint16_t cform_cap, mui_cfield_t *cfield_list, uint16_t cfield_cap);
 uint8_t mui_GetCurrentCursorFocusPosition(mui_t *ui) ;
 void mui_Draw(mui_t *ui);
 /* warning: The next function will overwrite the ui field variables like ui->arg, etc. 26 sep 2021: only ui->text is modified */
@@ -175,6 +175,27 @@
 #define U8G2_BALANCED_STR_WIDTH_CALCULATION
 #endif
 
+/*
+  Glyph cache: U8G2_GLYPH_CACHE_SIZE bytes of static RAM hold recently drawn
+  glyphs (font + encoding) already decoded into the vertical top lsb page
+  layout of SSD13xx type displays. Cached glyphs are copied into the tile buffer 
+  with byte operations instead of decoding the RLE data into single lines again.
+  Only used for unrotated displays with u8g2_ll_hvline_vertical_top_lsb and
+  font direction 0; glyphs larger than U8G2_GLYPH_CACHE_SLOT_SIZE bytes 
+  (width * pages) are not cached. Least recently used glyphs are replaced.
+  
+  Default is 0 (no cache). Hit/miss counters: u8g2_GetGlyphCacheStats()
+*/
+#ifndef U8G2_GLYPH_CACHE_SIZE
+#define U8G2_GLYPH_CACHE_SIZE 0
+#endif
+#ifndef U8G2_GLYPH_CACHE_SLOT_SIZE
+#define U8G2_GLYPH_CACHE_SLOT_SIZE 32
+#endif
+#if U8G2_GLYPH_CACHE_SIZE > 0
+#define U8G2_WITH_GLYPH_CACHE
+#endif
+
 
 /*==========================================*/
 
@@ -1793,10 +1814,18 @@ void u8g2_ll_hvline_vertical_top_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y,
 /* ST7920 */
 void u8g2_ll_hvline_horizontal_right_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir);
 
+#ifdef U8G2_WITH_HVLINE_SPEED_OPTIMIZATION
+/* filled box for the u8g2_ll_hvline_vertical_top_lsb buffer layout, w and h must not be 0, all clipping done */
+void u8g2_ll_box_vertical_top_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h);
+#endif /* U8G2_WITH_HVLINE_SPEED_OPTIMIZATION */
+
 
 /*==========================================*/
 /* u8g2_hvline.c */
 
+/* clips a to a+len against c..d, returns 0 if nothing is left; internal, also used by u8g2_box.c */
+uint8_t u8g2_clip_intersection2(u8g2_uint_t *ap, u8g2_uint_t *len, u8g2_uint_t c, u8g2_uint_t d);
+
 /* u8g2_DrawHVLine does not use u8g2_IsIntersection */
 void u8g2_DrawHVLine(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir);
 
@@ -1920,6 +1949,11 @@ void u8g2_SetFontMode(u8g2_t *u8g2, uint8_t is_transparent);
 uint8_t u8g2_IsGlyph(u8g2_t *u8g2, uint16_t requested_encoding);
 int8_t u8g2_GetGlyphWidth(u8g2_t *u8g2, uint16_t requested_encoding);
 
+#ifdef U8G2_WITH_GLYPH_CACHE
+void u8g2_GetGlyphCacheStats(uint32_t *hits, uint32_t *misses);
+void u8g2_ClearGlyphCache(void);
+#endif /* U8G2_WITH_GLYPH_CACHE */
+
 u8g2_uint_t u8g2_DrawGlyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding);
 u8g2_uint_t u8g2_DrawGlyphX2(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding);
 int8_t u8g2_GetStrX(u8g2_t *u8g2, const char *s);	/* for u8g compatibility, WARNING: use u8g2_GetGlyphXOffset() instead! */
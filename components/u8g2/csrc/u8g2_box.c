@@ -45,6 +45,29 @@ void u8g2_DrawBox(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g
   if ( u8g2_IsIntersection(u8g2, x, y, x+w, y+h) == 0 ) 
     return;
 #endif /* U8G2_WITH_INTERSECTION */
+#ifdef U8G2_WITH_HVLINE_SPEED_OPTIMIZATION
+  /* 
+    unrotated SSD13xx style buffer: clip once and fill whole pages instead
+    of drawing h lines; this is what u8g2_DrawHVLine() would do per line
+  */
+  if ( u8g2->ll_hvline == u8g2_ll_hvline_vertical_top_lsb && u8g2->cb->draw_l90 == u8g2_draw_l90_r0 )
+  {
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+    if ( u8g2->is_page_clip_window_intersection == 0 )
+      return;
+#endif /* U8G2_WITH_CLIP_WINDOW_SUPPORT */
+    if ( w == 0 || h == 0 )
+      return;
+    if ( u8g2_clip_intersection2(&x, &w, u8g2->user_x0, u8g2->user_x1) == 0 )
+      return;
+    if ( u8g2_clip_intersection2(&y, &h, u8g2->user_y0, u8g2->user_y1) == 0 )
+      return;
+    if ( w == 0 || h == 0 )
+      return;
+    u8g2_ll_box_vertical_top_lsb(u8g2, x, y - u8g2->pixel_curr_row, w, h);
+    return;
+  }
+#endif /* U8G2_WITH_HVLINE_SPEED_OPTIMIZATION */
   while( h != 0 )
   { 
     u8g2_DrawHVLine(u8g2, x, y, w, 0);
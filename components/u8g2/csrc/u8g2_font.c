@@ -34,6 +34,7 @@
 */
 
 #include "u8g2.h"
+#include <string.h>
 
 /* size of the font data structure, there is no struct or class... */
 /* this is the size for the new font format */
@@ -866,6 +867,301 @@ const uint8_t *u8g2_font_get_glyph_data(u8g2_t *u8g2, uint16_t encoding)
   return NULL;
 }
 
+#ifdef U8G2_WITH_GLYPH_CACHE
+
+/*========================================================================*/
+/* glyph cache */
+
+typedef struct _u8g2_glyph_cache_entry_t
+{
+  const uint8_t *font;		/* NULL: unused entry */
+  uint32_t last_use;
+  uint16_t encoding;
+  int8_t x;			/* glyph header values, see u8g2_font_decode_glyph() */
+  int8_t y;
+  int8_t d;
+  uint8_t w;
+  uint8_t h;
+  uint8_t bits[U8G2_GLYPH_CACHE_SLOT_SIZE];	/* page p, column c: bits[p*w+c], lsb on top */
+} u8g2_glyph_cache_entry_t;
+
+#define U8G2_GLYPH_CACHE_CNT (U8G2_GLYPH_CACHE_SIZE/sizeof(u8g2_glyph_cache_entry_t))
+
+static u8g2_glyph_cache_entry_t u8g2_glyph_cache[U8G2_GLYPH_CACHE_CNT > 0 ? U8G2_GLYPH_CACHE_CNT : 1];
+static uint32_t u8g2_glyph_cache_clock;
+static uint32_t u8g2_glyph_cache_hits;
+static uint32_t u8g2_glyph_cache_misses;
+
+void u8g2_GetGlyphCacheStats(uint32_t *hits, uint32_t *misses)
+{
+  *hits = u8g2_glyph_cache_hits;
+  *misses = u8g2_glyph_cache_misses;
+}
+
+void u8g2_ClearGlyphCache(void)
+{
+  memset(u8g2_glyph_cache, 0, sizeof(u8g2_glyph_cache));
+  u8g2_glyph_cache_clock = 0;
+  u8g2_glyph_cache_hits = 0;
+  u8g2_glyph_cache_misses = 0;
+}
+
+/* the cache stores the buffer layout of u8g2_ll_hvline_vertical_top_lsb, without rotation */
+static uint8_t u8g2_glyph_cache_is_usable(u8g2_t *u8g2)
+{
+  if ( u8g2->ll_hvline != u8g2_ll_hvline_vertical_top_lsb )
+    return 0;
+  if ( u8g2->cb->draw_l90 != u8g2_draw_l90_r0 )
+    return 0;
+#ifdef U8G2_WITH_FONT_ROTATION
+  if ( u8g2->font_decode.dir != 0 )
+    return 0;
+#endif
+  return 1;
+}
+
+/* advance the local position by len pixel, like u8g2_font_decode_len(), but set bits in the cache entry */
+static void u8g2_glyph_cache_decode_len(u8g2_glyph_cache_entry_t *e, u8g2_font_decode_t *decode, uint8_t len, uint8_t is_foreground)
+{
+  uint8_t cnt = len;
+  uint8_t rem;
+  uint8_t current;
+  uint8_t lx = decode->x;
+  uint8_t ly = decode->y;
+  
+  for(;;)
+  {
+    rem = e->w;
+    rem -= lx;
+    current = rem;
+    if ( cnt < rem )
+      current = cnt;
+    if ( is_foreground && ly < e->h )
+    {
+      uint8_t *ptr = e->bits + (ly >> 3) * e->w + lx;
+      uint8_t mask = 1 << (ly & 7);
+      while( current > 0 )
+      {
+	*ptr++ |= mask;
+	current--;
+      }
+    }
+    if ( cnt < rem )
+      break;
+    cnt -= rem;
+    lx = 0;
+    ly++;
+  }
+  lx += cnt;
+  decode->x = lx;
+  decode->y = ly;
+}
+
+/* decode a glyph into the least recently used entry, returns NULL if the glyph is too large */
+static u8g2_glyph_cache_entry_t *u8g2_glyph_cache_add(u8g2_t *u8g2, uint16_t encoding, const uint8_t *glyph_data)
+{
+  u8g2_font_decode_t *decode = &(u8g2->font_decode);
+  u8g2_glyph_cache_entry_t *e;
+  uint8_t a, b;
+  uint16_t i;
+  
+  u8g2_font_setup_decode(u8g2, glyph_data);
+  if ( (uint16_t)((decode->glyph_height + 7) >> 3) * (uint8_t)decode->glyph_width > U8G2_GLYPH_CACHE_SLOT_SIZE )
+    return NULL;
+  
+  e = u8g2_glyph_cache;
+  for( i = 1; i < U8G2_GLYPH_CACHE_CNT; i++ )
+    if ( u8g2_glyph_cache[i].last_use < e->last_use )
+      e = u8g2_glyph_cache+i;
+  
+  e->font = u8g2->font;
+  e->encoding = encoding;
+  e->w = decode->glyph_width;
+  e->h = decode->glyph_height;
+  e->x = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_x);
+  e->y = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_y);
+  e->d = u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_delta_x);
+  memset(e->bits, 0, sizeof(e->bits));
+  
+  if ( e->w > 0 )
+  {
+    decode->x = 0;
+    decode->y = 0;
+    for(;;)
+    {
+      a = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_0);
+      b = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_1);
+      do
+      {
+	u8g2_glyph_cache_decode_len(e, decode, a, 0);
+	u8g2_glyph_cache_decode_len(e, decode, b, 1);
+      } while( u8g2_font_decode_get_unsigned_bits(decode, 1) != 0 );
+
+      if ( decode->y >= e->h )
+	break;
+    }
+  }
+  return e;
+}
+
+static void u8g2_glyph_cache_apply(uint8_t *ptr, uint8_t mask, uint8_t color)
+{
+  if ( color == 1 )
+    *ptr |= mask;
+  else if ( color == 0 )
+    *ptr &= ~mask;
+  else
+    *ptr ^= mask;
+}
+
+/*
+  Copy a cached glyph into the tile buffer, same result as u8g2_font_decode_glyph().
+  Returns 0 if the glyph is not completely inside the display: this is left to 
+  the line based procedure, which handles coordinate wrap around.
+*/
+static uint8_t u8g2_glyph_cache_draw(u8g2_t *u8g2, const u8g2_glyph_cache_entry_t *e)
+{
+  u8g2_font_decode_t *decode = &(u8g2->font_decode);
+  u8g2_uint_t gx, gy;
+  int x0, x1, y0, y1;
+  int ty, dp, r0, r1;
+  int p, c;
+  uint8_t s, pages, keep, fg, bg;
+  uint8_t fg_color, bg_color, is_solid;
+  uint16_t stride;
+  uint8_t *buf;
+  
+  if ( e->w == 0 )
+    return 1;
+  
+  gx = decode->target_x;
+  gx += e->x;
+  gy = decode->target_y;
+  gy -= e->h + e->y;
+  if ( gx >= u8g2->width || e->w > u8g2->width - gx )
+    return 0;
+  if ( gy >= u8g2->height || e->h > u8g2->height - gy )
+    return 0;
+  
+#ifdef U8G2_WITH_CLIP_WINDOW_SUPPORT
+  if ( u8g2->is_page_clip_window_intersection == 0 )
+    return 1;
+#endif /* U8G2_WITH_CLIP_WINDOW_SUPPORT */
+  
+  /* clip against the user window, which is also the current page */
+  x0 = gx;
+  x1 = x0 + e->w;
+  if ( x0 < u8g2->user_x0 )
+    x0 = u8g2->user_x0;
+  if ( x1 > u8g2->user_x1 )
+    x1 = u8g2->user_x1;
+  y0 = gy;
+  y1 = y0 + e->h;
+  if ( y0 < u8g2->user_y0 )
+    y0 = u8g2->user_y0;
+  if ( y1 > u8g2->user_y1 )
+    y1 = u8g2->user_y1;
+  if ( x0 >= x1 || y0 >= y1 )
+    return 1;
+  
+  /* glyph row 0 goes to buffer row ty, which is -7 or lower for a glyph starting above the page */
+  ty = (int)gy - (int)u8g2->pixel_curr_row;
+  s = ty & 7;
+  dp = (ty - s) / 8;
+  r0 = y0 - gy;
+  r1 = y1 - gy;
+  x0 -= gx;
+  x1 -= gx;
+  
+  fg_color = u8g2->draw_color;
+  bg_color = (fg_color == 0 ? 1 : 0);
+  is_solid = (decode->is_transparent == 0);
+  stride = u8g2_GetU8x8(u8g2)->display_info->tile_width*8;
+  pages = (e->h + 7) >> 3;
+  
+  for( p = 0; p < pages; p++, dp++ )
+  {
+    int lo = r0 - p*8;
+    int hi = r1 - p*8;
+    if ( lo < 0 )
+      lo = 0;
+    if ( hi > 8 )
+      hi = 8;
+    if ( lo >= hi )
+      continue;
+    keep = (uint8_t)(((1U << hi) - 1) & ~((1U << lo) - 1));
+    
+    /* lower part: page dp, upper part: page dp+1 */
+    if ( dp >= 0 && dp < u8g2->tile_buf_height )
+    {
+      buf = u8g2->tile_buf_ptr + dp*stride + gx;
+      for( c = x0; c < x1; c++ )
+      {
+	fg = e->bits[p*e->w+c] & keep;
+	u8g2_glyph_cache_apply(buf+c, (uint8_t)(fg << s), fg_color);
+	if ( is_solid )
+	{
+	  bg = keep & ~fg;
+	  u8g2_glyph_cache_apply(buf+c, (uint8_t)(bg << s), bg_color);
+	}
+      }
+    }
+    if ( s != 0 && dp+1 >= 0 && dp+1 < u8g2->tile_buf_height )
+    {
+      buf = u8g2->tile_buf_ptr + (dp+1)*stride + gx;
+      for( c = x0; c < x1; c++ )
+      {
+	fg = e->bits[p*e->w+c] & keep;
+	u8g2_glyph_cache_apply(buf+c, (uint8_t)(fg >> (8-s)), fg_color);
+	if ( is_solid )
+	{
+	  bg = keep & ~fg;
+	  u8g2_glyph_cache_apply(buf+c, (uint8_t)(bg >> (8-s)), bg_color);
+	}
+      }
+    }
+  }
+  return 1;
+}
+
+/* returns 1 and the advance in *dx if the glyph has been drawn from the cache */
+static uint8_t u8g2_glyph_cache_draw_glyph(u8g2_t *u8g2, uint16_t encoding, u8g2_uint_t *dx)
+{
+  u8g2_glyph_cache_entry_t *e = NULL;
+  uint16_t i;
+  
+  if ( u8g2_glyph_cache_is_usable(u8g2) == 0 )
+    return 0;
+  
+  for( i = 0; i < U8G2_GLYPH_CACHE_CNT; i++ )
+  {
+    if ( u8g2_glyph_cache[i].font == u8g2->font && u8g2_glyph_cache[i].encoding == encoding )
+    {
+      e = u8g2_glyph_cache+i;
+      u8g2_glyph_cache_hits++;
+      break;
+    }
+  }
+  if ( e == NULL )
+  {
+    const uint8_t *glyph_data = u8g2_font_get_glyph_data(u8g2, encoding);
+    if ( glyph_data == NULL )
+      return 0;
+    e = u8g2_glyph_cache_add(u8g2, encoding, glyph_data);
+    if ( e == NULL )
+      return 0;
+    u8g2_glyph_cache_misses++;
+  }
+  e->last_use = ++u8g2_glyph_cache_clock;
+  
+  if ( u8g2_glyph_cache_draw(u8g2, e) == 0 )
+    return 0;
+  *dx = e->d;
+  return 1;
+}
+
+#endif /* U8G2_WITH_GLYPH_CACHE */
+
 static u8g2_uint_t u8g2_font_draw_glyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint16_t encoding)
 {
   u8g2_uint_t dx = 0;
@@ -873,6 +1169,10 @@ static u8g2_uint_t u8g2_font_draw_glyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t
   u8g2->font_decode.target_y = y;
   //u8g2->font_decode.is_transparent = is_transparent; this is already set
   //u8g2->font_decode.dir = dir;
+#ifdef U8G2_WITH_GLYPH_CACHE
+  if ( u8g2_glyph_cache_draw_glyph(u8g2, encoding, &dx) != 0 )
+    return dx;
+#endif /* U8G2_WITH_GLYPH_CACHE */
   const uint8_t *glyph_data = u8g2_font_get_glyph_data(u8g2, encoding);
   if ( glyph_data != NULL )
   {
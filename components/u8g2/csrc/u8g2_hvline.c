@@ -58,7 +58,8 @@
 
 */
 
-static uint8_t u8g2_clip_intersection2(u8g2_uint_t *ap, u8g2_uint_t *len, u8g2_uint_t c, u8g2_uint_t d)
+/* not static: also used by the u8g2_DrawBox() fast path in u8g2_box.c */
+uint8_t u8g2_clip_intersection2(u8g2_uint_t *ap, u8g2_uint_t *len, u8g2_uint_t c, u8g2_uint_t d)
 {
   u8g2_uint_t a = *ap;
   u8g2_uint_t b;
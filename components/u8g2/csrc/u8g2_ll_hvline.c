@@ -50,6 +50,7 @@
 
 #include "u8g2.h"
 #include <assert.h>
+#include <string.h>
 
 /*=================================================*/
 /*
@@ -151,6 +152,78 @@ void u8g2_ll_hvline_vertical_top_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y,
   }
 }
 
+/*
+  x,y		Upper left position of the box within the local buffer (not the display!)
+  w,h		size of the box in pixel, both must not be 0
+  asumption: 
+    all clipping done
+  
+  Instead of h horizontal lines with a single bit mask, each page (8 pixel
+  rows) is visited once: the first and the last page get a partial mask,
+  pages in between are written with full byte stores.
+*/
+void u8g2_ll_box_vertical_top_lsb(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h)
+{
+  uint16_t offset;
+  uint8_t *ptr;
+  uint8_t mask;
+  u8g2_uint_t y_last;
+  u8g2_uint_t page, page_last;
+  u8g2_uint_t cnt;
+
+  y_last = y;
+  y_last += h;
+  y_last--;
+  page = y >> 3;
+  page_last = y_last >> 3;
+  
+  offset = y;
+  offset &= ~7;
+  offset *= u8g2_GetU8x8(u8g2)->display_info->tile_width;
+  ptr = u8g2->tile_buf_ptr;
+  ptr += offset;
+  ptr += x;
+
+  for(;;)
+  {
+    mask = 0x0ff;
+    if ( page == (y >> 3) )
+      mask &= (uint8_t)(0x0ff << (y & 7));
+    if ( page == page_last )
+      mask &= (uint8_t)(0x0ff >> (7 - (y_last & 7)));
+
+    if ( u8g2->draw_color == 1 )
+    {
+      if ( mask == 0x0ff )
+	memset(ptr, 0x0ff, w);
+      else
+	for( cnt = 0; cnt < w; cnt++ )
+	  ptr[cnt] |= mask;
+    }
+    else if ( u8g2->draw_color == 0 )
+    {
+      if ( mask == 0x0ff )
+	memset(ptr, 0, w);
+      else
+      {
+	mask = ~mask;
+	for( cnt = 0; cnt < w; cnt++ )
+	  ptr[cnt] &= mask;
+      }
+    }
+    else
+    {
+      for( cnt = 0; cnt < w; cnt++ )
+	ptr[cnt] ^= mask;
+    }
+    
+    if ( page == page_last )
+      break;
+    page++;
+    ptr += u8g2->pixel_buf_width;
+  }
+}
+
 
 
 #else /* U8G2_WITH_HVLINE_SPEED_OPTIMIZATION */
@@ -0,0 +1,161 @@
+/*
+  mui_compile_speed
+
+  Compares mui_Draw(), mui_NextField(), mui_PrevField() and mui_GotoForm() with and without
+  the compiled form tables of mui_Compile().
+  Rendering goes into the u8g2 buffer only, nothing is sent to a display.
+*/
+
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "mui.h"
+#include "mui_u8g2.h"
+
+/* csrc does not contain the font collection, take the single font file */
+#include "../../../tools/font/build/single_font_files/u8g2_font_helvR08_tr.c"
+
+#define LOOPS 20000
+
+u8g2_t u8g2;
+mui_t ui;
+
+uint8_t account = 0;
+uint8_t brightness = 5;
+uint8_t auto_lock = 1;
+
+uint8_t mui_style_helv_r_08(mui_t *ui, uint8_t msg)
+{
+  u8g2_t *u8g2 = mui_get_U8g2(ui);
+  switch(msg)
+  {
+    case MUIF_MSG_DRAW:
+      u8g2_SetFont(u8g2, u8g2_font_helvR08_tr);
+      break;
+  }
+  return 0;
+}
+
+muif_t muif_list[] MUI_PROGMEM = {
+  MUIF_STYLE(0, mui_style_helv_r_08),
+  MUIF_RO("HR", mui_u8g2_draw_text),
+  MUIF_U8G2_U8_MIN_MAX("BR", &brightness, 0, 9, mui_u8g2_u8_min_max_wm_mse_pi),
+  MUIF_VARIABLE("AL", &auto_lock, mui_u8g2_u8_chkbox_wm_pi),
+  MUIF_VARIABLE("AC", &account, mui_u8g2_u8_opt_line_wa_mse_pi),
+  MUIF_GOTO(mui_u8g2_btn_goto_wm_fi),
+  MUIF_LABEL(mui_u8g2_draw_text)
+};
+
+fds_t fds_data[] = 
+
+MUI_FORM(1)
+MUI_STYLE(0)
+MUI_LABEL(0, 8, "Settings")
+MUI_GOTO(0, 20, 2, "Accounts")
+MUI_GOTO(0, 30, 3, "Display")
+MUI_GOTO(40, 20, 3, "Security")
+MUI_GOTO(40, 30, 3, "Network")
+MUI_GOTO(80, 20, 3, "Backup")
+MUI_GOTO(80, 30, 3, "Reset")
+MUI_LABEL(0, 42, "Brightness:")
+MUI_XY("BR", 60, 42)
+MUI_LABEL(0, 52, "Auto lock:")
+MUI_XY("AL", 60, 52)
+MUI_GOTO(0, 62, 2, "Back")
+
+MUI_FORM(2)
+MUI_STYLE(0)
+MUI_LABEL(0, 8, "Select account")
+MUI_XYAT("AC", 0, 24, 0, "Main|Savings|Trading|Cold|Hot|Test 1|Test 2|Test 3")
+MUI_GOTO(0, 40, 1, "Settings")
+MUI_GOTO(64, 40, 3, "Display")
+
+MUI_FORM(3)
+MUI_STYLE(0)
+MUI_LABEL(0, 8, "Display")
+MUI_XY("BR", 60, 24)
+MUI_GOTO(0, 40, 1, "Back")
+;
+
+static double elapsed_us(clock_t start)
+{
+  return (double)(clock() - start) * 1000000.0 / CLOCKS_PER_SEC / LOOPS;
+}
+
+#define STEPS 40
+
+static void bench(const char *name, uint8_t *buf_out, uint8_t *pos_out)
+{
+  clock_t t;
+  int i;
+  
+  mui_GotoForm(&ui, 1, 0);
+  t = clock();
+  for( i = 0; i < LOOPS; i++ )
+  {
+    u8g2_ClearBuffer(&u8g2);
+    mui_Draw(&ui);
+  }
+  printf("%-10s draw      %7.2f us\n", name, elapsed_us(t));
+  
+  t = clock();
+  for( i = 0; i < LOOPS; i++ )
+    mui_NextField(&ui);
+  printf("%-10s next      %7.2f us\n", name, elapsed_us(t));
+
+  t = clock();
+  for( i = 0; i < LOOPS; i++ )
+    mui_PrevField(&ui);
+  printf("%-10s prev      %7.2f us\n", name, elapsed_us(t));
+  
+  t = clock();
+  for( i = 0; i < LOOPS; i++ )
+    mui_GotoForm(&ui, (i & 1) ? 1 : 3, 0);
+  printf("%-10s goto      %7.2f us\n", name, elapsed_us(t));
+  
+  /* fixed sequence for comparing the cursor positions, both directions and wrapping */
+  mui_GotoForm(&ui, 1, 0);
+  for( i = 0; i < STEPS; i++ )
+  {
+    if ( i < STEPS/2 )
+      mui_NextField(&ui);
+    else
+      mui_PrevField(&ui);
+    pos_out[i] = mui_GetCurrentCursorFocusPosition(&ui);
+  }
+  
+  /* fixed sequence for comparing the screen content */
+  mui_GotoForm(&ui, 1, 3);
+  mui_NextField(&ui);
+  mui_NextField(&ui);
+  u8g2_ClearBuffer(&u8g2);
+  mui_Draw(&ui);
+  memcpy(buf_out, u8g2_GetBufferPtr(&u8g2), 1024);
+}
+
+int main(void)
+{
+  static mui_cform_t cforms[8];
+  static mui_cfield_t cfields[40];
+  static uint8_t buf_fds[1024], buf_compiled[1024];
+  static uint8_t pos_fds[STEPS], pos_compiled[STEPS];
+  
+  u8g2_Setup_ssd1306_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  u8g2_InitDisplay(&u8g2);
+  
+  mui_Init(&ui, &u8g2, fds_data, muif_list, sizeof(muif_list)/sizeof(muif_t));
+  bench("fds", buf_fds, pos_fds);
+  
+  mui_Init(&ui, &u8g2, fds_data, muif_list, sizeof(muif_list)/sizeof(muif_t));
+  if ( mui_Compile(&ui, cforms, 8, cfields, 40) == 0 )
+  {
+    printf("mui_Compile failed\n");
+    return 1;
+  }
+  bench("compiled", buf_compiled, pos_compiled);
+  
+  printf("cursor positions %s\n", memcmp(pos_fds, pos_compiled, STEPS) == 0 ? "equal" : "DIFFERENT");
+  printf("screen content %s\n", memcmp(buf_fds, buf_compiled, 1024) == 0 ? "equal" : "DIFFERENT");
+  return 0;
+}
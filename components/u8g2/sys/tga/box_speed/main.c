@@ -0,0 +1,146 @@
+
+#include "u8g2.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+  Compares u8g2_DrawBox() (page fill fast path) against the per line
+  reference (one u8g2_DrawHVLine() per row, the previous implementation)
+  for correctness and speed on a vertical top lsb buffer.
+*/
+
+extern void u8x8_Setup_TGA_LCD(u8x8_t *u8x8);
+extern void u8g2_SetupBuffer_TGA_LCD(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb);
+extern void tga_save(const char *name);
+
+#define WIDTH 128
+#define HEIGHT 64
+
+u8g2_t u8g2;
+static uint8_t full_buf[WIDTH*HEIGHT/8];
+static uint8_t ref_screen[WIDTH*HEIGHT/8];
+static uint8_t box_screen[WIDTH*HEIGHT/8];
+
+static void draw_box_lines(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h)
+{
+#ifdef U8G2_WITH_INTERSECTION
+  if ( u8g2_IsIntersection(u8g2, x, y, x+w, y+h) == 0 ) 
+    return;
+#endif /* U8G2_WITH_INTERSECTION */
+  while( h != 0 )
+  { 
+    u8g2_DrawHVLine(u8g2, x, y, w, 0);
+    y++;    
+    h--;
+  }
+}
+
+typedef void (*box_fn)(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h);
+
+struct box { u8g2_uint_t x, y, w, h; uint8_t color; };
+
+static void draw_boxes(box_fn fn, const struct box *b, int cnt)
+{
+  int i;
+  for( i = 0; i < cnt; i++ )
+  {
+    u8g2_SetDrawColor(&u8g2, b[i].color);
+    fn(&u8g2, b[i].x, b[i].y, b[i].w, b[i].h);
+  }
+}
+
+/* render into "screen", page by page if the buffer has only one tile row */
+static void render(box_fn fn, const struct box *b, int cnt, uint8_t *screen, int clip)
+{
+  uint8_t row;
+  uint8_t rows = u8g2_GetBufferTileHeight(&u8g2);
+  
+  for( row = 0; row < HEIGHT/8; row += rows )
+  {
+    u8g2_SetBufferCurrTileRow(&u8g2, row);
+    if ( clip )
+      u8g2_SetClipWindow(&u8g2, 10, 5, 100, 50);
+    else
+      u8g2_SetMaxClipWindow(&u8g2);
+    memset(u8g2_GetBufferPtr(&u8g2), 0x5a, WIDTH*rows);
+    draw_boxes(fn, b, cnt);
+    memcpy(screen+row*WIDTH, u8g2_GetBufferPtr(&u8g2), WIDTH*rows);
+  }
+}
+
+static int check(const char *name)
+{
+  struct box b[64];
+  int round, i, clip;
+  
+  for( round = 0; round < 2000; round++ )
+  {
+    for( i = 0; i < 64; i++ )
+    {
+      /* include boxes partly or fully outside of the display and wrapped coordinates */
+      b[i].x = (u8g2_uint_t)(rand() % 180 - 30);
+      b[i].y = (u8g2_uint_t)(rand() % 100 - 20);
+      b[i].w = rand() % 140;
+      b[i].h = rand() % 80;
+      b[i].color = rand() % 3;
+    }
+    clip = round & 1;
+    render(draw_box_lines, b, 64, ref_screen, clip);
+    render(u8g2_DrawBox, b, 64, box_screen, clip);
+    if ( memcmp(ref_screen, box_screen, sizeof(ref_screen)) != 0 )
+    {
+      printf("%s: mismatch in round %d\n", name, round);
+      return 0;
+    }
+  }
+  printf("%s: 2000 rounds of 64 random boxes (colors 0/1/2, clipping) equal\n", name);
+  return 1;
+}
+
+static double bench(box_fn fn, const struct box *b, int cnt)
+{
+  clock_t start;
+  long i, n = 200000;
+  
+  start = clock();
+  for( i = 0; i < n; i++ )
+    draw_boxes(fn, b, cnt);
+  return (double)(clock()-start)*1e6/CLOCKS_PER_SEC/n;
+}
+
+int main(void)
+{
+  static const struct box progress[] = { { 1, 55, 126, 4, 1 } };	/* draw_splash_progress */
+  static const struct box highlight[] = { { 0, 26, 128, 11, 2 } };	/* inverted menu line */
+  static const struct box clear[] = { { 0, 0, 128, 64, 0 } };		/* full screen clear */
+  static const struct box ui[] = { { 1, 55, 126, 4, 1 }, { 0, 26, 128, 11, 2 }, { 20, 3, 40, 20, 1 }, { 64, 40, 60, 13, 0 } };
+  int ok = 1;
+  
+  u8x8_Setup_TGA_LCD(u8g2_GetU8x8(&u8g2));
+  u8g2_SetupBuffer(&u8g2, full_buf, HEIGHT/8, u8g2_ll_hvline_vertical_top_lsb, &u8g2_cb_r0);
+  ok &= check("full buffer");
+  u8g2_SetMaxClipWindow(&u8g2);
+  
+  printf("%-22s %10s %10s\n", "box", "lines us", "fill us");
+  printf("%-22s %10.3f %10.3f\n", "progress bar 126x4", bench(draw_box_lines, progress, 1), bench(u8g2_DrawBox, progress, 1));
+  printf("%-22s %10.3f %10.3f\n", "xor highlight 128x11", bench(draw_box_lines, highlight, 1), bench(u8g2_DrawBox, highlight, 1));
+  printf("%-22s %10.3f %10.3f\n", "clear 128x64", bench(draw_box_lines, clear, 1), bench(u8g2_DrawBox, clear, 1));
+  printf("%-22s %10.3f %10.3f\n", "4 mixed ui boxes", bench(draw_box_lines, ui, 4), bench(u8g2_DrawBox, ui, 4));
+  
+  u8g2_SetupBuffer_TGA_LCD(&u8g2, &u8g2_cb_r0);
+  ok &= check("page buffer");
+
+  u8x8_InitDisplay(u8g2_GetU8x8(&u8g2));
+  u8x8_SetPowerSave(u8g2_GetU8x8(&u8g2), 0);  
+  u8g2_SetMaxClipWindow(&u8g2);
+  u8g2_FirstPage(&u8g2);
+  do
+  {
+    draw_boxes(u8g2_DrawBox, ui, 4);
+  } while( u8g2_NextPage(&u8g2) );
+  tga_save("u8g2.tga");
+  
+  return ok ? 0 : 1;
+}
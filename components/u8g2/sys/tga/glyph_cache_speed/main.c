@@ -0,0 +1,169 @@
+
+#include "u8g2.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* single font files do not include u8g2.h */
+#include "../../../tools/font/build/single_font_files/u8g2_font_6x10_tf.c"
+#include "../../../tools/font/build/single_font_files/u8g2_font_helvR08_tr.c"
+#include "../../../tools/font/build/single_font_files/u8g2_font_ncenB14_tr.c"
+
+/*
+  Compares text drawn through the glyph cache (U8G2_GLYPH_CACHE_SIZE) against 
+  the RLE decoder for correctness and speed. The decoder is selected with a 
+  copy of u8g2_cb_r0, which draws the same but is not recognized by the cache.
+*/
+
+#ifndef U8G2_WITH_GLYPH_CACHE
+#error "build with -DU8G2_GLYPH_CACHE_SIZE=..."
+#endif
+
+extern void u8x8_Setup_TGA_LCD(u8x8_t *u8x8);
+extern void u8g2_SetupBuffer_TGA_LCD(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb);
+extern void tga_save(const char *name);
+
+#define WIDTH 128
+#define HEIGHT 64
+
+static void draw_l90_r0_decode(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len, uint8_t dir)
+{
+  u8g2_draw_l90_r0(u8g2, x, y, len, dir);
+}
+static u8g2_cb_t cb_r0_decode;	/* u8g2_cb_r0 with draw_l90_r0_decode, see main() */
+
+u8g2_t u8g2;
+static uint8_t full_buf[WIDTH*HEIGHT/8];
+static uint8_t ref_screen[WIDTH*HEIGHT/8];
+static uint8_t cache_screen[WIDTH*HEIGHT/8];
+
+struct text { const uint8_t *font; u8g2_uint_t x, y; uint8_t color, mode; char s[24]; };
+
+static void draw_texts(const struct text *t, int cnt)
+{
+  int i;
+  for( i = 0; i < cnt; i++ )
+  {
+    u8g2_SetFont(&u8g2, t[i].font);
+    u8g2_SetFontMode(&u8g2, t[i].mode);
+    u8g2_SetDrawColor(&u8g2, t[i].color);
+    u8g2_DrawStr(&u8g2, t[i].x, t[i].y, t[i].s);
+  }
+}
+
+/* render into "screen", page by page if the buffer has only one tile row */
+static void render(const u8g2_cb_t *cb, const struct text *t, int cnt, uint8_t *screen, int clip)
+{
+  uint8_t row;
+  uint8_t rows = u8g2_GetBufferTileHeight(&u8g2);
+  
+  u8g2.cb = cb;
+  for( row = 0; row < HEIGHT/8; row += rows )
+  {
+    u8g2_SetBufferCurrTileRow(&u8g2, row);
+    if ( clip )
+      u8g2_SetClipWindow(&u8g2, 10, 5, 100, 50);
+    else
+      u8g2_SetMaxClipWindow(&u8g2);
+    memset(u8g2_GetBufferPtr(&u8g2), 0x5a, WIDTH*rows);
+    draw_texts(t, cnt);
+    memcpy(screen+row*WIDTH, u8g2_GetBufferPtr(&u8g2), WIDTH*rows);
+  }
+}
+
+static int check(const char *name)
+{
+  static const uint8_t *fonts[3] = { u8g2_font_6x10_tf, u8g2_font_helvR08_tr, u8g2_font_ncenB14_tr };
+  struct text t[16];
+  int round, i, j, clip;
+  
+  for( round = 0; round < 2000; round++ )
+  {
+    for( i = 0; i < 16; i++ )
+    {
+      /* include text partly or fully outside of the display and wrapped coordinates */
+      t[i].font = fonts[rand() % 3];
+      t[i].x = (u8g2_uint_t)(rand() % 160 - 20);
+      t[i].y = (u8g2_uint_t)(rand() % 100 - 10);
+      t[i].color = rand() % 3;
+      t[i].mode = rand() % 2;
+      for( j = 0; j < 1 + rand() % 22; j++ )
+        t[i].s[j] = ' ' + rand() % 95;
+      t[i].s[j] = '\0';
+    }
+    clip = round & 1;
+    render(&cb_r0_decode, t, 16, ref_screen, clip);
+    render(&u8g2_cb_r0, t, 16, cache_screen, clip);
+    if ( memcmp(ref_screen, cache_screen, sizeof(ref_screen)) != 0 )
+    {
+      printf("%s: mismatch in round %d\n", name, round);
+      return 0;
+    }
+  }
+  printf("%s: 2000 rounds of 16 random strings (3 fonts, colors 0/1/2, solid/transparent, clipping) equal\n", name);
+  return 1;
+}
+
+static double bench(const u8g2_cb_t *cb, const struct text *t, int cnt)
+{
+  clock_t start;
+  long i, n = 100000;
+  
+  u8g2.cb = cb;
+  start = clock();
+  for( i = 0; i < n; i++ )
+    draw_texts(t, cnt);
+  return (double)(clock()-start)*1e6/CLOCKS_PER_SEC/n;
+}
+
+int main(void)
+{
+  /* password.c: PIN pad screen */
+  static const struct text pin[] = {
+    { u8g2_font_6x10_tf, 30, 15, 1, 0, "Choose PIN" },
+    { u8g2_font_6x10_tf, 0, 35, 1, 0, "0123456789x" },
+    { u8g2_font_6x10_tf, 24, 45, 1, 0, "_" },
+    { u8g2_font_6x10_tf, 50, 62, 1, 0, "***" },
+  };
+  /* 42 character hex address on three lines */
+  static const struct text addr[] = {
+    { u8g2_font_6x10_tf, 0, 10, 1, 0, "0x52908400098527886E0F" },
+    { u8g2_font_6x10_tf, 0, 21, 1, 0, "7030069857D2E4169EE7" },
+    { u8g2_font_6x10_tf, 0, 33, 2, 1, "  Confirm address?  " },
+  };
+  uint32_t hits, misses;
+  int ok = 1;
+  
+  cb_r0_decode = u8g2_cb_r0;
+  cb_r0_decode.draw_l90 = draw_l90_r0_decode;
+  
+  u8x8_Setup_TGA_LCD(u8g2_GetU8x8(&u8g2));
+  u8g2_SetupBuffer(&u8g2, full_buf, HEIGHT/8, u8g2_ll_hvline_vertical_top_lsb, &u8g2_cb_r0);
+  u8g2_SetFontDirection(&u8g2, 0);
+  ok &= check("full buffer");
+  u8g2_SetMaxClipWindow(&u8g2);
+  
+  u8g2_ClearGlyphCache();
+  printf("%-22s %10s %10s\n", "screen", "decode us", "cache us");
+  printf("%-22s %10.3f %10.3f\n", "PIN pad", bench(&cb_r0_decode, pin, 4), bench(&u8g2_cb_r0, pin, 4));
+  printf("%-22s %10.3f %10.3f\n", "hex address", bench(&cb_r0_decode, addr, 3), bench(&u8g2_cb_r0, addr, 3));
+  u8g2_GetGlyphCacheStats(&hits, &misses);
+  printf("cache: %lu hits, %lu misses (%.4f%% hit rate)\n", 
+    (unsigned long)hits, (unsigned long)misses, 100.0*hits/(hits+misses));
+  
+  u8g2_SetupBuffer_TGA_LCD(&u8g2, &u8g2_cb_r0);
+  ok &= check("page buffer");
+
+  u8x8_InitDisplay(u8g2_GetU8x8(&u8g2));
+  u8x8_SetPowerSave(u8g2_GetU8x8(&u8g2), 0);  
+  u8g2_SetMaxClipWindow(&u8g2);
+  u8g2_FirstPage(&u8g2);
+  do
+  {
+    draw_texts(addr, 3);
+  } while( u8g2_NextPage(&u8g2) );
+  tga_save("u8g2.tga");
+  
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Generate subset u8g2 fonts holding only the characters the UI draws.
+
+The characters come from the string and character literals of the given
+C sources plus the per-font extras in fonts.txt. They are turned into a
+bdfconv -m map (see bdf_map.c) and bdfconv writes each font with just
+those glyphs, so u8g2_font_get_glyph_data() walks a few dozen glyphs
+instead of the full 32-255 range.
+
+usage: gen_ui_fonts.py --fonts fonts.txt --out ui_fonts.c --work DIR src.c...
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+FONT_TOOLS = os.path.join(HERE, '..', 'u8g2', 'tools', 'font')
+BDFCONV_DIR = os.path.join(FONT_TOOLS, 'bdfconv')
+BDF_DIR = os.path.join(FONT_TOOLS, 'bdf')
+BDFCONV_SRCS = ['main.c', 'bdf_font.c', 'bdf_glyph.c', 'bdf_parser.c', 'bdf_map.c',
+                'bdf_rle.c', 'bdf_tga.c', 'fd.c', 'bdf_8x8.c', 'bdf_kern.c']
+
+COMMENT_RE = re.compile(r'//[^\n]*|/\*.*?\*/', re.S)
+LITERAL_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"|\'((?:[^\'\\\n]|\\.)+)\'')
+ESCAPE_RE = re.compile(r'\\(x[0-9a-fA-F]+|[0-7]{1,3}|.)')
+SIMPLE_ESCAPES = {'n': '\n', 't': '\t', 'r': '\r', '0': '\0', '\\': '\\',
+                  '"': '"', "'": "'", '?': '?', 'a': '\a', 'b': '\b', 'f': '\f', 'v': '\v'}
+# Lines whose literals never reach the display.
+SKIP_LINE_RE = re.compile(r'^\s*#\s*include|ESP_LOG[EWIDV]|printf\s*\(')
+
+
+def unescape(text):
+    def repl(m):
+        esc = m.group(1)
+        if esc[0] == 'x':
+            return chr(int(esc[1:], 16))
+        if esc[0] in '01234567' and esc != '0':
+            return chr(int(esc, 8))
+        return SIMPLE_ESCAPES.get(esc, esc)
+    return ESCAPE_RE.sub(repl, text)
+
+
+def source_chars(path):
+    """Characters of all displayable literals in a C source, UTF-8 decoded."""
+    with open(path, encoding='utf-8') as f:
+        text = COMMENT_RE.sub(lambda m: '\n' * m.group(0).count('\n'), f.read())
+    chars = set()
+    for line in text.splitlines():
+        if SKIP_LINE_RE.search(line):
+            continue
+        for m in LITERAL_RE.finditer(line):
+            chars.update(unescape(m.group(1) if m.group(1) is not None else m.group(2)))
+    return {c for c in chars if ord(c) >= 32}
+
+
+def glyph_map(chars):
+    """bdfconv map with one range per run of consecutive code points."""
+    codes = sorted(ord(c) for c in chars)
+    ranges = []
+    for code in codes:
+        if ranges and ranges[-1][1] + 1 == code:
+            ranges[-1][1] = code
+        else:
+            ranges.append([code, code])
+    return ','.join(str(a) if a == b else '%d-%d' % (a, b) for a, b in ranges)
+
+
+def read_fonts(path):
+    fonts = []
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            fields = line.split('#', 1)[0].split()
+            if not fields:
+                continue
+            if len(fields) > 3:
+                sys.exit('%s: expected "<name> <bdf> [extra chars]": %s' % (path, line.strip()))
+            fonts.append((fields[0], fields[1], fields[2] if len(fields) == 3 else ''))
+    return fonts
+
+
+def build_bdfconv(work):
+    """Compile bdfconv with the host compiler, or use the bundled Windows binary."""
+    if os.name == 'nt':
+        return os.path.join(BDFCONV_DIR, 'bdfconv.exe')
+    exe = os.path.join(work, 'bdfconv')
+    srcs = [os.path.join(BDFCONV_DIR, s) for s in BDFCONV_SRCS]
+    if os.path.exists(exe) and all(os.path.getmtime(s) <= os.path.getmtime(exe) for s in srcs):
+        return exe
+    cc = os.environ.get('HOST_CC', 'cc')
+    subprocess.check_call([cc, '-O2', '-w', '-o', exe] + srcs)
+    return exe
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--fonts', required=True, help='font list, see fonts.txt')
+    parser.add_argument('--out', required=True, help='generated C file')
+    parser.add_argument('--work', required=True, help='directory for bdfconv and its output')
+    parser.add_argument('sources', nargs='+', help='UI sources to collect characters from')
+    args = parser.parse_args()
+
+    os.makedirs(args.work, exist_ok=True)
+    used = {' '}
+    for src in args.sources:
+        used |= source_chars(src)
+
+    bdfconv = build_bdfconv(args.work)
+    out = ['/* Generated by gen_ui_fonts.py from fonts.txt, do not edit. */',
+           '#include "ui_fonts.h"', '']
+    for name, bdf, extra in read_fonts(args.fonts):
+        chars = used | set(extra)
+        font_c = os.path.join(args.work, name + '.c')
+        subprocess.check_call([bdfconv, '-f', '1', '-b', '0', '-m', glyph_map(chars),
+                               os.path.join(BDF_DIR, bdf), '-n', name, '-o', font_c],
+                              stdout=subprocess.DEVNULL)
+        with open(font_c, encoding='utf-8') as f:
+            out.append(f.read())
+        print('%s: %d glyphs: %s' % (name, len(chars), ''.join(sorted(chars))))
+
+    with open(args.out, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,16 @@
+#ifndef UI_FONTS_H
+#define UI_FONTS_H
+
+#include "u8g2.h"
+
+/*
+ * Subset fonts generated at build time by gen_ui_fonts.py. They contain
+ * only the characters found in the UI sources plus the extras listed in
+ * fonts.txt. A character missing from the font is silently not drawn, so
+ * text built at runtime must have its characters listed there.
+ */
+
+// 6x10 fixed, same metrics as u8g2_font_6x10_tf.
+extern const uint8_t ui_font_6x10[] U8G2_FONT_SECTION("ui_font_6x10");
+
+#endif // UI_FONTS_H
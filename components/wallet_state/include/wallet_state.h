@@ -0,0 +1,108 @@
+#ifndef WALLET_STATE_H
+#define WALLET_STATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Size of the state image: header plus all records.
+#ifndef WALLET_STATE_MAX_SIZE
+#define WALLET_STATE_MAX_SIZE 512
+#endif
+
+#ifndef WALLET_STATE_MAX_RECORDS
+#define WALLET_STATE_MAX_RECORDS 16
+#endif
+
+// Value the counters restart from when their blob fails the CRC, so a
+// damaged fail counter does not read as zero wrong PINs.
+#ifndef WALLET_COUNTER_CORRUPT_VALUE
+#define WALLET_COUNTER_CORRUPT_VALUE 8
+#endif
+
+/**
+ * @brief Record tags. Values are stored in flash; never renumber them.
+ */
+typedef enum {
+    WALLET_REC_PIN = 1,  // PIN digits, one byte per digit
+} wallet_record_t;
+
+/**
+ * @brief Counters kept apart from the records so that bumping one does
+ *        not rewrite the whole state.
+ */
+typedef enum {
+    WALLET_COUNTER_PIN_FAILS,  // wrong PINs since the last correct one
+    WALLET_COUNTER_COUNT,
+} wallet_counter_t;
+
+typedef struct {
+    uint32_t load_us;         // wallet_state_load() duration
+    uint16_t records;         // records in RAM
+    uint16_t bytes;           // size of the state image
+    uint32_t commits;         // state writes to flash since boot
+    uint32_t counter_writes;  // counter writes to flash since boot
+} wallet_state_stats_t;
+
+/**
+ * @brief Read the state and the counters from NVS into RAM.
+ *
+ * Call once at boot after nvs_flash_init(). A PIN stored by the previous
+ * firmware (storage/pin_code) is moved into the state.
+ *
+ * @return ESP_OK, also when nothing was stored yet, ESP_ERR_INVALID_CRC
+ *         when the stored state is corrupt or ESP_ERR_INVALID_VERSION when
+ *         it was written by a newer firmware. In both error cases the state
+ *         is locked: it stays empty, read-only and the flash copy is kept.
+ */
+esp_err_t wallet_state_load(void);
+
+/**
+ * @brief Whether the stored state could not be read (see wallet_state_load).
+ *
+ * An empty state then does not mean that no PIN was set, so the caller must
+ * not offer to choose one.
+ */
+bool wallet_state_locked(void);
+
+/**
+ * @brief Copy a record out of the RAM index.
+ *
+ * @param tag Record to read.
+ * @param out Buffer for the value.
+ * @param len In: size of out. Out: length of the value.
+ * @return true if the record exists and fits out.
+ */
+bool wallet_state_get(wallet_record_t tag, void *out, size_t *len);
+
+/**
+ * @brief Create or replace a record in RAM. Nothing is written to flash
+ *        until wallet_state_commit(), so several changes cost one write.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE (value over 255 bytes) or
+ *         ESP_ERR_NO_MEM (state full).
+ */
+esp_err_t wallet_state_set(wallet_record_t tag, const void *value, size_t len);
+
+/**
+ * @brief Remove a record from RAM.
+ */
+void wallet_state_erase(wallet_record_t tag);
+
+/**
+ * @brief Write the state to flash if it changed since the last commit.
+ */
+esp_err_t wallet_state_commit(void);
+
+uint32_t wallet_state_counter(wallet_counter_t counter);
+
+/**
+ * @brief Set a counter and write the counters to flash right away (only
+ *        if the value changed).
+ */
+esp_err_t wallet_state_counter_set(wallet_counter_t counter, uint32_t value);
+
+void wallet_state_get_stats(wallet_state_stats_t *stats);
+
+#endif // WALLET_STATE_H
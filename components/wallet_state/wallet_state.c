@@ -0,0 +1,404 @@
+#include "wallet_state.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+#define WALLET_NVS_NAMESPACE   "wallet"
+#define WALLET_NVS_STATE_KEY   "state"
+#define WALLET_NVS_COUNTER_KEY "ctr"
+#define WALLET_STATE_VERSION   1
+
+// Counters a newer firmware may have stored; kept and written back.
+#define WALLET_STATE_MAX_COUNTERS 16
+
+// PIN written by password.c before this module existed.
+#define LEGACY_NVS_NAMESPACE   "storage"
+#define LEGACY_NVS_PIN_KEY     "pin_code"
+#define LEGACY_PIN_LENGTH      4
+
+static const char *TAG = "wallet_state";
+
+// NVS namespace "wallet" holds two blobs:
+//   "state": header, then records of tag (1 byte), length (1 byte), value.
+//            Rewritten as a whole by wallet_state_commit().
+//   "ctr":   uint32_t counters followed by their CRC-32. Small, so a
+//            counter bump costs one NVS entry instead of the whole state;
+//            NVS appends every write to its page log, which spreads the
+//            wear over the partition.
+typedef struct __attribute__((packed)) {
+    uint8_t magic[2];  // "WS"
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t length;   // bytes of records after the header
+    uint32_t crc;      // CRC-32 of the records
+} state_header_t;
+
+typedef struct {
+    uint8_t tag;
+    uint8_t len;
+    uint16_t offset;  // of the value in image
+} record_index_t;
+
+static SemaphoreHandle_t lock;
+static uint8_t image[WALLET_STATE_MAX_SIZE];
+static size_t records_len;
+static record_index_t index_table[WALLET_STATE_MAX_RECORDS];
+static int index_count;
+static bool dirty;
+static bool read_only;
+static uint32_t counters[WALLET_STATE_MAX_COUNTERS];
+static size_t counters_stored;  // counters in the "ctr" blob
+static wallet_state_stats_t stats;
+
+#define RECORDS (image + sizeof(state_header_t))
+#define RECORDS_CAPACITY (WALLET_STATE_MAX_SIZE - sizeof(state_header_t))
+
+// Rebuilds index_table from the records; false if they are malformed.
+static bool index_records(void)
+{
+    size_t pos = 0;
+
+    index_count = 0;
+    while (pos < records_len) {
+        if (pos + 2 > records_len || pos + 2 + RECORDS[pos + 1] > records_len ||
+            RECORDS[pos] == 0 || index_count == WALLET_STATE_MAX_RECORDS) {
+            index_count = 0;
+            return false;
+        }
+        index_table[index_count].tag = RECORDS[pos];
+        index_table[index_count].len = RECORDS[pos + 1];
+        index_table[index_count].offset = (uint16_t)(sizeof(state_header_t) + pos + 2);
+        index_count++;
+        pos += 2 + RECORDS[pos + 1];
+    }
+    return true;
+}
+
+static const record_index_t *find_record(wallet_record_t tag)
+{
+    for (int i = 0; i < index_count; i++) {
+        if (index_table[i].tag == tag) {
+            return &index_table[i];
+        }
+    }
+    return NULL;
+}
+
+static void remove_record(const record_index_t *rec)
+{
+    size_t start = rec->offset - 2 - sizeof(state_header_t);
+    size_t size = 2 + rec->len;
+
+    memmove(RECORDS + start, RECORDS + start + size, records_len - start - size);
+    records_len -= size;
+    index_records();
+}
+
+static esp_err_t check_image(size_t size)
+{
+    const state_header_t *hdr = (const state_header_t *)image;
+
+    if (size < sizeof(state_header_t) || memcmp(hdr->magic, "WS", 2) != 0) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (hdr->version > WALLET_STATE_VERSION) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (hdr->length != size - sizeof(state_header_t) ||
+        esp_rom_crc32_le(0, RECORDS, hdr->length) != hdr->crc) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    records_len = hdr->length;
+    return index_records() ? ESP_OK : ESP_ERR_INVALID_CRC;
+}
+
+static void load_counters(nvs_handle_t handle)
+{
+    uint32_t blob[WALLET_STATE_MAX_COUNTERS + 1];
+    size_t size = sizeof(blob);
+
+    esp_err_t err = nvs_get_blob(handle, WALLET_NVS_COUNTER_KEY, blob, &size);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        return;
+    }
+    size_t n = size / sizeof(uint32_t);
+    if (err != ESP_OK || n < 2 || size % sizeof(uint32_t) != 0 ||
+        esp_rom_crc32_le(0, (const uint8_t *)blob, (n - 1) * sizeof(uint32_t)) != blob[n - 1]) {
+        ESP_LOGE(TAG, "counters corrupt, restarting them at %d", WALLET_COUNTER_CORRUPT_VALUE);
+        for (int i = 0; i < WALLET_COUNTER_COUNT; i++) {
+            counters[i] = WALLET_COUNTER_CORRUPT_VALUE;
+        }
+        return;
+    }
+    memcpy(counters, blob, (n - 1) * sizeof(uint32_t));
+    counters_stored = n - 1;
+}
+
+static esp_err_t write_state(void)
+{
+    state_header_t *hdr = (state_header_t *)image;
+    nvs_handle_t handle;
+
+    memcpy(hdr->magic, "WS", 2);
+    hdr->version = WALLET_STATE_VERSION;
+    hdr->reserved = 0;
+    hdr->length = (uint16_t)records_len;
+    hdr->crc = esp_rom_crc32_le(0, RECORDS, records_len);
+
+    esp_err_t err = nvs_open(WALLET_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_blob(handle, WALLET_NVS_STATE_KEY, image, sizeof(state_header_t) + records_len);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err == ESP_OK) {
+        dirty = false;
+        stats.commits++;
+    }
+    return err;
+}
+
+static esp_err_t set_record(wallet_record_t tag, const void *value, size_t len)
+{
+    const record_index_t *rec = find_record(tag);
+
+    if (len > 255) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t freed = rec != NULL ? 2 + rec->len : 0;
+    if (records_len - freed + 2 + len > RECORDS_CAPACITY ||
+        (rec == NULL && index_count == WALLET_STATE_MAX_RECORDS)) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (rec != NULL) {
+        if (rec->len == len && memcmp(image + rec->offset, value, len) == 0) {
+            return ESP_OK;
+        }
+        remove_record(rec);
+    }
+    RECORDS[records_len] = (uint8_t)tag;
+    RECORDS[records_len + 1] = (uint8_t)len;
+    memcpy(RECORDS + records_len + 2, value, len);
+    records_len += 2 + len;
+    index_records();
+    dirty = true;
+    return ESP_OK;
+}
+
+// Moves storage/pin_code (int[4]) into a WALLET_REC_PIN record.
+static void migrate_legacy_pin(void)
+{
+    nvs_handle_t handle;
+    int pin[LEGACY_PIN_LENGTH];
+    uint8_t digits[LEGACY_PIN_LENGTH];
+    size_t size = sizeof(pin);
+
+    if (nvs_open(LEGACY_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return;
+    }
+    esp_err_t err = nvs_get_blob(handle, LEGACY_NVS_PIN_KEY, pin, &size);
+    nvs_close(handle);
+    if (err != ESP_OK || size != sizeof(pin)) {
+        return;
+    }
+
+    for (int i = 0; i < LEGACY_PIN_LENGTH; i++) {
+        digits[i] = (uint8_t)pin[i];
+    }
+    if (set_record(WALLET_REC_PIN, digits, sizeof(digits)) == ESP_OK && write_state() == ESP_OK &&
+        nvs_open(LEGACY_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK) {
+        nvs_erase_key(handle, LEGACY_NVS_PIN_KEY);
+        nvs_commit(handle);
+        nvs_close(handle);
+        ESP_LOGI(TAG, "moved the PIN from %s/%s", LEGACY_NVS_NAMESPACE, LEGACY_NVS_PIN_KEY);
+    }
+    memset(pin, 0, sizeof(pin));
+    memset(digits, 0, sizeof(digits));
+}
+
+esp_err_t wallet_state_load(void)
+{
+    int64_t start = esp_timer_get_time();
+    nvs_handle_t handle;
+    esp_err_t ret = ESP_OK;
+    bool found = false;
+
+    if (lock == NULL) {
+        lock = xSemaphoreCreateMutex();
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    records_len = 0;
+    index_count = 0;
+    dirty = false;
+    read_only = false;
+    memset(counters, 0, sizeof(counters));
+    counters_stored = 0;
+
+    if (nvs_open(WALLET_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        size_t size = sizeof(image);
+        esp_err_t err = nvs_get_blob(handle, WALLET_NVS_STATE_KEY, image, &size);
+        if (err == ESP_OK) {
+            found = true;
+            err = check_image(size);
+        } else if (err == ESP_ERR_NVS_INVALID_LENGTH) {
+            found = true;  // larger than this firmware's image
+            err = ESP_ERR_INVALID_VERSION;
+        }
+        if (err == ESP_ERR_INVALID_VERSION) {
+            ESP_LOGE(TAG, "state written by a newer firmware, not touching it");
+        } else if (found && err != ESP_OK) {
+            // Starting empty would drop the PIN and offer to choose a new one.
+            ESP_LOGE(TAG, "state corrupt, locked");
+            err = ESP_ERR_INVALID_CRC;
+        }
+        if (found && err != ESP_OK) {
+            records_len = 0;
+            index_count = 0;
+            read_only = true;
+            ret = err;
+        }
+        load_counters(handle);
+        nvs_close(handle);
+    }
+    if (!found) {
+        migrate_legacy_pin();
+    }
+
+    stats.load_us = (uint32_t)(esp_timer_get_time() - start);
+    stats.records = (uint16_t)index_count;
+    stats.bytes = (uint16_t)(sizeof(state_header_t) + records_len);
+    ESP_LOGI(TAG, "%d records (%u bytes), %u counters loaded in %lu us", index_count,
+             (unsigned)stats.bytes, (unsigned)counters_stored, (unsigned long)stats.load_us);
+    xSemaphoreGive(lock);
+    return ret;
+}
+
+bool wallet_state_locked(void)
+{
+    return read_only;
+}
+
+bool wallet_state_get(wallet_record_t tag, void *out, size_t *len)
+{
+    bool ok = false;
+
+    if (lock == NULL) {
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const record_index_t *rec = find_record(tag);
+    if (rec != NULL && rec->len <= *len) {
+        memcpy(out, image + rec->offset, rec->len);
+        *len = rec->len;
+        ok = true;
+    }
+    xSemaphoreGive(lock);
+    return ok;
+}
+
+esp_err_t wallet_state_set(wallet_record_t tag, const void *value, size_t len)
+{
+    if (lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    esp_err_t err = read_only ? ESP_ERR_INVALID_VERSION : set_record(tag, value, len);
+    xSemaphoreGive(lock);
+    return err;
+}
+
+void wallet_state_erase(wallet_record_t tag)
+{
+    if (lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const record_index_t *rec = find_record(tag);
+    if (rec != NULL && !read_only) {
+        remove_record(rec);
+        dirty = true;
+    }
+    xSemaphoreGive(lock);
+}
+
+esp_err_t wallet_state_commit(void)
+{
+    esp_err_t err = ESP_OK;
+
+    if (lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (read_only) {
+        err = ESP_ERR_INVALID_VERSION;
+    } else if (dirty) {
+        err = write_state();
+    }
+    xSemaphoreGive(lock);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "commit failed: 0x%x", err);
+    }
+    return err;
+}
+
+uint32_t wallet_state_counter(wallet_counter_t counter)
+{
+    uint32_t value;
+
+    if (counter >= WALLET_COUNTER_COUNT || lock == NULL) {
+        return 0;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    value = counters[counter];
+    xSemaphoreGive(lock);
+    return value;
+}
+
+esp_err_t wallet_state_counter_set(wallet_counter_t counter, uint32_t value)
+{
+    uint32_t blob[WALLET_STATE_MAX_COUNTERS + 1];
+    nvs_handle_t handle;
+
+    if (counter >= WALLET_COUNTER_COUNT || lock == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (counters[counter] == value) {
+        xSemaphoreGive(lock);
+        return ESP_OK;
+    }
+    counters[counter] = value;
+    if (counters_stored < WALLET_COUNTER_COUNT) {
+        counters_stored = WALLET_COUNTER_COUNT;
+    }
+    memcpy(blob, counters, counters_stored * sizeof(uint32_t));
+    blob[counters_stored] = esp_rom_crc32_le(0, (const uint8_t *)blob,
+                                             counters_stored * sizeof(uint32_t));
+
+    esp_err_t err = nvs_open(WALLET_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, WALLET_NVS_COUNTER_KEY, blob,
+                           (counters_stored + 1) * sizeof(uint32_t));
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err == ESP_OK) {
+        stats.counter_writes++;
+    }
+    xSemaphoreGive(lock);
+    return err;
+}
+
+void wallet_state_get_stats(wallet_state_stats_t *out)
+{
+    *out = stats;
+}
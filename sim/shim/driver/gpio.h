@@ -0,0 +1,13 @@
+#ifndef SIM_DRIVER_GPIO_H
+#define SIM_DRIVER_GPIO_H
+
+#include <stdbool.h>
+
+// Pin numbers only; button levels come from the simulator's script.
+typedef int gpio_num_t;
+
+#define GPIO_NUM_4  4
+#define GPIO_NUM_16 16
+#define GPIO_NUM_17 17
+
+#endif // SIM_DRIVER_GPIO_H
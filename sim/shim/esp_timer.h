@@ -0,0 +1,9 @@
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+// Microseconds since the simulator started.
+int64_t esp_timer_get_time(void);
+
+#endif // SIM_ESP_TIMER_H
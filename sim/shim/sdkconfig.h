@@ -0,0 +1,11 @@
+#ifndef SIM_SDKCONFIG_H
+#define SIM_SDKCONFIG_H
+
+// The sdkconfig options read by the shared components, at their Kconfig
+// defaults. make TRACE=1 adds -DCONFIG_TRACE_ENABLE=1.
+
+#ifndef CONFIG_TRACE_BUFFER_EVENTS
+#define CONFIG_TRACE_BUFFER_EVENTS 1024
+#endif
+
+#endif // SIM_SDKCONFIG_H
@@ -0,0 +1,83 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "u8g2.h"
+
+typedef enum {
+    SIM_BUTTON_LEFT,
+    SIM_BUTTON_RIGHT,
+    SIM_BUTTON_MIDDLE,
+    SIM_BUTTON_COUNT,
+} sim_button_t;
+
+// ------------------------------------------------------------------
+// sim_nvs.c
+// ------------------------------------------------------------------
+
+// File backing NVS, read by nvs_flash_init() and rewritten by
+// nvs_commit(). NULL keeps NVS in memory, i.e. a freshly erased chip.
+extern const char *sim_nvs_path;
+
+// ------------------------------------------------------------------
+// sim_panel.c
+// ------------------------------------------------------------------
+
+/**
+ * @brief Set up u8g2 for an SSD1306 with an I2C byte callback that feeds
+ *        a model of the controller RAM.
+ *
+ * @param u8g2 Instance to set up (not yet initialized).
+ * @param height 32 for the 128x32 module the firmware sets up, or 64.
+ * @param i2c_hz Bus clock used to pace transfers, 0 for no pacing.
+ */
+void sim_panel_setup(u8g2_t *u8g2, int height, uint32_t i2c_hz);
+
+/**
+ * @brief Write every frame the panel shows from now on as PBM files.
+ *
+ * @param dir Existing directory; frames are named frame_NNNN.pbm.
+ */
+void sim_panel_dump_frames(const char *dir);
+
+// ------------------------------------------------------------------
+// sim_buttons.c
+// ------------------------------------------------------------------
+
+/**
+ * @brief Load a button script.
+ *
+ * One step per line: "<delay ms> <action> [arg]", where the delay counts
+ * from the end of the previous step (a press ends on release) and action
+ * is left, right or middle (arg: hold time, default 100 ms), mark (arg:
+ * section name for the report) or end. '#' starts a comment.
+ *
+ * @return false on a syntax error (reported on stderr).
+ */
+bool sim_script_load(const char *path);
+
+/**
+ * @brief Play the script on its own thread and call done() after the
+ *        end step (or the last line).
+ */
+void sim_script_start(void (*done)(void));
+
+// ------------------------------------------------------------------
+// sim_stats.c
+// ------------------------------------------------------------------
+
+void sim_stats_mark(const char *section);
+void sim_stats_input(sim_button_t button);
+void sim_stats_i2c(uint32_t bytes, uint32_t bus_us);
+void sim_stats_frame(void);
+
+/**
+ * @brief Print the per-section report.
+ *
+ * @return Worst input-to-frame latency in microseconds.
+ */
+int64_t sim_stats_report(FILE *out);
+
+#endif // SIM_H
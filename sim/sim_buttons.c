@@ -0,0 +1,156 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "button_listener.h"
+#include "sim.h"
+
+// button_listener replacement: the buttons are "pressed" by a script
+// instead of read from GPIO.
+
+#define SIM_SCRIPT_MAX_STEPS 256
+#define SIM_DEFAULT_HOLD_MS  100
+
+typedef enum {
+    STEP_PRESS,
+    STEP_MARK,
+    STEP_END,
+} step_kind_t;
+
+typedef struct {
+    uint32_t delay_ms;
+    step_kind_t kind;
+    sim_button_t button;
+    uint32_t hold_ms;
+    char section[32];
+} script_step_t;
+
+static const char *TAG = "sim_buttons";
+
+const gpio_num_t BUTTON_LEFT = GPIO_NUM_17;
+const gpio_num_t BUTTON_RIGHT = GPIO_NUM_4;
+const gpio_num_t BUTTON_MIDDLE = GPIO_NUM_16;
+
+static atomic_bool pressed[SIM_BUTTON_COUNT];
+static script_step_t steps[SIM_SCRIPT_MAX_STEPS];
+static int step_count;
+static void (*script_done)(void);
+
+void init_button_listener()
+{
+    ESP_LOGI(TAG, "buttons driven by script, %d steps", step_count);
+}
+
+bool is_button_left_pressed()
+{
+    return atomic_load(&pressed[SIM_BUTTON_LEFT]);
+}
+
+bool is_button_right_pressed()
+{
+    return atomic_load(&pressed[SIM_BUTTON_RIGHT]);
+}
+
+bool is_button_middle_pressed()
+{
+    return atomic_load(&pressed[SIM_BUTTON_MIDDLE]);
+}
+
+static bool parse_step(const char *line, script_step_t *step)
+{
+    static const char *const names[SIM_BUTTON_COUNT] = { "left", "right", "middle" };
+    char action[16], arg[32];
+    unsigned long delay;
+    int n = sscanf(line, "%lu %15s %31s", &delay, action, arg);
+
+    if (n < 2) {
+        return false;
+    }
+    memset(step, 0, sizeof(*step));
+    step->delay_ms = (uint32_t)delay;
+    if (strcmp(action, "mark") == 0) {
+        if (n < 3) {
+            return false;
+        }
+        step->kind = STEP_MARK;
+        snprintf(step->section, sizeof(step->section), "%s", arg);
+        return true;
+    }
+    if (strcmp(action, "end") == 0) {
+        step->kind = STEP_END;
+        return true;
+    }
+    for (int b = 0; b < SIM_BUTTON_COUNT; b++) {
+        if (strcmp(action, names[b]) == 0) {
+            step->kind = STEP_PRESS;
+            step->button = (sim_button_t)b;
+            step->hold_ms = n == 3 ? (uint32_t)strtoul(arg, NULL, 10) : SIM_DEFAULT_HOLD_MS;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sim_script_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[128];
+    int lineno = 0;
+
+    if (f == NULL) {
+        fprintf(stderr, "sim: cannot open script %s\n", path);
+        return false;
+    }
+    step_count = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        lineno++;
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        if (strspn(line, " \t\r\n") == strlen(line)) {
+            continue;
+        }
+        if (step_count == SIM_SCRIPT_MAX_STEPS || !parse_step(line, &steps[step_count])) {
+            fprintf(stderr, "%s:%d: bad step: %s", path, lineno, line);
+            fclose(f);
+            return false;
+        }
+        step_count++;
+    }
+    fclose(f);
+    return true;
+}
+
+static void script_task(void *arg)
+{
+    (void)arg;
+
+    for (int i = 0; i < step_count; i++) {
+        const script_step_t *step = &steps[i];
+
+        vTaskDelay(pdMS_TO_TICKS(step->delay_ms));
+        if (step->kind == STEP_END) {
+            break;
+        }
+        if (step->kind == STEP_MARK) {
+            sim_stats_mark(step->section);
+            continue;
+        }
+        sim_stats_input(step->button);
+        atomic_store(&pressed[step->button], true);
+        vTaskDelay(pdMS_TO_TICKS(step->hold_ms));
+        atomic_store(&pressed[step->button], false);
+    }
+    script_done();
+    vTaskDelete(NULL);
+}
+
+void sim_script_start(void (*done)(void))
+{
+    script_done = done;
+    xTaskCreate(script_task, "sim_script", 4096, NULL, tskIDLE_PRIORITY + 2, NULL);
+}
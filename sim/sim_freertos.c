@@ -0,0 +1,446 @@
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+// pthread implementation of the FreeRTOS shim. Every object pairs a mutex
+// with a condition variable on CLOCK_MONOTONIC; timeouts are in ticks of
+// portTICK_PERIOD_MS like on the device.
+
+struct sim_task {
+    void (*fn)(void *);
+    void *arg;
+    UBaseType_t priority;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify;
+};
+
+struct sim_mutex {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool taken;
+};
+
+struct sim_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *items;
+};
+
+struct sim_event_group {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    EventBits_t bits;
+};
+
+esp_log_level_t sim_log_level = ESP_LOG_INFO;
+
+static struct timespec sim_start;
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread struct sim_task *current_task;
+static struct sim_task main_task = { .priority = 1 };
+
+// esp_timer counts from process start, like from reset on the device.
+__attribute__((constructor)) static void record_start(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &sim_start);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)(now.tv_sec - sim_start.tv_sec) * 1000000 +
+           (now.tv_nsec - sim_start.tv_nsec) / 1000;
+}
+
+void sim_log(esp_log_level_t level, const char *tag, const char *fmt, ...)
+{
+    static const char letters[] = "NEWIDV";
+    va_list args;
+
+    if (level > sim_log_level) {
+        return;
+    }
+    pthread_mutex_lock(&log_lock);
+    printf("%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+    pthread_mutex_unlock(&log_lock);
+}
+
+static void init_cond(pthread_mutex_t *lock, pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+
+    pthread_mutex_init(lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static struct timespec deadline_after(TickType_t ticks)
+{
+    struct timespec t;
+    uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    t.tv_sec += ns / 1000000000;
+    t.tv_nsec += ns % 1000000000;
+    if (t.tv_nsec >= 1000000000) {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000;
+    }
+    return t;
+}
+
+/**
+ * @brief Wait on cond with lock held until signalled or the deadline passes.
+ *
+ * @return false on timeout.
+ */
+static bool wait_until(pthread_cond_t *cond, pthread_mutex_t *lock, TickType_t timeout,
+                       const struct timespec *deadline)
+{
+    if (timeout == 0) {
+        return false;
+    }
+    if (timeout == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+// ------------------------------------------------------------------
+// Tasks
+// ------------------------------------------------------------------
+
+static struct sim_task *self(void)
+{
+    if (current_task == NULL) {
+        // The thread running main(), i.e. app_main() on the device.
+        init_cond(&main_task.lock, &main_task.cond);
+        current_task = &main_task;
+    }
+    return current_task;
+}
+
+static void *task_entry(void *arg)
+{
+    struct sim_task *task = arg;
+
+    current_task = task;
+    task->fn(task->arg);
+    // Returning from a task function is a bug on FreeRTOS.
+    fprintf(stderr, "sim: task function returned\n");
+    abort();
+}
+
+BaseType_t xTaskCreatePinnedToCore(void (*fn)(void *), const char *name, uint32_t stack,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core)
+{
+    (void)name;
+    (void)stack;
+    (void)core;
+    pthread_t thread;
+    struct sim_task *task = calloc(1, sizeof(*task));
+
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    task->priority = priority;
+    init_cond(&task->lock, &task->cond);
+    if (handle != NULL) {
+        *handle = task;
+    }
+    if (pthread_create(&thread, NULL, task_entry, task) != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(void (*fn)(void *), const char *name, uint32_t stack, void *arg,
+                       UBaseType_t priority, TaskHandle_t *handle)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, priority, handle, 0);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task != NULL && task != current_task) {
+        fprintf(stderr, "sim: vTaskDelete() of another task is not supported\n");
+        abort();
+    }
+    // The task struct is leaked: its handle may still be held by others.
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0) {
+        sched_yield();
+        return;
+    }
+    struct timespec deadline = deadline_after(ticks);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return self();
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    return (task != NULL ? task : self())->priority;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t timeout)
+{
+    struct sim_task *task = self();
+    struct timespec deadline = deadline_after(timeout);
+    uint32_t value;
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify == 0) {
+        if (!wait_until(&task->cond, &task->lock, timeout, &deadline)) {
+            break;
+        }
+    }
+    value = task->notify;
+    if (value > 0) {
+        task->notify = clear ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+// ------------------------------------------------------------------
+// Mutexes
+// ------------------------------------------------------------------
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    struct sim_mutex *sem = calloc(1, sizeof(*sem));
+
+    if (sem != NULL) {
+        init_cond(&sem->lock, &sem->cond);
+    }
+    return sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout)
+{
+    struct timespec deadline = deadline_after(timeout);
+    BaseType_t ret = pdPASS;
+
+    pthread_mutex_lock(&sem->lock);
+    while (sem->taken) {
+        if (!wait_until(&sem->cond, &sem->lock, timeout, &deadline)) {
+            ret = pdFAIL;
+            break;
+        }
+    }
+    if (ret == pdPASS) {
+        sem->taken = true;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return ret;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    sem->taken = false;
+    pthread_cond_broadcast(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+    return pdPASS;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    pthread_mutex_destroy(&sem->lock);
+    pthread_cond_destroy(&sem->cond);
+    free(sem);
+}
+
+// ------------------------------------------------------------------
+// Queues
+// ------------------------------------------------------------------
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct sim_queue *queue = calloc(1, sizeof(*queue));
+
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->items = calloc(length, item_size);
+    if (queue->items == NULL) {
+        free(queue);
+        return NULL;
+    }
+    queue->length = length;
+    queue->item_size = item_size;
+    init_cond(&queue->lock, &queue->cond);
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t timeout)
+{
+    struct timespec deadline = deadline_after(timeout);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length) {
+        if (!wait_until(&queue->cond, &queue->lock, timeout, &deadline)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFAIL;
+        }
+    }
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->items + (size_t)tail * queue->item_size, item, queue->item_size);
+    queue->count++;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t timeout)
+{
+    struct timespec deadline = deadline_after(timeout);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0) {
+        if (!wait_until(&queue->cond, &queue->lock, timeout, &deadline)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFAIL;
+        }
+    }
+    memcpy(item, queue->items + (size_t)queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->cond);
+    free(queue->items);
+    free(queue);
+}
+
+// ------------------------------------------------------------------
+// Event groups
+// ------------------------------------------------------------------
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    struct sim_event_group *group = calloc(1, sizeof(*group));
+
+    if (group != NULL) {
+        init_cond(&group->lock, &group->cond);
+    }
+    return group;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group)
+{
+    pthread_mutex_destroy(&group->lock);
+    pthread_cond_destroy(&group->cond);
+    free(group);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    group->bits |= bits;
+    EventBits_t value = group->bits;
+    pthread_cond_broadcast(&group->cond);
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear,
+                                BaseType_t wait_all, TickType_t timeout)
+{
+    struct timespec deadline = deadline_after(timeout);
+    EventBits_t value;
+
+    pthread_mutex_lock(&group->lock);
+    for (;;) {
+        value = group->bits;
+        bool met = wait_all ? (value & bits) == bits : (value & bits) != 0;
+        if (met) {
+            if (clear) {
+                group->bits &= ~bits;
+            }
+            break;
+        }
+        if (!wait_until(&group->cond, &group->lock, timeout, &deadline)) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
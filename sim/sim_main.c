@@ -0,0 +1,172 @@
+// Host simulator for the UI layer.
+//
+// Runs the real password, splash_screen, display_service and ui_fonts
+// code on Linux: FreeRTOS is backed by pthreads (sim_freertos.c), NVS by
+// a text file (sim_nvs.c), the buttons by a script (sim_buttons.c) and
+// the SSD1306 by a model of its I2C protocol (sim_panel.c). At the end of
+// the script it prints input-to-frame latency, frames and I2C bytes per
+// script section.
+//
+//   make
+//   ./build/ui_sim [-n nvs.txt] [-d frames/] [-H 32|64] [-b i2c_hz] [-l max_ms] [-v] script
+//
+// -H 64 simulates a 128x64 module instead of the 128x32 one main.c sets
+// up. With -l the exit status is 2 when an input took longer than max_ms
+// to reach the display, for use in CI.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "u8g2.h"
+#include "button_listener.h"
+#include "password.h"
+#include "wallet_state.h"
+#include "splash_screen.h"
+#include "display_service.h"
+#include "trace.h"
+#include "sim.h"
+
+static const char *TAG = "sim";
+
+u8g2_t u8g2;
+
+static long max_latency_ms = -1;
+
+// ------------------------------------------------------------------
+// Init tasks, as in src/main.c minus the ATECC and crypto ones
+// ------------------------------------------------------------------
+static void task_displaySetup(void) {}
+
+static void task_nvsInit(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+}
+
+static void task_walletStateLoad(void)
+{
+    esp_err_t ret = wallet_state_load();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "wallet state: %s", esp_err_to_name(ret));
+    }
+}
+
+static void task_initButtons(void)
+{
+    init_button_listener();
+}
+
+static const InitTask splashTasks[] = {
+    { "display",  task_displaySetup, 0 },
+    { "nvs",      task_nvsInit,      0 },
+    { "state",    task_walletStateLoad, INIT_DEP(1) },
+    { "buttons",  task_initButtons,  0 },
+};
+
+// ------------------------------------------------------------------
+// script_done:
+//   Called on the script task after the last step. Lets the display
+//   settle, prints the report and ends the process.
+// ------------------------------------------------------------------
+static void script_done(void)
+{
+    display_stats_t stats;
+
+    display_service_wait_idle(pdMS_TO_TICKS(1000));
+    display_service_get_stats(&stats);
+
+    fflush(stdout);
+    printf("\n");
+    int64_t worst_us = sim_stats_report(stdout);
+    printf("display service: %lu submitted, %lu flushed, %lu dropped, %lu unchanged, "
+           "%lu tiles, max flush %lu us\n",
+           (unsigned long)stats.frames_submitted, (unsigned long)stats.frames_flushed,
+           (unsigned long)stats.frames_dropped, (unsigned long)stats.frames_unchanged,
+           (unsigned long)stats.tiles_sent, (unsigned long)stats.max_flush_us);
+#if CONFIG_TRACE_ENABLE
+    trace_dump();
+#endif
+    fflush(stdout);
+
+    if (max_latency_ms >= 0 && worst_us > max_latency_ms * 1000) {
+        fprintf(stderr, "sim: worst input latency %.1f ms exceeds %ld ms\n",
+                worst_us / 1000.0, max_latency_ms);
+        _exit(2);
+    }
+    _exit(0);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-n nvs_file] [-d frame_dir] [-H 32|64] [-b i2c_hz] "
+            "[-l max_latency_ms] [-v] script\n", prog);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t i2c_hz = 400000;  // I2C_MASTER_FREQ_HZ in main.c
+    int height = 32;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:d:H:b:l:v")) != -1) {
+        switch (opt) {
+            case 'n':
+                sim_nvs_path = optarg;
+                break;
+            case 'd':
+                sim_panel_dump_frames(optarg);
+                break;
+            case 'H':
+                height = atoi(optarg);
+                if (height != 32 && height != 64) {
+                    usage(argv[0]);
+                }
+                break;
+            case 'b':
+                i2c_hz = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                max_latency_ms = strtol(optarg, NULL, 10);
+                break;
+            case 'v':
+                sim_log_level = ESP_LOG_DEBUG;
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1 || !sim_script_load(argv[optind])) {
+        usage(argv[0]);
+    }
+
+    // The script clock starts with the firmware: its first delay covers
+    // the boot.
+    sim_script_start(script_done);
+
+    // u8g2_display_init() from main.c
+    sim_panel_setup(&u8g2, height, i2c_hz);
+    u8g2_InitDisplay(&u8g2);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    u8g2_SetPowerSave(&u8g2, 0);
+    u8g2_ClearBuffer(&u8g2);
+    ESP_ERROR_CHECK(display_service_start(&u8g2));
+
+    show_splash_screen(&u8g2, splashTasks, sizeof(splashTasks) / sizeof(splashTasks[0]));
+
+    bool result = handle_password_flow(&u8g2);
+    ESP_LOGI(TAG, "password flow returned %s", result ? "true" : "false");
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
@@ -0,0 +1,276 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "sim.h"
+
+// NVS stand-in: a flat list of blobs, one "<namespace> <key> <hex>" line
+// per entry in the backing file. Handles are namespace index + 1 with the
+// read-write flag in bit 16.
+
+#define SIM_NVS_MAX_ENTRIES 64
+#define SIM_NVS_MAX_BLOB    1984  // largest blob the real NVS accepts on one page
+#define SIM_NVS_RW_FLAG     0x10000
+
+typedef struct {
+    char ns[NVS_KEY_NAME_MAX_SIZE];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    size_t length;
+    uint8_t *value;
+} nvs_entry_t;
+
+const char *sim_nvs_path;
+
+static pthread_mutex_t nvs_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool initialized;
+static nvs_entry_t entries[SIM_NVS_MAX_ENTRIES];
+static int entry_count;
+static char namespaces[SIM_NVS_MAX_ENTRIES][NVS_KEY_NAME_MAX_SIZE];
+static int namespace_count;
+
+static void clear_entries(void)
+{
+    for (int i = 0; i < entry_count; i++) {
+        free(entries[i].value);
+    }
+    memset(entries, 0, sizeof(entries));
+    entry_count = 0;
+}
+
+static nvs_entry_t *find_entry(const char *ns, const char *key)
+{
+    for (int i = 0; i < entry_count; i++) {
+        if (strcmp(entries[i].ns, ns) == 0 && strcmp(entries[i].key, key) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static bool namespace_exists(const char *ns)
+{
+    for (int i = 0; i < entry_count; i++) {
+        if (strcmp(entries[i].ns, ns) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static esp_err_t store(const char *ns, const char *key, const void *value, size_t length)
+{
+    nvs_entry_t *e = find_entry(ns, key);
+    uint8_t *copy = malloc(length ? length : 1);
+
+    if (copy == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (e == NULL) {
+        if (entry_count == SIM_NVS_MAX_ENTRIES) {
+            free(copy);
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        e = &entries[entry_count++];
+        strcpy(e->ns, ns);
+        strcpy(e->key, key);
+    }
+    memcpy(copy, value, length);
+    free(e->value);
+    e->value = copy;
+    e->length = length;
+    return ESP_OK;
+}
+
+static esp_err_t load_file(void)
+{
+    FILE *f = fopen(sim_nvs_path, "r");
+    char ns[NVS_KEY_NAME_MAX_SIZE], key[NVS_KEY_NAME_MAX_SIZE];
+    static char hex[SIM_NVS_MAX_BLOB * 2 + 1];
+    static uint8_t value[SIM_NVS_MAX_BLOB];
+
+    if (f == NULL) {
+        return ESP_OK;  // first run: an erased chip
+    }
+    while (fscanf(f, "%15s %15s %3968s", ns, key, hex) == 3) {
+        size_t length = strlen(hex) / 2;
+        for (size_t i = 0; i < length; i++) {
+            unsigned byte;
+            sscanf(hex + 2 * i, "%2x", &byte);
+            value[i] = (uint8_t)byte;
+        }
+        if (store(ns, key, value, length) != ESP_OK) {
+            fclose(f);
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+    }
+    fclose(f);
+    return ESP_OK;
+}
+
+static esp_err_t save_file(void)
+{
+    if (sim_nvs_path == NULL) {
+        return ESP_OK;
+    }
+    FILE *f = fopen(sim_nvs_path, "w");
+    if (f == NULL) {
+        return ESP_FAIL;
+    }
+    for (int i = 0; i < entry_count; i++) {
+        fprintf(f, "%s %s ", entries[i].ns, entries[i].key);
+        for (size_t j = 0; j < entries[i].length; j++) {
+            fprintf(f, "%02x", entries[i].value[j]);
+        }
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    esp_err_t err = ESP_OK;
+
+    pthread_mutex_lock(&nvs_lock);
+    if (!initialized) {
+        clear_entries();
+        if (sim_nvs_path != NULL) {
+            err = load_file();
+        }
+        initialized = err == ESP_OK;
+    }
+    pthread_mutex_unlock(&nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    pthread_mutex_lock(&nvs_lock);
+    clear_entries();
+    initialized = false;
+    esp_err_t err = save_file();
+    pthread_mutex_unlock(&nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode, nvs_handle_t *handle)
+{
+    esp_err_t err = ESP_OK;
+    int index;
+
+    if (strlen(name) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    pthread_mutex_lock(&nvs_lock);
+    if (!initialized) {
+        err = ESP_ERR_NVS_NOT_INITIALIZED;
+    } else if (mode == NVS_READONLY && !namespace_exists(name)) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else {
+        for (index = 0; index < namespace_count; index++) {
+            if (strcmp(namespaces[index], name) == 0) {
+                break;
+            }
+        }
+        if (index == namespace_count) {
+            if (namespace_count == SIM_NVS_MAX_ENTRIES) {
+                err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+            } else {
+                strcpy(namespaces[namespace_count++], name);
+            }
+        }
+        if (err == ESP_OK) {
+            *handle = (nvs_handle_t)(index + 1) | (mode == NVS_READWRITE ? SIM_NVS_RW_FLAG : 0);
+        }
+    }
+    pthread_mutex_unlock(&nvs_lock);
+    return err;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
+
+static const char *handle_namespace(nvs_handle_t handle)
+{
+    int index = (int)(handle & (SIM_NVS_RW_FLAG - 1)) - 1;
+    return index >= 0 && index < namespace_count ? namespaces[index] : NULL;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    esp_err_t err;
+
+    if (strlen(key) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    if (length > SIM_NVS_MAX_BLOB) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    pthread_mutex_lock(&nvs_lock);
+    const char *ns = handle_namespace(handle);
+    if (ns == NULL) {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+    } else if (!(handle & SIM_NVS_RW_FLAG)) {
+        err = ESP_ERR_NVS_READ_ONLY;
+    } else {
+        err = store(ns, key, value, length);
+    }
+    pthread_mutex_unlock(&nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    esp_err_t err = ESP_OK;
+
+    pthread_mutex_lock(&nvs_lock);
+    const char *ns = handle_namespace(handle);
+    nvs_entry_t *e = ns != NULL ? find_entry(ns, key) : NULL;
+    if (ns == NULL) {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+    } else if (e == NULL) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else if (out_value == NULL) {
+        *length = e->length;
+    } else if (*length < e->length) {
+        *length = e->length;
+        err = ESP_ERR_NVS_INVALID_LENGTH;
+    } else {
+        memcpy(out_value, e->value, e->length);
+        *length = e->length;
+    }
+    pthread_mutex_unlock(&nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    esp_err_t err = ESP_ERR_NVS_NOT_FOUND;
+
+    pthread_mutex_lock(&nvs_lock);
+    const char *ns = handle_namespace(handle);
+    nvs_entry_t *e = ns != NULL ? find_entry(ns, key) : NULL;
+    if (ns == NULL) {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+    } else if (!(handle & SIM_NVS_RW_FLAG)) {
+        err = ESP_ERR_NVS_READ_ONLY;
+    } else if (e != NULL) {
+        free(e->value);
+        *e = entries[--entry_count];
+        memset(&entries[entry_count], 0, sizeof(entries[entry_count]));
+        err = ESP_OK;
+    }
+    pthread_mutex_unlock(&nvs_lock);
+    return err;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&nvs_lock);
+    esp_err_t err = handle_namespace(handle) != NULL ? save_file() : ESP_ERR_NVS_INVALID_HANDLE;
+    pthread_mutex_unlock(&nvs_lock);
+    return err;
+}
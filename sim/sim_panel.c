@@ -0,0 +1,208 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+// Model of the SSD1306 behind the firmware's I2C byte callback. Transfers
+// are decoded like the controller does: a control byte (0x00 commands,
+// 0x40 data) followed by commands with their arguments or GDDRAM bytes.
+// The transfer time at the bus clock is slept on the calling task, so the
+// flush task sees the same back-pressure as on the device.
+
+#define PANEL_WIDTH  128
+#define PANEL_PAGES  8   // controller RAM; a 128x32 module shows pages 0-3
+#define SIM_I2C_ADDR_BITS 9   // address byte + ACK
+#define SIM_I2C_FRAME_BITS 2  // start and stop condition
+
+static uint8_t ram[PANEL_PAGES][PANEL_WIDTH];
+static uint8_t column;
+static uint8_t page;
+static uint8_t shown_pages;
+static uint32_t bus_hz;
+static int64_t bus_free_at;
+static const char *dump_dir;
+static unsigned dump_count;
+
+static uint8_t xfer[256];
+static uint16_t xfer_len;
+
+// Argument count of the multi-byte SSD1306 commands.
+static uint8_t command_args(uint8_t cmd)
+{
+    switch (cmd) {
+        case 0x20: case 0x81: case 0x8d: case 0xa8: case 0xd3:
+        case 0xd5: case 0xd9: case 0xda: case 0xdb:
+            return 1;
+        case 0x21: case 0x22: case 0xa3:
+            return 2;
+        case 0x29: case 0x2a:
+            return 5;
+        case 0x26: case 0x27:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+static void decode_transfer(const uint8_t *buf, uint16_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    if (buf[0] & 0x40) {
+        for (uint16_t i = 1; i < len; i++) {
+            ram[page][column] = buf[i];
+            if (++column == PANEL_WIDTH) {  // horizontal addressing mode
+                column = 0;
+                page = (page + 1) % PANEL_PAGES;
+            }
+        }
+        return;
+    }
+    for (uint16_t i = 1; i < len; i++) {
+        uint8_t cmd = buf[i];
+        if (cmd < 0x10) {
+            column = (column & 0xf0) | cmd;
+        } else if (cmd < 0x20) {
+            column = (uint8_t)(((cmd & 0x0f) << 4) | (column & 0x0f)) % PANEL_WIDTH;
+        } else if (cmd >= 0xb0 && cmd <= 0xb7) {
+            page = cmd & 0x07;
+        } else {
+            i += command_args(cmd);
+        }
+    }
+}
+
+static void pace_bus(uint16_t len)
+{
+    if (bus_hz == 0) {
+        return;
+    }
+    uint32_t bits = SIM_I2C_FRAME_BITS + SIM_I2C_ADDR_BITS + len * 9u;
+    int64_t duration = (int64_t)bits * 1000000 / bus_hz;
+    int64_t now = esp_timer_get_time();
+
+    // Schedule against the bus clock rather than sleeping each transfer,
+    // so oversleeping one transfer is made up on the next.
+    bus_free_at = (bus_free_at > now ? bus_free_at : now) + duration;
+    sim_stats_i2c(len + 1, (uint32_t)duration);
+    while (esp_timer_get_time() < bus_free_at) {
+        int64_t left = bus_free_at - esp_timer_get_time();
+        struct timespec ts = { .tv_sec = 0, .tv_nsec = (long)(left > 0 ? left : 0) * 1000 };
+        nanosleep(&ts, NULL);
+    }
+}
+
+static void dump_frame(void)
+{
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/frame_%04u.pbm", dump_dir, ++dump_count);
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        fprintf(stderr, "sim: cannot write %s: %s\n", path, strerror(errno));
+        return;
+    }
+    fprintf(f, "P4\n%d %d\n", PANEL_WIDTH, shown_pages * 8);
+    for (int y = 0; y < shown_pages * 8; y++) {
+        for (int x = 0; x < PANEL_WIDTH; x += 8) {
+            uint8_t row = 0;
+            for (int b = 0; b < 8; b++) {
+                if (ram[y / 8][x + b] & (1 << (y % 8))) {
+                    row |= 0x80 >> b;
+                }
+            }
+            fputc(row, f);
+        }
+    }
+    fclose(f);
+}
+
+static uint8_t sim_byte_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    (void)u8x8;
+
+    switch (msg) {
+        case U8X8_MSG_BYTE_SEND:
+            if (xfer_len + arg_int <= sizeof(xfer)) {
+                memcpy(xfer + xfer_len, arg_ptr, arg_int);
+                xfer_len += arg_int;
+            }
+            break;
+        case U8X8_MSG_BYTE_INIT:
+        case U8X8_MSG_BYTE_SET_DC:
+            break;
+        case U8X8_MSG_BYTE_START_TRANSFER:
+            xfer_len = 0;
+            break;
+        case U8X8_MSG_BYTE_END_TRANSFER:
+            pace_bus(xfer_len);
+            decode_transfer(xfer, xfer_len);
+            break;
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+// Same delays as u8x8_gpio_and_delay_esp32() in main.c.
+static uint8_t sim_gpio_and_delay_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    (void)u8x8;
+    (void)arg_ptr;
+
+    switch (msg) {
+        case U8X8_MSG_GPIO_AND_DELAY_INIT:
+            break;
+        case U8X8_MSG_DELAY_MILLI:
+            vTaskDelay(pdMS_TO_TICKS(arg_int));
+            break;
+        case U8X8_MSG_DELAY_10MICRO:
+        case U8X8_MSG_DELAY_100NANO:
+            vTaskDelay(0);
+            break;
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+// The display callback chosen by the u8g2 setup function; refresh marks
+// the end of a frame.
+static u8x8_msg_cb display_cb;
+
+static uint8_t sim_display_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    uint8_t ret = display_cb(u8x8, msg, arg_int, arg_ptr);
+
+    if (msg == U8X8_MSG_DISPLAY_REFRESH) {
+        sim_stats_frame();
+        if (dump_dir != NULL) {
+            dump_frame();
+        }
+    }
+    return ret;
+}
+
+void sim_panel_setup(u8g2_t *u8g2, int height, uint32_t i2c_hz)
+{
+    bus_hz = i2c_hz;
+    shown_pages = height / 8;
+    if (height == 64) {
+        u8g2_Setup_ssd1306_i2c_128x64_noname_f(u8g2, U8G2_R0, sim_byte_cb, sim_gpio_and_delay_cb);
+    } else {
+        u8g2_Setup_ssd1306_i2c_128x32_univision_f(u8g2, U8G2_R0, sim_byte_cb,
+                                                  sim_gpio_and_delay_cb);
+    }
+    display_cb = u8g2_GetU8x8(u8g2)->display_cb;
+    u8g2_GetU8x8(u8g2)->display_cb = sim_display_cb;
+}
+
+void sim_panel_dump_frames(const char *dir)
+{
+    dump_dir = dir;
+}
@@ -0,0 +1,118 @@
+#include <pthread.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "sim.h"
+
+// Per-section counters. A press is answered by the first frame whose
+// refresh completes after it; its latency is press to that refresh, so it
+// includes the firmware's debounce delays, drawing and the I2C transfer.
+// A press still unanswered when the next one comes changed nothing on the
+// panel and is counted as such instead.
+
+#define SIM_MAX_SECTIONS 32
+
+typedef struct {
+    char name[32];
+    int64_t start_us;
+    uint32_t frames;
+    uint32_t i2c_bytes;
+    uint64_t i2c_bus_us;
+    uint32_t inputs;
+    uint32_t answered;
+    uint32_t no_frame;
+    int64_t latency_sum_us;
+    int64_t latency_max_us;
+} section_t;
+
+typedef struct {
+    int64_t at_us;
+    int section;
+} pending_input_t;
+
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static section_t sections[SIM_MAX_SECTIONS] = { { .name = "boot" } };
+static int section_count = 1;
+static pending_input_t pending_input;
+static bool pending;
+
+void sim_stats_mark(const char *name)
+{
+    pthread_mutex_lock(&stats_lock);
+    if (section_count < SIM_MAX_SECTIONS) {
+        section_t *s = &sections[section_count++];
+        snprintf(s->name, sizeof(s->name), "%s", name);
+        s->start_us = esp_timer_get_time();
+    }
+    pthread_mutex_unlock(&stats_lock);
+}
+
+void sim_stats_input(sim_button_t button)
+{
+    (void)button;
+
+    pthread_mutex_lock(&stats_lock);
+    if (pending) {
+        sections[pending_input.section].no_frame++;
+    }
+    sections[section_count - 1].inputs++;
+    pending_input.at_us = esp_timer_get_time();
+    pending_input.section = section_count - 1;
+    pending = true;
+    pthread_mutex_unlock(&stats_lock);
+}
+
+void sim_stats_i2c(uint32_t bytes, uint32_t bus_us)
+{
+    pthread_mutex_lock(&stats_lock);
+    sections[section_count - 1].i2c_bytes += bytes;
+    sections[section_count - 1].i2c_bus_us += bus_us;
+    pthread_mutex_unlock(&stats_lock);
+}
+
+void sim_stats_frame(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    pthread_mutex_lock(&stats_lock);
+    sections[section_count - 1].frames++;
+    if (pending) {
+        section_t *s = &sections[pending_input.section];
+        int64_t latency = now - pending_input.at_us;
+        s->answered++;
+        s->latency_sum_us += latency;
+        if (latency > s->latency_max_us) {
+            s->latency_max_us = latency;
+        }
+        pending = false;
+    }
+    pthread_mutex_unlock(&stats_lock);
+}
+
+int64_t sim_stats_report(FILE *out)
+{
+    int64_t worst = 0;
+
+    pthread_mutex_lock(&stats_lock);
+    if (pending) {
+        sections[pending_input.section].no_frame++;
+        pending = false;
+    }
+    fprintf(out, "%-12s %8s %7s %9s %9s %7s %9s %9s %9s\n", "section", "start ms", "frames",
+            "i2c bytes", "i2c ms", "inputs", "no frame", "avg ms", "max ms");
+    for (int i = 0; i < section_count; i++) {
+        const section_t *s = &sections[i];
+        fprintf(out, "%-12s %8.1f %7u %9u %9.1f %7u %9u", s->name, s->start_us / 1000.0,
+                (unsigned)s->frames, (unsigned)s->i2c_bytes, s->i2c_bus_us / 1000.0,
+                (unsigned)s->inputs, (unsigned)s->no_frame);
+        if (s->answered > 0) {
+            fprintf(out, " %9.1f %9.1f", s->latency_sum_us / 1000.0 / s->answered,
+                    s->latency_max_us / 1000.0);
+        }
+        fprintf(out, "\n");
+        if (s->latency_max_us > worst) {
+            worst = s->latency_max_us;
+        }
+    }
+    pthread_mutex_unlock(&stats_lock);
+    return worst;
+}
@@ -8,12 +8,21 @@
 #include "u8g2.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 
 #include "nvs_flash.h"
 #include "button_listener.h"
 #include "password.h"
+#include "wallet_state.h"
+#include "power_manager.h"
+#include "trace.h"
 #include "splash_screen.h"
+#include "display_service.h"
+#include "crypto_worker.h"
 #include "driver/i2c.h"
+#include "cryptoauthlib.h"
+#include "hal_esp32_i2c_master.h"
+#include "rand.h"
 
 #define I2C_MASTER_SCL_IO           GPIO_NUM_22      // GPIO number for I2C master clock
 #define I2C_MASTER_SDA_IO           GPIO_NUM_21      // GPIO number for I2C master data
@@ -35,13 +44,22 @@ u8g2_t u8g2; // a structure which will contain all the data for one display
 // ------------------------------------------------------------------
 static void task_displaySetup(void);
 static void task_nvsInit(void);
+static void task_walletStateLoad(void);
 static void task_initButtons(void);
+static void task_ateccInit(void);
+static void task_entropyInit(void);
+static void task_cryptoWorker(void);
 
-// Array of initialization tasks passed into show_splash_screen()
-static InitTask splashTasks[] = {
-    task_displaySetup,
-    task_nvsInit,
-    task_initButtons
+// Initialization tasks passed into show_splash_screen(). Tasks without
+// dependencies start together; list prerequisites with INIT_DEP(index).
+static const InitTask splashTasks[] = {
+    { "display",  task_displaySetup, 0 },
+    { "nvs",      task_nvsInit,      0 },
+    { "state",    task_walletStateLoad, INIT_DEP(1) },
+    { "buttons",  task_initButtons,  0 },
+    { "atecc",    task_ateccInit,    0 },
+    { "entropy",  task_entropyInit,  INIT_DEP(4) },
+    { "crypto",   task_cryptoWorker, 0 },
 };
 
 // ------------------------------------------------------------------
@@ -68,6 +86,19 @@ static void task_nvsInit(void)
     ESP_LOGI(TAG, "RUN TASK NVS END");
 }
 
+// ------------------------------------------------------------------
+// task_walletStateLoad:
+//   Reads the wallet state (PIN, counters) from NVS into RAM so the
+//   PIN flow never touches flash to check the PIN.
+// ------------------------------------------------------------------
+static void task_walletStateLoad(void)
+{
+    esp_err_t ret = wallet_state_load();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "wallet state: %s", esp_err_to_name(ret));
+    }
+}
+
 // ------------------------------------------------------------------
 // task_initButtons:
 //   Calls initButtons() from the ButtonListener component to
@@ -79,13 +110,80 @@ static void task_initButtons(void)
      ESP_LOGI(TAG, "RUN BUTTON INIT");
 }
 
+static bool atecc_ready;
+
+// ------------------------------------------------------------------
+// task_ateccInit:
+//   Brings up the ATECC608 on the display's I2C bus. On failure the
+//   wallet runs without it: no extra entropy, nothing to put to sleep.
+// ------------------------------------------------------------------
+static void task_ateccInit(void)
+{
+    hal_esp32_i2c_set_bus(i2c_bus);
+    ATCA_STATUS status = atcab_init(&cfg_ateccx08a_i2c_default);
+    if (status != ATCA_SUCCESS) {
+        ESP_LOGE(TAG, "ATECC init failed: 0x%02x", status);
+        atcab_release();
+        return;
+    }
+    atecc_ready = true;
+}
+
+// ------------------------------------------------------------------
+// atecc_entropy_source:
+//   Entropy source for the rand.c pool. Pulls len bytes from the ATECC
+//   RNG, 32 bytes per command. Registered by task_entropyInit() once
+//   task_ateccInit() brought the secure element up.
+// ------------------------------------------------------------------
+static int atecc_entropy_source(uint8_t *buf, size_t len)
+{
+    uint8_t block[RANDOM_NUM_SIZE];
+
+    while (len > 0) {
+        size_t n = len < sizeof(block) ? len : sizeof(block);
+        if (atcab_random(block) != ATCA_SUCCESS) {
+            memset(block, 0, sizeof(block));
+            return -1;
+        }
+        memcpy(buf, block, n);
+        buf += n;
+        len -= n;
+    }
+    memset(block, 0, sizeof(block));
+    return 0;
+}
+
+// ------------------------------------------------------------------
+// task_entropyInit:
+//   Registers the ATECC as extra entropy source if it came up and
+//   seeds the rand.c pool so the first random_buffer() call does not
+//   pay for it.
+// ------------------------------------------------------------------
+static void task_entropyInit(void)
+{
+    if (atecc_ready) {
+        random_set_entropy_source(atecc_entropy_source);
+    }
+    random_pool_service();
+}
+
+// ------------------------------------------------------------------
+// task_cryptoWorker:
+//   Starts the crypto worker on APP_CPU so seed derivation and signing
+//   never block the UI task.
+// ------------------------------------------------------------------
+static void task_cryptoWorker(void)
+{
+    ESP_ERROR_CHECK(crypto_worker_start());
+}
+
 // ------------------------------------------------------------------
 // app_main:
 //   1. Log application start.
 //   2. Initialize I2C bus and SSD1306 driver.
 //   3. Show splash screen and run initialization tasks.
 //   4. Start the PIN input flow.
-//   5. Enter an infinite loop (or perform other logic).
+//   5. Enter an infinite loop that sleeps when idle (power_manager).
 // ------------------------------------------------------------------
 
 esp_err_t i2c_master_init(void)
@@ -175,31 +273,69 @@ uint8_t u8x8_byte_esp32_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
    }
    
 
-void u8g2_display_init(u8g2_t *pu8g2) {
+void u8g2_display_init(u8g2_t *pu8g2, bool resumed) {
     u8g2_Setup_ssd1306_i2c_128x32_univision_f(pu8g2, U8G2_R0, u8x8_byte_esp32_i2c, u8x8_gpio_and_delay_esp32);
-    u8g2_InitDisplay(pu8g2);
-    vTaskDelay(pdMS_TO_TICKS(100));  // Add a 100ms delay
-    u8g2_SetPowerSave(pu8g2, 0);  // Wake up display
+    if (!resumed) {
+        u8g2_InitDisplay(pu8g2);
+        vTaskDelay(pdMS_TO_TICKS(100));  // Add a 100ms delay
+        u8g2_SetPowerSave(pu8g2, 0);  // Wake up display
+    }
+    // On a resume from deep sleep the SSD1306 kept its configuration and
+    // stays in power save until the first frame is on it.
     u8g2_ClearBuffer(pu8g2);      // Clear the internal buffer
+
+    // From here on frames go through the flush task instead of blocking
+    // the caller for the whole I2C transfer.
+    ESP_ERROR_CHECK(display_service_start(pu8g2));
 }
 
 
 void app_main(void)
 {
+    bool resumed = power_manager_resumed();
     ESP_ERROR_CHECK(i2c_master_init());
 
-    u8g2_display_init(&u8g2);
+    u8g2_display_init(&u8g2, resumed);
     ESP_LOGI(TAG, "=== RUN TASK START ===");
-    show_splash_screen(&u8g2, splashTasks, sizeof(splashTasks)/sizeof(splashTasks[0]));
+    // A resume skips the splash screen: the init tasks run without drawing
+    // and the PIN screen is the first thing the display shows.
+    show_splash_screen(resumed ? NULL : &u8g2, splashTasks, sizeof(splashTasks)/sizeof(splashTasks[0]));
+    ESP_ERROR_CHECK(power_manager_init(&u8g2));
+
+    if (resumed) {
+        int pinCode[4] = {0};
+        update_password(0, 0, pinCode);
+        power_manager_display_on();
+        ESP_LOGI(TAG, "PIN screen on %lld us after wake", (long long)esp_timer_get_time());
+    }
 
     bool result = handle_password_flow(&u8g2);
     if (result) {
         ESP_LOGI(TAG, "Password flow completed successfully");
     } else {
-        ESP_LOGW(TAG, "Password flow returned false (unexpected)");
+        ESP_LOGE(TAG, "Password flow returned false, wallet state locked");
     }
+#if CONFIG_TRACE_ENABLE
+    // Boot and PIN entry; later events are dumped by holding left + right.
+    trace_dump();
+#endif
 
     while (1) {
+        // Reseed the entropy pool off the signing path.
+        random_pool_service();
+
+        display_stats_t stats;
+        display_service_get_stats(&stats);
+        ESP_LOGD(TAG, "display: %lu flushed, %lu dropped, %lu unchanged, last %lu us, max %lu us",
+                 (unsigned long)stats.frames_flushed, (unsigned long)stats.frames_dropped,
+                 (unsigned long)stats.frames_unchanged, (unsigned long)stats.last_flush_us,
+                 (unsigned long)stats.max_flush_us);
+#if CONFIG_TRACE_ENABLE
+        if (is_button_left_pressed() && is_button_right_pressed()) {
+            trace_dump();
+        }
+#endif
+        power_manager_idle();
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
\ No newline at end of file